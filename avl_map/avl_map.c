@@ -0,0 +1,355 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "avl_map.h"
+
+/**
+ * rotate a subtree whose balance reached -2 or +2 back into balance. Only
+ * the nodes that move are read, never the other subtrees.
+ *
+ * @param MapNode ** link, the link to the root of the subtree.
+ *
+ * @returns true if the subtree got one level shorter, false if it kept
+ * its height
+ */
+private bool rotate(MapNode ** link){
+	MapNode * x = *link;
+	MapNode * y;
+	MapNode * z;
+
+	if(x->balance < 0){
+		z = x->left;
+		if(z->balance <= 0){
+			x->left = z->right;
+			z->right = x;
+			*link = z;
+			if(z->balance == 0){
+				x->balance = -1;
+				z->balance = 1;
+				return false;
+			}
+			x->balance = 0;
+			z->balance = 0;
+			return true;
+		}
+		y = z->right;
+		z->right = y->left;
+		x->left = y->right;
+		y->left = z;
+		y->right = x;
+		x->balance = (y->balance < 0)? 1 : 0;
+		z->balance = (y->balance > 0)? -1 : 0;
+	}
+	else{
+		z = x->right;
+		if(z->balance >= 0){
+			x->right = z->left;
+			z->left = x;
+			*link = z;
+			if(z->balance == 0){
+				x->balance = 1;
+				z->balance = -1;
+				return false;
+			}
+			x->balance = 0;
+			z->balance = 0;
+			return true;
+		}
+		y = z->left;
+		z->left = y->right;
+		x->right = y->left;
+		y->right = z;
+		y->left = x;
+		x->balance = (y->balance > 0)? -1 : 0;
+		z->balance = (y->balance < 0)? 1 : 0;
+	}
+	y->balance = 0;
+	*link = y;
+	return true;
+}
+
+/**
+ * link of the parent to the i-th node of a recorded path.
+ *
+ * @param MapNode ** tree, the root of the map.
+ * @param MapNode * nodes[], the nodes passed from the root.
+ * @param bool right[], the side taken below each node.
+ * @param int i, index of the node in the path.
+ *
+ * @returns the link to nodes[i]
+ */
+private MapNode ** linkTo(MapNode ** tree, MapNode * nodes[], bool right[], int i){
+	if(i == 0){
+		return tree;
+	}
+	return right[i - 1]? &nodes[i - 1]->right : &nodes[i - 1]->left;
+}
+
+/**
+ * find the node of a key, adding it with a payload when it is absent, in
+ * a single descent. The descent only records the nodes it passes and picks
+ * each child with a select rather than a branch, so a hit costs no more
+ * than search. Nodes keep a balance factor instead of a height, so the way
+ * back up after adding reads the recorded nodes only.
+ *
+ * @param MapNode ** tree, the root of the map.
+ * @param keytype key, the key.
+ * @param payloadtype payload, payload of the node if it is added.
+ * @param bool * inserted, set to true if the node was added, may be NULL.
+ *
+ * @returns the node of the key, NULL if out of memory
+ */
+private MapNode * insertOrGet(MapNode ** tree, keytype key, payloadtype payload, bool * inserted){
+	MapNode * nodes[AVLMAP_MAX_HEIGHT];
+	bool right[AVLMAP_MAX_HEIGHT];
+	MapNode * node = *tree;
+	MapNode * parent;
+	int top = 0;
+
+	if(inserted != NULL){
+		*inserted = false;
+	}
+	while(node != NULL){
+		if(key == node->key){
+			return node;
+		}
+		nodes[top] = node;
+		right[top++] = (key > node->key);
+		node = (key < node->key)? node->left : node->right;
+	}
+	node = (MapNode*) malloc(sizeof(MapNode));
+	if(node == NULL){
+		return NULL;
+	}
+	node->key = key;
+	node->balance = 0;
+	node->left = NULL;
+	node->right = NULL;
+	node->payload = payload;
+	*linkTo(tree, nodes, right, top) = node;
+
+	while(top > 0){
+		parent = nodes[--top];
+		parent->balance += right[top]? 1 : -1;
+		if(parent->balance == 0){
+			break;
+		}
+		if(parent->balance == 2 || parent->balance == -2){
+			rotate(linkTo(tree, nodes, right, top));
+			break;
+		}
+	}
+	if(inserted != NULL){
+		*inserted = true;
+	}
+	return node;
+}
+
+/**
+ * set the payload of a key, adding the key if it is absent, in a single
+ * descent.
+ *
+ * @param MapNode ** tree, the root of the map.
+ * @param keytype key, the key.
+ * @param payloadtype payload, the new payload.
+ * @param payloadtype * old, receives the replaced payload if the key was there, may be NULL.
+ * @param bool * inserted, set to true if the node was added, may be NULL.
+ *
+ * @returns the node of the key, NULL if out of memory, the map is then
+ * left as it was
+ */
+private MapNode * upsert(MapNode ** tree, keytype key, payloadtype payload, payloadtype * old, bool * inserted){
+	bool added;
+	MapNode * node = insertOrGet(tree, key, payload, &added);
+	if(inserted != NULL){
+		*inserted = added;
+	}
+	if(node == NULL || added){
+		return node;
+	}
+	if(old != NULL){
+		*old = node->payload;
+	}
+	node->payload = payload;
+	return node;
+}
+
+/**
+ * Search a key in the map.
+ *
+ * @param MapNode * tree, the root of the map.
+ * @param keytype key, the key.
+ *
+ * @returns the node of the key, NULL if absent
+ */
+private MapNode * search(MapNode * tree, keytype key){
+	while(tree != NULL && key != tree->key){
+		tree = (key < tree->key)? tree->left : tree->right;
+	}
+	return tree;
+}
+
+/**
+ * remove a key from the map. A node with two children is replaced by its
+ * successor node rather than by a copy of its key, so the nodes of other
+ * keys never move.
+ *
+ * @param MapNode ** tree, the root of the map.
+ * @param keytype key, the key.
+ * @param payloadtype * payload, receives the payload of the key, may be NULL.
+ *
+ * @returns true if the key was removed, false if absent
+ */
+private bool removeKey(MapNode ** tree, keytype key, payloadtype * payload){
+	MapNode * nodes[AVLMAP_MAX_HEIGHT];
+	bool right[AVLMAP_MAX_HEIGHT];
+	MapNode * found = *tree;
+	MapNode * next;
+	MapNode * parent;
+	int top = 0, at;
+
+	while(found != NULL && key != found->key){
+		nodes[top] = found;
+		right[top++] = (key > found->key);
+		found = (key < found->key)? found->left : found->right;
+	}
+	if(found == NULL){
+		return false;
+	}
+	if(payload != NULL){
+		*payload = found->payload;
+	}
+	if(found->left == NULL || found->right == NULL){
+		*linkTo(tree, nodes, right, top) = (found->left != NULL)? found->left : found->right;
+	}
+	else{
+		at = top;
+		nodes[top] = found;
+		right[top++] = true;
+		next = found->right;
+		while(next->left != NULL){
+			nodes[top] = next;
+			right[top++] = false;
+			next = next->left;
+		}
+		*linkTo(tree, nodes, right, top) = next->right;
+		next->left = found->left;
+		next->right = found->right;
+		next->balance = found->balance;
+		*linkTo(tree, nodes, right, at) = next;
+		nodes[at] = next;
+	}
+	free(found);
+
+	while(top > 0){
+		parent = nodes[--top];
+		parent->balance += right[top]? -1 : 1;
+		if(parent->balance == 1 || parent->balance == -1){
+			break;
+		}
+		if(parent->balance != 0 && !rotate(linkTo(tree, nodes, right, top))){
+			break;
+		}
+	}
+	return true;
+}
+
+/**
+ * get height of the map, following the taller side of every node.
+ *
+ * @param MapNode * tree, the root of the map.
+ *
+ * @returns the height, 0 if empty
+ */
+private int height(MapNode * tree){
+	int result = 0;
+	while(tree != NULL){
+		result++;
+		tree = (tree->balance < 0)? tree->left : tree->right;
+	}
+	return result;
+}
+
+/**
+ * Visit every node of the map in ascending key order, with a bounded
+ * stack instead of recursion.
+ *
+ * @param MapNode * tree, the root of the map.
+ * @param MapVisitor visit, called once per node.
+ * @param void * context, passed to visit.
+ */
+private void walk(MapNode * tree, MapVisitor visit, void * context){
+	MapNode * stack[AVLMAP_MAX_HEIGHT];
+	MapNode * node;
+	int top = 0;
+
+	while(tree != NULL || top > 0){
+		while(tree != NULL){
+			stack[top++] = tree;
+			tree = tree->left;
+		}
+		node = stack[--top];
+		tree = node->right;
+		visit(node, context);
+	}
+}
+
+/**
+ * Delete and free every node of the map, payloads are left alone.
+ * Rotates every left child up until the root has none, then frees the
+ * root, so no stack is needed.
+ *
+ * @param MapNode * tree, the root of the map.
+ */
+private void delete_map(MapNode * tree){
+	MapNode * aux;
+	while(tree != NULL){
+		if(tree->left != NULL){
+			aux = tree->left;
+			tree->left = aux->right;
+			aux->right = tree;
+			tree = aux;
+		}
+		else{
+			aux = tree->right;
+			free(tree);
+			tree = aux;
+		}
+	}
+}
+
+/**
+ * method constructor
+ *
+ * @returns a new AvlMap type and all functions
+ */
+public AvlMap avlmap(){
+	AvlMap new_map;
+	new_map.insertOrGet = &insertOrGet;
+	new_map.upsert = &upsert;
+	new_map.search = &search;
+	new_map.remove = &removeKey;
+	new_map.height = &height;
+	new_map.walk = &walk;
+	new_map.delete = &delete_map;
+	new_map.root = NULL;
+	return new_map;
+}
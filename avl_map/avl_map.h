@@ -0,0 +1,77 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+/**
+ * AVL MAP STRUCTURES, TYPES.
+ *
+ * An avl tree of keys, each carrying a payload. Writes are done in one
+ * descent: insertOrGet hands back the node of a key whether it was there
+ * or not, so a caller never has to search before inserting. Nodes do not
+ * move while they are in the map, a node returned stays valid until its
+ * own key is removed.
+ *
+ */
+#ifndef AVL_MAP_H
+#define AVL_MAP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#define keytype int
+#define payloadtype void *
+#define public
+#define private static
+
+/**
+ * Bound on the height of any avl tree addressable in 64 bits, sizes the
+ * path stacks used instead of recursion.
+ */
+#define AVLMAP_MAX_HEIGHT 96
+
+typedef struct mapnode {
+   keytype key;
+   int balance;   /* height of the right subtree minus height of the left */
+   struct mapnode * left;
+   struct mapnode * right;
+   payloadtype payload;
+}MapNode;
+
+/**
+ * Callback of walk, called once per node with the context given to walk.
+ */
+typedef void (*MapVisitor)(MapNode * node, void * context);
+
+typedef struct avlmap {
+   MapNode * (*insertOrGet)(MapNode ** tree, keytype key, payloadtype payload, bool * inserted);
+   MapNode * (*upsert)(MapNode ** tree, keytype key, payloadtype payload, payloadtype * old, bool * inserted);
+   MapNode * (*search)(MapNode * tree, keytype key);
+   bool (*remove)(MapNode ** tree, keytype key, payloadtype * payload);
+   int (*height)(MapNode * tree);
+   void (*walk)(MapNode * tree, MapVisitor visit, void * context);
+   void (*delete)(MapNode * tree);
+   MapNode * root;
+}AvlMap;
+
+/**
+ * method constructor
+ *
+ * @returns a new AvlMap type and all functions
+ */
+public AvlMap avlmap();
+
+#endif
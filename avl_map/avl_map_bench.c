@@ -0,0 +1,121 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "avl_map.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * monotonic clock in nanoseconds
+ *
+ * @returns the current time in nanoseconds
+ */
+private double now_ns(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * fill keys with random values in [0, range)
+ *
+ * @param keytype * keys, the buffer to fill.
+ * @param size_t n, number of keys.
+ * @param size_t range, bound of the keys.
+ * @param unsigned long seed, seed of the xorshift generator.
+ */
+private void random_keys(keytype * keys, size_t n, size_t range, unsigned long seed){
+	size_t i;
+	for(i = 0; i < n; i++){
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		keys[i] = (keytype) ((seed >> 32) % range);
+	}
+}
+
+/**
+ * write a payload for random keys, half of them already in the map,
+ * either as a search followed by an insert when the key is missing or
+ * with one upsert per key. Each way runs in its own process, so both
+ * start from the same heap.
+ *
+ * @param bool single, true for upsert, false for search then insert.
+ * @param size_t n, number of keys loaded before the writes.
+ */
+private void bench_write(bool single, size_t n){
+	size_t writes = 2 * n, i;
+	keytype * keys = malloc(writes * sizeof(keytype));
+	AvlMap map = avlmap();
+	MapNode * node;
+	double t0, t1;
+
+	random_keys(keys, n, 2 * n, 88172645463325252UL);
+	for(i = 0; i < n; i++){
+		map.upsert(&map.root, keys[i], NULL, NULL, NULL);
+	}
+	random_keys(keys, writes, 2 * n, 2463534242UL);
+
+	t0 = now_ns();
+	if(single){
+		for(i = 0; i < writes; i++){
+			map.upsert(&map.root, keys[i], keys + i, NULL, NULL);
+		}
+	}
+	else{
+		for(i = 0; i < writes; i++){
+			node = map.search(map.root, keys[i]);
+			if(node != NULL){
+				node->payload = keys + i;
+			}
+			else{
+				map.insertOrGet(&map.root, keys[i], keys + i, NULL);
+			}
+		}
+	}
+	t1 = now_ns();
+	printf("%zu keys: %s %.1f ns/write\n", n, single ? "upsert" : "search then insert", (t1 - t0) / writes);
+
+	map.delete(map.root);
+	free(keys);
+}
+
+/**
+ * Benchmark program
+ * usage: ./bench [upsert|search-insert] [keys]
+ *
+ */
+int main(int argc, char ** argv){
+	const char * mode = (argc > 1)? argv[1] : "upsert";
+	size_t n = (argc > 2)? strtoul(argv[2], NULL, 10) : 1000000;
+
+	if(strcmp(mode, "upsert") == 0){
+		bench_write(true, n);
+	}
+	else if(strcmp(mode, "search-insert") == 0){
+		bench_write(false, n);
+	}
+	else{
+		fprintf(stderr, "unknown benchmark %s\n", mode);
+		return 1;
+	}
+	return 0;
+}
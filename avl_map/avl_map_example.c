@@ -0,0 +1,62 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include "avl_map.h"
+#include <stdio.h>
+
+/**
+ * MapVisitor printing a key and its payload.
+ */
+private void print_entry(MapNode * node, void * context){
+	(void) context;
+	printf("%d:%s ", node->key, (const char*) node->payload);
+}
+
+/**
+ * Main program
+ * Example of how to use the functions of the avl map
+ *
+ */
+int main(){
+	AvlMap map = avlmap();
+	MapNode * node;
+	void * old;
+	bool inserted;
+
+	map.upsert(&map.root, 3, "three", NULL, NULL);
+	map.upsert(&map.root, 1, "one", NULL, NULL);
+	map.upsert(&map.root, 2, "two", NULL, NULL);
+
+	node = map.insertOrGet(&map.root, 2, "deux", &inserted);
+	printf("key 2 %s: %s\n", inserted ? "added" : "already there", (const char*) node->payload);
+
+	node = map.upsert(&map.root, 3, "trois", &old, &inserted);
+	if(node != NULL && !inserted){
+		printf("key 3 was %s\n", (const char*) old);
+	}
+
+	map.walk(map.root, print_entry, NULL);
+	printf("\n");
+
+	if(map.remove(&map.root, 1, &old)){
+		printf("removed key 1: %s\n", (const char*) old);
+	}
+	printf("height: %d\n", map.height(map.root));
+
+	map.delete(map.root);
+	return 0;
+}
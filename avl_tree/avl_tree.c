@@ -19,43 +19,135 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-#define itemtype int
-
-typedef enum {false, true} bool;
-
-typedef struct node{
-	itemtype value;
-	struct node * left;
-	struct node * right;
-	int height;
-}Node;
-
-typedef struct avltree {
-	void (*insert)(Node ** tree, itemtype value);
-	Node* (*search)(Node * tree, itemtype value);
-	int (*height) (Node ** tree);
-	void (*delete) (Node * tree);	
-	void (*preOrder)(Node * tree);
-	void (*posOrder)(Node * tree);
-	void (*inOrder)(Node * tree);
-	bool (*remove) (Node ** tree, itemtype value);
-	Node * root;
-}AvlTree;
+#include "avl_tree.h"
+#include "avl_tree_inline.h"
+
+#ifdef TREE_STATS
+unsigned long avltree_rotations = 0;
+#endif
+
+/**
+ * recount the nodes of a subtree whose children changed, only when the
+ * nodes carry a size.
+ */
+#ifdef AVL_ORDER_STATISTICS
+#define UPDATE_SIZE(tree) ((tree)->size = 1 + avl_size((tree)->left) + avl_size((tree)->right))
+#else
+#define UPDATE_SIZE(tree) ((void) 0)
+#endif
+
+/**
+ * create an empty node pool.
+ *
+ * @param size_t chunk_nodes, nodes per chunk, 0 for NODEPOOL_CHUNK.
+ *
+ * @returns a new pool or NULL if out of memory
+ */
+NodePool * avltree_pool_create(size_t chunk_nodes){
+	NodePool * pool;
+	pool = (NodePool*) calloc(1, sizeof(NodePool));
+	if (pool == NULL){
+		return NULL;
+	}
+	pool->chunk_nodes = (chunk_nodes == 0)? NODEPOOL_CHUNK : chunk_nodes;
+	return pool;
+}
+
+/**
+ * give back every node of the pool at once, the pool stays usable.
+ * Costs one free per chunk instead of one free per node.
+ *
+ * @param NodePool * pool, the pool to empty.
+ */
+void avltree_pool_release(NodePool * pool){
+	NodeChunk * chunk;
+	while (pool->chunks != NULL){
+		chunk = pool->chunks;
+		pool->chunks = chunk->next;
+		free(chunk);
+	}
+	pool->free_list = NULL;
+	pool->used = 0;
+}
+
+/**
+ * release every node of the pool and the pool itself.
+ *
+ * @param NodePool * pool, the pool to destroy.
+ */
+void avltree_pool_destroy(NodePool * pool){
+	if (pool != NULL){
+		avltree_pool_release(pool);
+		free(pool);
+	}
+}
+
+/**
+ * take one node from the pool: a recycled node if any, otherwise the next
+ * free slot of the newest chunk, allocating a new chunk when it is full.
+ *
+ * @param NodePool * pool, the pool, NULL to use calloc.
+ *
+ * @returns an uninitialized node or NULL if out of memory
+ */
+static Node * allocNode(NodePool * pool){
+	Node * aux;
+	NodeChunk * chunk;
+	if (pool == NULL){
+		return (Node*) calloc(1, sizeof(Node));
+	}
+	if (pool->free_list != NULL){
+		aux = pool->free_list;
+		pool->free_list = aux->left;
+		return aux;
+	}
+	if (pool->chunks == NULL || pool->used == pool->chunk_nodes){
+		chunk = (NodeChunk*) malloc(sizeof(NodeChunk) + pool->chunk_nodes * sizeof(Node));
+		if (chunk == NULL){
+			return NULL;
+		}
+		chunk->next = pool->chunks;
+		pool->chunks = chunk;
+		pool->used = 0;
+		pool->allocations++;
+	}
+	return &pool->chunks->nodes[pool->used++];
+}
+
+/**
+ * give a node back to its pool free list, or to free when there is no pool.
+ *
+ * @param NodePool * pool, the pool owning the node, NULL if it came from calloc.
+ * @param Node * node, the node to release.
+ */
+static void freeNode(NodePool * pool, Node * node){
+	if (pool == NULL){
+		free(node);
+		return;
+	}
+	node->left = pool->free_list;
+	pool->free_list = node;
+}
 
 /**
  * createNode allocates a new node with the given value and NULL left and right pointers
  *
+ * @param NodePool * pool, the pool to carve the node from, NULL to use calloc.
  * @param itemtype value, value to insert.
  *
  * @returns a new node, a pointer of type node
  */
-Node* createNode(itemtype value){
+static Node * createNode(NodePool * pool, itemtype value){
 	Node* aux;
-	aux = (Node*) calloc(1, sizeof(Node));
+	aux = allocNode(pool);
+	if (aux == NULL){
+		return NULL;
+	}
 	aux->value = value;
 	aux->left = NULL;
 	aux->right = NULL;
 	aux->height = 1;
+	UPDATE_SIZE(aux);
 	return aux;
 }
 
@@ -66,11 +158,8 @@ Node* createNode(itemtype value){
  *
  * @returns a integer type, is the height of tree 
  */
-int height(Node ** tree){
-	if ((*tree) == NULL){
-		return 0;
-	}
-	return (*tree)->height;
+static int height(Node ** tree){
+	return avl_height(*tree);
 }
 
 /**
@@ -81,7 +170,7 @@ int height(Node ** tree){
  *
  * @returns a integer type, is the highest value between two integers
  */ 
-int max(int a, int b){
+static int max(int a, int b){
 	return (a > b)? a : b;
 }
 
@@ -92,28 +181,13 @@ int max(int a, int b){
  *
  * @returns a integer type, is the balance factor of a node 
  */
-int getBalance(Node ** tree){
+static int getBalance(Node ** tree){
 	if ((*tree) == NULL){
 		return 0;
 	}
 	return height(&(*tree)->left) - height(&(*tree)->right);
 }
 
-/**
- * find the element with a minimum value on the left side.
- *
- * @param Node ** tree, the root of the tree, is a Node type pointer.
- *
- * @returns by the node referring the minimum element.
- */
-Node * findMinValue(Node * tree){
-	if(tree->left == NULL)
-		return tree;
-	else{
-		findMinValue(tree->left);
-	}
-}
-
 /**
  * Right Rotate 
  *
@@ -121,7 +195,7 @@ Node * findMinValue(Node * tree){
  *
  * @returns by parameter a new tree with a right rotate.
  */
-void rightRotate( Node ** tree){
+static void rightRotate( Node ** tree){
 	Node * tree_balance = (*tree)->left;
 	Node * aux = tree_balance->right;
 
@@ -130,6 +204,11 @@ void rightRotate( Node ** tree){
 
 	(*tree)->height = max(height(&(*tree)->left), height(&(*tree)->right))+1;
 	tree_balance->height = max(height(&tree_balance->left), height(&tree_balance->right))+1;
+	UPDATE_SIZE(*tree);
+	UPDATE_SIZE(tree_balance);
+#ifdef TREE_STATS
+	avltree_rotations++;
+#endif
 	(*tree) = tree_balance;
 }
 
@@ -140,7 +219,7 @@ void rightRotate( Node ** tree){
  *
  * @returns by parameter a new tree with a left rotate.
  */
-void leftRotate(Node ** tree){
+static void leftRotate(Node ** tree){
 	Node * tree_balance = (*tree)->right;
 	Node * aux = tree_balance->left;
 
@@ -149,201 +228,1013 @@ void leftRotate(Node ** tree){
 
 	(*tree)->height = max(height(&(*tree)->left), height(&(*tree)->right))+1;
 	tree_balance->height = max(height(&tree_balance->left), height(&tree_balance->right))+1;
+	UPDATE_SIZE(*tree);
+	UPDATE_SIZE(tree_balance);
+#ifdef TREE_STATS
+	avltree_rotations++;
+#endif
 	(*tree) = tree_balance;
 }
 
 /**
- * Insert elements in binary tree.
+ * update the height of a node whose children changed and rotate it back
+ * into balance when the avl property no longer holds.
  *
- * @param node ** tree, the root of the tree, is a node type pointer.
- * @param itemtype val, value to insert.
+ * @param Node ** tree, the root of the subtree, is a Node type pointer.
  *
- * @returns by parameter the tree with the new element.
+ * @returns by parameter the balanced subtree.
  */
-void insert(Node ** tree, itemtype value){
+static void rebalance(Node ** tree){
 	int balance;
-	if ((*tree) == NULL){
-		*tree = (createNode(value));
-		return;
-	}
-	if (value < (*tree)->value){
-		insert(&(*tree)->left, value);
-	}
-	else if (value > (*tree)->value){
-		insert(&(*tree)->right, value);
-	}
-	else{
-		return;
-	}
 
 	(*tree)->height = 1 + max(height(&(*tree)->left), height(&(*tree)->right));
+	UPDATE_SIZE(*tree);
 
 	balance = getBalance(&(*tree));
 
-	if (balance > 1 && value < (*tree)->left->value){
+	if (balance > 1){
+		if (getBalance(&(*tree)->left) < 0){
+			leftRotate(&(*tree)->left);
+		}
 		rightRotate(&(*tree));
-		return;
 	}
-	else if (balance < -1 && value > (*tree)->right->value){
+	else if (balance < -1){
+		if (getBalance(&(*tree)->right) > 0){
+			rightRotate(&(*tree)->right);
+		}
 		leftRotate(&(*tree));
-		return;
 	}
-	else if (balance > 1 && value > (*tree)->left->value){
-		leftRotate(&(*tree)->left);
-		rightRotate(&(*tree));
-		return;
+}
+
+/**
+ * walk back up a path recorded during a descent, rebalancing every node,
+ * until a subtree keeps the height it had before the change. Sizes change
+ * all the way up, so with AVL_ORDER_STATISTICS the rest of the path is
+ * still recounted.
+ *
+ * @param Node ** path[], the links followed from the root, top of path last.
+ * @param int top, number of links in the path.
+ */
+static void rebalancePath(Node ** path[], int top){
+	int old;
+	while (top > 0){
+		old = (*path[--top])->height;
+		rebalance(path[top]);
+		if ((*path[top])->height == old){
+			break;
+		}
 	}
-	else if (balance < -1 && value < (*tree)->right->value){
-		rightRotate(&(*tree)->right);
-		leftRotate(&(*tree));
-		return;
+#ifdef AVL_ORDER_STATISTICS
+	while (top > 0){
+		top--;
+		UPDATE_SIZE(*path[top]);
 	}
+#endif
 }
 
 /**
- * remove elements in Avl tree.
+ * Insert elements in avl tree, taking the new node from a pool.
+ * A single descent records the path on a bounded stack, the way back up
+ * rebalances it without recursion.
+ *
+ * @param NodePool * pool, the pool of the tree, NULL to use calloc.
+ * @param node ** tree, the root of the tree, is a node type pointer.
+ * @param itemtype val, value to insert.
+ *
+ * @returns true if the value was added, false if it was already there or out of memory.
+ */
+bool avltree_add(NodePool * pool, Node ** tree, itemtype value){
+	Node ** path[AVL_MAX_HEIGHT];
+	int top = 0;
+
+	while ((*tree) != NULL){
+		path[top++] = tree;
+		if (value < (*tree)->value){
+			tree = &(*tree)->left;
+		}
+		else if (value > (*tree)->value){
+			tree = &(*tree)->right;
+		}
+		else{
+			return false;
+		}
+	}
+	*tree = createNode(pool, value);
+	if ((*tree) == NULL){
+		return false;
+	}
+	rebalancePath(path, top);
+	return true;
+}
+
+/**
+ * Insert elements in avl tree, taking the new node from a pool.
+ *
+ * @param NodePool * pool, the pool of the tree, NULL to use calloc.
+ * @param node ** tree, the root of the tree, is a node type pointer.
+ * @param itemtype val, value to insert.
+ *
+ * @returns by parameter the tree with the new element.
+ */
+static void insertPool(NodePool * pool, Node ** tree, itemtype value){
+	avltree_add(pool, tree, value);
+}
+
+/**
+ * Insert elements in avl tree.
+ *
+ * @param node ** tree, the root of the tree, is a node type pointer.
+ * @param itemtype val, value to insert.
+ *
+ * @returns by parameter the tree with the new element.
+ */
+static void insert(Node ** tree, itemtype value){
+	insertPool(NULL, tree, value);
+}
+
+/**
+ * remove elements in Avl tree, giving the node back to a pool.
+ * The successor of a node with two children is found in the same descent
+ * that found the node, so the tree is walked down once and up once.
  *
+ * @param NodePool * pool, the pool of the tree, NULL if nodes came from calloc.
  * @param Node ** tree, the root of the tree, is a Node type pointer.
  * @param itemtype value, value to insert.
  *
  * @returns true if element removed or false if element not remove.
  */
-bool removeNode(Node ** tree, itemtype value){
-	Node * temp;	
-	int balance;
+static bool removePool(NodePool * pool, Node ** tree, itemtype value){
+	Node ** path[AVL_MAX_HEIGHT];
+	Node * found;
+	Node * temp;
+	int top = 0;
 
+	while ((*tree) != NULL && value != (*tree)->value){
+		path[top++] = tree;
+		tree = (value < (*tree)->value)? &(*tree)->left : &(*tree)->right;
+	}
 	if ((*tree) == NULL){
 		return false;
 	}
-	if ( value < (*tree)->value ){
-		removeNode(&(*tree)->left, value);
+	found = *tree;
+	if (found->left != NULL && found->right != NULL){
+		path[top++] = tree;
+		tree = &found->right;
+		while ((*tree)->left != NULL){
+			path[top++] = tree;
+			tree = &(*tree)->left;
+		}
+		found->value = (*tree)->value;
 	}
-	else if( value > (*tree)->value ){
-		removeNode(&(*tree)->right, value);
+	temp = *tree;
+	*tree = (temp->left != NULL)? temp->left : temp->right;
+	freeNode(pool, temp);
+	rebalancePath(path, top);
+	return true;
+}
+
+/**
+ * remove elements in Avl tree.
+ *
+ * @param Node ** tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, value to insert.
+ *
+ * @returns true if element removed or false if element not remove.
+ */
+static bool removeNode(Node ** tree, itemtype value){
+	return removePool(NULL, tree, value);
+}
+
+/**
+ * Search elements in avl tree.
+ *
+ * @param node * tree, the root of the tree, is a node type pointer.
+ * @param itemtype val, value to searched.
+ *
+ * @returns node type pointer, node referring to found element.
+ */
+static Node * search(Node * tree, itemtype value){
+	return avl_search(tree, value);
+}
+
+/**
+ * Lowest value not lower than value in avl tree, see avl_lower_bound.
+ *
+ * @param node * tree, the root of the tree, is a node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns node type pointer, NULL if every value is lower.
+ */
+static Node * lower_bound(Node * tree, itemtype value){
+	return avl_lower_bound(tree, value);
+}
+
+/**
+ * Lowest value greater than value in avl tree, see avl_upper_bound.
+ *
+ * @param node * tree, the root of the tree, is a node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns node type pointer, NULL if no value is greater.
+ */
+static Node * upper_bound(Node * tree, itemtype value){
+	return avl_upper_bound(tree, value);
+}
+
+/**
+ * Highest value not greater than value in avl tree, see avl_floor.
+ *
+ * @param node * tree, the root of the tree, is a node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns node type pointer, NULL if every value is greater.
+ */
+static Node * floor_node(Node * tree, itemtype value){
+	return avl_floor(tree, value);
+}
+
+/**
+ * Lowest value not lower than value in avl tree, see avl_ceil.
+ *
+ * @param node * tree, the root of the tree, is a node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns node type pointer, NULL if every value is lower.
+ */
+static Node * ceil_node(Node * tree, itemtype value){
+	return avl_ceil(tree, value);
+}
+
+#ifdef AVL_ORDER_STATISTICS
+/**
+ * Number of values lower than value in avl tree, see avl_rank.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the value ranked.
+ *
+ * @returns the number of values lower than value.
+ */
+static size_t rank(Node * tree, itemtype value){
+	return avl_rank(tree, value);
+}
+
+/**
+ * k-th lowest value of avl tree, see avl_select.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param size_t k, position of the value, counting from 0.
+ *
+ * @returns Node type pointer, NULL if k is not lower than the size.
+ */
+static Node * select_node(Node * tree, size_t k){
+	return avl_select(tree, k);
+}
+
+/**
+ * Number of values of avl tree in [lo, hi), see avl_count_range.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype lo, lowest value counted.
+ * @param itemtype hi, first value not counted.
+ *
+ * @returns the number of values in range.
+ */
+static size_t count_range(Node * tree, itemtype lo, itemtype hi){
+	return avl_count_range(tree, lo, hi);
+}
+#endif
+
+/**
+ * Search many elements in avl tree at once, see avl_search_batch.
+ *
+ * @param node * tree, the root of the tree, is a node type pointer.
+ * @param const itemtype * values, the values to search.
+ * @param size_t n, number of values.
+ * @param Node ** out, receives the node of each value, NULL if absent.
+ */
+static void search_batch(Node * tree, const itemtype * values, size_t n, Node ** out){
+	avl_search_batch(tree, values, n, out);
+}
+
+/**
+ * Delete and free memory of avl tree.
+ *
+ * @param node * tree, the root of the tree, is a node type pointer.
+ *
+ */
+static void delete_tree(Node * tree){
+	if(tree != NULL){
+		delete_tree(tree->left);
+		delete_tree(tree->right);
+		free(tree);
+	}
+}
+
+/**
+ * Delete every node of a pooled avl tree at once.
+ *
+ * @param NodePool * pool, the pool of the tree, NULL if nodes came from calloc.
+ * @param node ** tree, the root of the tree, is a node type pointer.
+ *
+ * @returns by parameter an empty tree.
+ */
+static void release(NodePool * pool, Node ** tree){
+	if (pool == NULL){
+		delete_tree(*tree);
 	}
 	else{
-		if((*tree)->right && (*tree)->left){
-			temp = findMinValue((*tree)->right);
-			(*tree)->value = temp->value;
-			removeNode(&(*tree)->right, temp->value);        	
+		avltree_pool_release(pool);
+	}
+	*tree = NULL;
+}
+
+/**
+ * Visit every node of avl tree in the given order, walking with a bounded
+ * stack instead of recursion. The visitor may free the node it gets in
+ * POS_ORDER, nothing reads a node after visiting it.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param TraversalOrder order, PRE_ORDER, IN_ORDER or POS_ORDER.
+ * @param NodeVisitor visit, called once per node.
+ * @param void * context, passed to visit.
+ */
+static void walk(Node * tree, TraversalOrder order, NodeVisitor visit, void * context){
+	Node * stack[AVL_MAX_HEIGHT];
+	Node * node;
+	Node * last = NULL;
+	int top = 0;
+
+	if (order == PRE_ORDER){
+		while (tree != NULL || top > 0){
+			if (tree == NULL){
+				tree = stack[--top];
+			}
+			if (tree->right != NULL){
+				stack[top++] = tree->right;
+			}
+			node = tree->left;
+			visit(tree, context);
+			tree = node;
 		}
-		else{
-			temp = *tree;
-			if((*tree)->left == NULL){
-				*tree = (*tree)->right;
+	}
+	else if (order == IN_ORDER){
+		while (tree != NULL || top > 0){
+			while (tree != NULL){
+				stack[top++] = tree;
+				tree = tree->left;
 			}
-			else if((*tree)->right == NULL){
-				*tree = (*tree)->left;
+			node = stack[--top];
+			tree = node->right;
+			visit(node, context);
+		}
+	}
+	else{
+		while (tree != NULL || top > 0){
+			if (tree != NULL){
+				stack[top++] = tree;
+				tree = tree->left;
+			}
+			else{
+				node = stack[top - 1];
+				if (node->right != NULL && node->right != last){
+					tree = node->right;
+				}
+				else{
+					top--;
+					last = node;
+					visit(node, context);
+				}
 			}
-			free(temp);
 		}
 	}
+}
 
-	if ((*tree) == NULL){
-		return true;
+/**
+ * Visit the nodes of avl tree holding values in [lo, hi), in ascending
+ * order. Subtrees wholly below lo are never entered and the walk stops at
+ * the first value not lower than hi, so it costs O(log n + k) for k values.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype lo, lowest value visited.
+ * @param itemtype hi, first value not visited.
+ * @param NodeVisitor visit, called once per node in range.
+ * @param void * context, passed to visit.
+ */
+static void range_scan(Node * tree, itemtype lo, itemtype hi, NodeVisitor visit, void * context){
+	Node * stack[AVL_MAX_HEIGHT];
+	Node * node;
+	int top = 0;
+
+	while (tree != NULL || top > 0){
+		while (tree != NULL){
+			if (tree->value < lo){
+				tree = tree->right;
+			}
+			else{
+				stack[top++] = tree;
+				tree = tree->left;
+			}
+		}
+		if (top == 0){
+			break;
+		}
+		node = stack[--top];
+		if (!(node->value < hi)){
+			break;
+		}
+		tree = node->right;
+		visit(node, context);
 	}
+}
 
-	(*tree)->height = 1 + max(height(&(*tree)->left),
-			height(&(*tree)->right));
+/**
+ * NodeVisitor printing the value of a node.
+ */
+static void print_node(Node * node, void * context){
+	(void) context;
+	printf("%d ", node->value);
+}
 
-	balance = getBalance(&(*tree));
+/**
+ * Print avl tree in preorder form.
+ *
+ * @param node * tree, the root of the tree, is a node type pointer.
+ *
+ */
+static void print_pre_order(Node * tree) {
+	walk(tree, PRE_ORDER, print_node, NULL);
+}
 
-	if (balance > 1 && getBalance(&(*tree)->left) >= 0){
-		rightRotate(&(*tree));
+/**
+ * Print avl tree in inorder form.
+ *
+ * @param node * tree, the root of the tree, is a node type pointer.
+ *
+ */
+static void print_in_order(Node * tree) {
+	walk(tree, IN_ORDER, print_node, NULL);
+}
+
+/**
+ * Print avl tree in posorder form.
+ *
+ * @param node * tree, the root of the tree, is a node type pointer.
+ *
+ */
+static void print_pos_order(Node * tree) {
+	walk(tree, POS_ORDER, print_node, NULL);
+}
+
+/**
+ * compare two items for qsort.
+ *
+ * @param const void * a, pointer to the first item.
+ * @param const void * b, pointer to the second item.
+ *
+ * @returns negative, zero or positive as a is lower, equal or greater than b
+ */
+static int compareItems(const void * a, const void * b){
+	itemtype x = *(const itemtype*) a;
+	itemtype y = *(const itemtype*) b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * sort values in place and move each distinct value once to the front.
+ *
+ * @param itemtype * values, the values to sort.
+ * @param size_t n, number of values.
+ *
+ * @returns the number of distinct values now at the front of the buffer
+ */
+static size_t sortUnique(itemtype * values, size_t n){
+	size_t i, unique = 0;
+	qsort(values, n, sizeof(itemtype), compareItems);
+	for (i = 0; i < n; i++){
+		if (unique == 0 || values[unique - 1] < values[i]){
+			values[unique++] = values[i];
+		}
 	}
-	if (balance > 1 && getBalance(&(*tree)->left) < 0){
-		leftRotate(&(*tree)->left);
-		rightRotate(&(*tree));
+	return unique;
+}
+
+/**
+ * give every node of a tree back to its pool, or to free when there is no pool.
+ *
+ * @param NodePool * pool, the pool owning the nodes, NULL if they came from calloc.
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ */
+static void freeTree(NodePool * pool, Node * tree){
+	if (tree != NULL){
+		freeTree(pool, tree->left);
+		freeTree(pool, tree->right);
+		freeNode(pool, tree);
 	}
-	if (balance < -1 && getBalance(&(*tree)->right) <= 0){
-		leftRotate(&(*tree));
+}
+
+/**
+ * build a perfectly balanced avl tree from strictly ascending values,
+ * the middle value becomes the root of each subtree.
+ *
+ * @param NodePool * pool, the pool to carve nodes from, NULL to use calloc.
+ * @param const itemtype * values, the values in ascending order.
+ * @param size_t n, number of values.
+ *
+ * @returns the root of the new tree, a node type pointer, NULL if out of
+ * memory, the nodes built so far are then released.
+ */
+static Node * buildBalanced(NodePool * pool, const itemtype * values, size_t n){
+	Node * aux;
+	size_t mid;
+	if (n == 0){
+		return NULL;
 	}
-	if (balance < -1 && getBalance(&(*tree)->right) > 0){
-		rightRotate(&(*tree)->right);
-		leftRotate(&(*tree));
+	mid = n / 2;
+	aux = createNode(pool, values[mid]);
+	if (aux == NULL){
+		return NULL;
 	}
-	return true;
+	aux->left = buildBalanced(pool, values, mid);
+	if (aux->left == NULL && mid > 0){
+		freeNode(pool, aux);
+		return NULL;
+	}
+	aux->right = buildBalanced(pool, values + mid + 1, n - mid - 1);
+	if (aux->right == NULL && n - mid - 1 > 0){
+		freeTree(pool, aux);
+		return NULL;
+	}
+	aux->height = 1 + max(height(&aux->left), height(&aux->right));
+	UPDATE_SIZE(aux);
+	return aux;
 }
 
 /**
- * Search elements in avl tree.
+ * join two avl trees and a middle node whose value lies between them,
+ * whatever their heights. The middle node is hung on the spine of the
+ * taller tree where the heights meet and the spine is rebalanced upwards,
+ * costing O(|height(left) - height(right)|).
  *
- * @param node * tree, the root of the tree, is a node type pointer.
- * @param itemtype val, value to searched.
+ * @param Node * left, tree of values lower than middle.
+ * @param Node * middle, the node that joins both trees.
+ * @param Node * right, tree of values greater than middle.
  *
- * @returns node type pointer, node referring to found element.
+ * @returns the root of the joined tree, a Node type pointer.
+ */
+static Node * joinTrees(Node * left, Node * middle, Node * right){
+	Node ** path[AVL_MAX_HEIGHT];
+	Node ** link;
+	Node * root;
+	int top = 0;
+
+	if (height(&left) > height(&right) + 1){
+		root = left;
+		link = &root;
+		while (height(link) > height(&right) + 1){
+			path[top++] = link;
+			link = &(*link)->right;
+		}
+		middle->left = *link;
+		middle->right = right;
+	}
+	else if (height(&right) > height(&left) + 1){
+		root = right;
+		link = &root;
+		while (height(link) > height(&left) + 1){
+			path[top++] = link;
+			link = &(*link)->left;
+		}
+		middle->left = left;
+		middle->right = *link;
+	}
+	else{
+		root = middle;
+		link = &root;
+		middle->left = left;
+		middle->right = right;
+	}
+	middle->height = 1 + max(height(&middle->left), height(&middle->right));
+	UPDATE_SIZE(middle);
+	*link = middle;
+	rebalancePath(path, top);
+	return root;
+}
+
+/**
+ * merge sorted distinct values into an avl tree: the values are split
+ * around each node met on the way down, the parts that fall off the
+ * tree become balanced subtrees and every node is joined back with its
+ * merged children. Subtrees no value falls into are never visited.
+ * A part whose subtree cannot be allocated is left out and the joins go
+ * on, so the result is always a whole avl tree.
+ *
+ * @param NodePool * pool, the pool of the tree, NULL to use calloc.
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param const itemtype * values, distinct values in ascending order.
+ * @param size_t n, number of values.
+ * @param bool * complete, set to false if some values were left out.
+ *
+ * @returns the root of the merged tree, a Node type pointer.
  */
-Node* search(Node * tree, itemtype value){
+static Node * mergeSorted(NodePool * pool, Node * tree, const itemtype * values, size_t n, bool * complete){
+	size_t lo = 0, hi = n, mid;
+	Node * left;
+	Node * right;
+
+	if (n == 0){
+		return tree;
+	}
 	if (tree == NULL){
-		return  NULL;
+		tree = buildBalanced(pool, values, n);
+		if (tree == NULL){
+			*complete = false;
+		}
+		return tree;
+	}
+	while (lo < hi){
+		mid = lo + (hi - lo) / 2;
+		if (values[mid] < tree->value){
+			lo = mid + 1;
+		}
+		else{
+			hi = mid;
+		}
+	}
+	hi = (lo < n && values[lo] == tree->value)? lo + 1 : lo;
+	left = mergeSorted(pool, tree->left, values, lo, complete);
+	right = mergeSorted(pool, tree->right, values + hi, n - hi, complete);
+	return joinTrees(left, tree, right);
+}
+
+/**
+ * Insert a batch of elements in avl tree in one pass. The batch is
+ * sorted and deduplicated in place, then merged with mergeSorted, which
+ * costs O(m log(n/m + 1)) instead of m full descents. Out of memory, the
+ * values left out are retried one at a time, as tree.insert would.
+ *
+ * @param NodePool * pool, the pool of the tree, NULL to use calloc.
+ * @param Node ** tree, the root of the tree, is a Node type pointer.
+ * @param itemtype * values, values to insert, reordered by the call.
+ * @param size_t n, number of values.
+ *
+ * @returns by parameter the tree with the new elements.
+ */
+static void insert_batch(NodePool * pool, Node ** tree, itemtype * values, size_t n){
+	bool complete = true;
+	size_t i;
+	n = sortUnique(values, n);
+	*tree = mergeSorted(pool, *tree, values, n, &complete);
+	if (!complete){
+		for (i = 0; i < n; i++){
+			avltree_add(pool, tree, values[i]);
+		}
+	}
+}
+
+/**
+ * split an avl tree around a value into the values lower and the values
+ * greater, joining back the subtrees met on the way down. O(log n).
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the value to split at.
+ * @param Node ** left, receives the tree of lower values.
+ * @param Node ** right, receives the tree of greater values.
+ *
+ * @returns the node of value, detached from both trees, NULL if absent.
+ */
+Node * avltree_split(Node * tree, itemtype value, Node ** left, Node ** right){
+	Node * found;
+	Node * aux;
+	if (tree == NULL){
+		*left = NULL;
+		*right = NULL;
+		return NULL;
+	}
+	if (value < tree->value){
+		found = avltree_split(tree->left, value, left, &aux);
+		*right = joinTrees(aux, tree, tree->right);
+		return found;
+	}
+	if (value > tree->value){
+		found = avltree_split(tree->right, value, &aux, right);
+		*left = joinTrees(tree->left, tree, aux);
+		return found;
 	}
-	else if(value < tree->value){
-		search(tree->left, value);
+	*left = tree->left;
+	*right = tree->right;
+	tree->left = NULL;
+	tree->right = NULL;
+	tree->height = 1;
+	UPDATE_SIZE(tree);
+	return tree;
+}
+
+/**
+ * detach the node of the highest value of an avl tree, joining back the
+ * subtrees along the right spine. O(log n).
+ *
+ * @param Node * tree, the root of the tree, not NULL.
+ * @param Node ** rest, receives the tree without the node.
+ *
+ * @returns the detached node.
+ */
+static Node * splitLast(Node * tree, Node ** rest){
+	Node * last;
+	Node * aux;
+	if (tree->right == NULL){
+		*rest = tree->left;
+		return tree;
+	}
+	last = splitLast(tree->right, &aux);
+	*rest = joinTrees(tree->left, tree, aux);
+	return last;
+}
+
+/**
+ * join two avl trees, every value of left lower than every value of
+ * right, through a middle node or through the highest node of left when
+ * there is none. O(log n).
+ *
+ * @param Node * left, tree of the lower values.
+ * @param Node * middle, a detached node whose value lies between both trees, or NULL.
+ * @param Node * right, tree of the greater values.
+ *
+ * @returns the root of the joined tree, a Node type pointer.
+ */
+Node * avltree_join(Node * left, Node * middle, Node * right){
+	if (middle == NULL){
+		if (left == NULL){
+			return right;
+		}
+		middle = splitLast(left, &left);
 	}
-	else if(value > tree->value){
-		search(tree->right, value);
+	return joinTrees(left, middle, right);
+}
+
+/**
+ * give back a list of nodes linked through their left pointer.
+ *
+ * @param NodePool * pool, the pool of the nodes, NULL if they came from calloc.
+ * @param Node * list, the first node.
+ */
+void avltree_free_nodes(NodePool * pool, Node * list){
+	Node * next;
+	while (list != NULL){
+		next = list->left;
+		freeNode(pool, list);
+		list = next;
 	}
-	else if(value == tree->value){
+}
+
+/**
+ * push a node on a list linked through left, the walk visitor of dropTree.
+ *
+ * @param Node * node, the node, no longer part of any tree.
+ * @param void * context, the Node * list.
+ */
+static void dropNode(Node * node, void * context){
+	node->left = *(Node**) context;
+	*(Node**) context = node;
+}
+
+/**
+ * push every node of a tree on a list linked through left.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param Node ** dropped, the list.
+ */
+static void dropTree(Node * tree, Node ** dropped){
+	walk(tree, POS_ORDER, dropNode, dropped);
+}
+
+/**
+ * union of two avl trees, built from their nodes: the other tree is
+ * split at the value of the root, each half is united with one subtree of
+ * the root and both results are joined through it.
+ *
+ * @param Node * tree, the root of the first tree.
+ * @param Node * other, the root of the second tree.
+ * @param Node ** dropped, receives the nodes of values found in both.
+ *
+ * @returns the root of the union.
+ */
+static Node * unionTrees(Node * tree, Node * other, Node ** dropped){
+	Node * found;
+	Node * left;
+	Node * right;
+	if (tree == NULL){
+		return other;
+	}
+	if (other == NULL){
 		return tree;
 	}
+	found = avltree_split(other, tree->value, &left, &right);
+	if (found != NULL){
+		dropNode(found, dropped);
+	}
+	left = unionTrees(tree->left, left, dropped);
+	right = unionTrees(tree->right, right, dropped);
+	return joinTrees(left, tree, right);
 }
 
 /**
- * Delete and free memory of avl tree.
+ * intersection of two avl trees, built from the nodes of the first.
  *
- * @param node * tree, the root of the tree, is a node type pointer.
+ * @param Node * tree, the root of the first tree.
+ * @param Node * other, the root of the second tree.
+ * @param Node ** dropped, receives every node left out.
  *
+ * @returns the root of the intersection.
  */
-void delete_tree(Node * tree){
-	if(tree != NULL){
-		delete_tree(tree->left);
-		delete_tree(tree->right);
-		free(tree);
+static Node * intersectTrees(Node * tree, Node * other, Node ** dropped){
+	Node * found;
+	Node * left;
+	Node * right;
+	if (tree == NULL || other == NULL){
+		dropTree(tree, dropped);
+		dropTree(other, dropped);
+		return NULL;
+	}
+	found = avltree_split(other, tree->value, &left, &right);
+	left = intersectTrees(tree->left, left, dropped);
+	right = intersectTrees(tree->right, right, dropped);
+	if (found != NULL){
+		dropNode(found, dropped);
+		return joinTrees(left, tree, right);
 	}
+	dropNode(tree, dropped);
+	return avltree_join(left, NULL, right);
 }
 
 /**
- * Print avl tree in preorder form.
+ * values of the first avl tree missing from the second, built from the
+ * nodes of the first. Like the union it splits the second tree, so the
+ * first one is only taken apart where values of the second fall.
  *
- * @param node * tree, the root of the tree, is a node type pointer.
+ * @param Node * tree, the root of the first tree.
+ * @param Node * other, the root of the second tree.
+ * @param Node ** dropped, receives every node left out.
  *
+ * @returns the root of the difference.
  */
-void print_pre_order(Node * tree) {
-	if(tree != NULL){
-		printf("%d ", tree->value);
-		print_pre_order(tree->left);
-		print_pre_order(tree->right);
+static Node * subtractTrees(Node * tree, Node * other, Node ** dropped){
+	Node * found;
+	Node * left;
+	Node * right;
+	if (tree == NULL || other == NULL){
+		dropTree(other, dropped);
+		return tree;
+	}
+	found = avltree_split(other, tree->value, &left, &right);
+	left = subtractTrees(tree->left, left, dropped);
+	right = subtractTrees(tree->right, right, dropped);
+	if (found == NULL){
+		return joinTrees(left, tree, right);
 	}
+	dropNode(found, dropped);
+	dropNode(tree, dropped);
+	return avltree_join(left, NULL, right);
 }
 
 /**
- * Print avl tree in inorder form.
+ * Unite an avl tree with another, taking over its nodes, in
+ * O(m log(n/m + 1)) for trees of m <= n values. Nodes of values in both
+ * go back to the pool.
  *
- * @param node * tree, the root of the tree, is a node type pointer.
+ * @param NodePool * pool, the pool of both trees, NULL if nodes came from calloc.
+ * @param Node ** tree, the root of the tree, receives the union.
+ * @param Node * other, the root of the other tree, consumed by the call.
  *
+ * @returns by parameter the union.
  */
-void print_in_order(Node * tree) {
-	if(tree != NULL){
-		print_in_order(tree->left);		
-		printf("%d ", tree->value);
-		print_in_order(tree->right);
+static void set_union(NodePool * pool, Node ** tree, Node * other){
+	Node * dropped = NULL;
+	*tree = unionTrees(*tree, other, &dropped);
+	avltree_free_nodes(pool, dropped);
+}
+
+/**
+ * Keep in an avl tree only the values also in another, in
+ * O(m log(n/m + 1)) for trees of m <= n values plus the nodes given back
+ * to the pool, those of the other tree and those left out.
+ *
+ * @param NodePool * pool, the pool of both trees, NULL if nodes came from calloc.
+ * @param Node ** tree, the root of the tree, receives the intersection.
+ * @param Node * other, the root of the other tree, consumed by the call.
+ *
+ * @returns by parameter the intersection.
+ */
+static void set_intersection(NodePool * pool, Node ** tree, Node * other){
+	Node * dropped = NULL;
+	*tree = intersectTrees(*tree, other, &dropped);
+	avltree_free_nodes(pool, dropped);
+}
+
+/**
+ * Remove from an avl tree every value of another, in O(m log(n/m + 1))
+ * for trees of m <= n values plus the nodes given back to the pool, those
+ * of the other tree and those removed.
+ *
+ * @param NodePool * pool, the pool of both trees, NULL if nodes came from calloc.
+ * @param Node ** tree, the root of the tree, receives the difference.
+ * @param Node * other, the root of the other tree, consumed by the call.
+ *
+ * @returns by parameter the difference.
+ */
+static void set_difference(NodePool * pool, Node ** tree, Node * other){
+	Node * dropped = NULL;
+	*tree = subtractTrees(*tree, other, &dropped);
+	avltree_free_nodes(pool, dropped);
+}
+
+void avltree_cursor(AvlCursor * cursor, Node * tree){
+	cursor->root = tree;
+	cursor->top = 0;
+}
+
+/**
+ * push a node and its leftmost or rightmost descendants on the path.
+ *
+ * @param AvlCursor * cursor, the cursor.
+ * @param Node * node, the node, may be NULL.
+ * @param bool right, true to follow right children instead of left ones.
+ *
+ * @returns the last node pushed, the new current node
+ */
+static Node * descend(AvlCursor * cursor, Node * node, bool right){
+	while (node != NULL){
+		cursor->path[cursor->top++] = node;
+		node = right ? node->right : node->left;
 	}
+	return (cursor->top == 0)? NULL : cursor->path[cursor->top - 1];
 }
 
 /**
- * Print avl tree in posorder form.
+ * pop the path while the popped node is the given child of its parent.
  *
- * @param node * tree, the root of the tree, is a node type pointer.
+ * @param AvlCursor * cursor, the cursor, not empty.
+ * @param bool right, true to climb out of right subtrees, false for left.
  *
+ * @returns the first ancestor reached from the other side, NULL if none
  */
-void print_pos_order(Node * tree) {
-	if(tree != NULL){
-		print_pos_order(tree->left);	
-		print_pos_order(tree->right);				
-		printf("%d ", tree->value);					
+static Node * ascend(AvlCursor * cursor, bool right){
+	Node * node;
+	do{
+		node = cursor->path[--cursor->top];
+	} while (cursor->top > 0 &&
+			(right ? cursor->path[cursor->top - 1]->right : cursor->path[cursor->top - 1]->left) == node);
+	return (cursor->top == 0)? NULL : cursor->path[cursor->top - 1];
+}
+
+Node * avltree_cursor_first(AvlCursor * cursor){
+	cursor->top = 0;
+	return descend(cursor, cursor->root, false);
+}
+
+Node * avltree_cursor_last(AvlCursor * cursor){
+	cursor->top = 0;
+	return descend(cursor, cursor->root, true);
+}
+
+Node * avltree_cursor_next(AvlCursor * cursor){
+	Node * node;
+	if (cursor->top == 0){
+		return NULL;
+	}
+	node = cursor->path[cursor->top - 1];
+	if (node->right != NULL){
+		return descend(cursor, node->right, false);
+	}
+	return ascend(cursor, true);
+}
+
+Node * avltree_cursor_prev(AvlCursor * cursor){
+	Node * node;
+	if (cursor->top == 0){
+		return NULL;
 	}
+	node = cursor->path[cursor->top - 1];
+	if (node->left != NULL){
+		return descend(cursor, node->left, true);
+	}
+	return ascend(cursor, false);
 }
 
+Node * avltree_cursor_seek(AvlCursor * cursor, itemtype value){
+	Node * node = cursor->root;
+	cursor->top = 0;
+	while (node != NULL){
+		cursor->path[cursor->top++] = node;
+		if (value == node->value){
+			return node;
+		}
+		node = (value < node->value)? node->left : node->right;
+	}
+	if (cursor->top > 0 && cursor->path[cursor->top - 1]->value < value){
+		return avltree_cursor_next(cursor);
+	}
+	return (cursor->top == 0)? NULL : cursor->path[cursor->top - 1];
+}
 
 /**
  * method constructor
@@ -360,6 +1251,91 @@ AvlTree avltree(){
 	new_avl.preOrder = &print_pre_order;
 	new_avl.posOrder = &print_pos_order;
 	new_avl.inOrder = &print_in_order;	
+	new_avl.insertPool = &insertPool;
+	new_avl.removePool = &removePool;
+	new_avl.release = &release;
+	new_avl.insertBatch = &insert_batch;
+	new_avl.searchBatch = &search_batch;
+	new_avl.walk = &walk;
+	new_avl.lowerBound = &lower_bound;
+	new_avl.upperBound = &upper_bound;
+	new_avl.floor = &floor_node;
+	new_avl.ceil = &ceil_node;
+	new_avl.rangeScan = &range_scan;
+	new_avl.setUnion = &set_union;
+	new_avl.setIntersection = &set_intersection;
+	new_avl.setDifference = &set_difference;
+#ifdef AVL_ORDER_STATISTICS
+	new_avl.rank = &rank;
+	new_avl.select = &select_node;
+	new_avl.countRange = &count_range;
+#endif
 	new_avl.root = NULL;
+	new_avl.pool = NULL;
 	return new_avl;
+}
+
+/**
+ * method constructor of a tree whose nodes live in a NodePool
+ *
+ * @param size_t chunk_nodes, nodes per chunk, 0 for NODEPOOL_CHUNK.
+ *
+ * @returns a new AvlTree type with its own pool
+ */
+AvlTree avltree_pool(size_t chunk_nodes){
+	AvlTree new_avl = avltree();
+	new_avl.pool = avltree_pool_create(chunk_nodes);
+	return new_avl;
+}
+
+/**
+ * method constructor of a balanced tree holding sorted values, built in
+ * linear time. Values not in strictly ascending order are handled as by
+ * avltree_from_array.
+ *
+ * @param const itemtype * values, the values in ascending order.
+ * @param size_t n, number of values.
+ *
+ * @returns a new AvlTree type, empty if out of memory
+ */
+AvlTree avltree_from_sorted(const itemtype * values, size_t n){
+	AvlTree new_tree = avltree();
+	size_t i;
+	for (i = 1; i < n; i++){
+		if (!(values[i - 1] < values[i])){
+			return avltree_from_array(values, n);
+		}
+	}
+	new_tree.root = buildBalanced(NULL, values, n);
+	return new_tree;
+}
+
+/**
+ * method constructor of a balanced tree holding the values of an unsorted
+ * buffer, duplicates are kept once. The buffer is copied, sorted and
+ * deduplicated, so it costs O(n log n) instead of n inserts.
+ *
+ * @param const itemtype * values, the values in any order.
+ * @param size_t n, number of values.
+ *
+ * @returns a new AvlTree type, empty if out of memory
+ */
+AvlTree avltree_from_array(const itemtype * values, size_t n){
+	AvlTree new_tree = avltree();
+	itemtype * sorted;
+	size_t i, unique;
+	if (n == 0){
+		return new_tree;
+	}
+	sorted = (itemtype*) malloc(n * sizeof(itemtype));
+	if (sorted == NULL){
+		return new_tree;
+	}
+	for (i = 0; i < n; i++){
+		sorted[i] = values[i];
+	}
+	unique = sortUnique(sorted, n);
+	new_tree.root = buildBalanced(NULL, sorted, unique);
+	free(sorted);
+	return new_tree;
 }
\ No newline at end of file
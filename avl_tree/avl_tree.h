@@ -19,17 +19,76 @@
  * TREE STRUCTURES, TYPES. 
  *
  */
+#ifndef AVL_TREE_H
+#define AVL_TREE_H
+
+#include <stddef.h>
+
 #define itemtype int
 
+/**
+ * Bound on the height of any avl tree addressable in 64 bits, sizes the
+ * path stacks used instead of recursion.
+ */
+#define AVL_MAX_HEIGHT 96
+
 typedef enum {false, true} bool;
 
+/**
+ * Compiled with -DAVL_ORDER_STATISTICS every node also counts the nodes of
+ * its subtree, which gives AvlTree rank, select and countRange in
+ * O(log n). The count fills padding, so nodes keep their size either way.
+ * Everything linked together must agree on the flag.
+ */
 typedef struct node{
    itemtype value;
    struct node * left;
    struct node * right;
    int height;
+#ifdef AVL_ORDER_STATISTICS
+   unsigned int size;  /* nodes in this subtree, itself included */
+#endif
 }Node;
 
+/**
+ * Number of nodes carved from each chunk when a pool is created with 0.
+ */
+#define NODEPOOL_CHUNK 4096
+
+typedef struct nodechunk {
+   struct nodechunk * next;
+   Node nodes[];
+}NodeChunk;
+
+typedef struct nodepool {
+   NodeChunk * chunks;  /* every chunk owned by the pool, newest first */
+   Node * free_list;    /* removed nodes, linked through their left pointer */
+   size_t chunk_nodes;  /* nodes per chunk */
+   size_t used;         /* nodes already carved from the newest chunk */
+   size_t allocations;  /* number of malloc calls made by the pool */
+}NodePool;
+
+/**
+ * Order in which walk visits the nodes.
+ */
+typedef enum {PRE_ORDER, IN_ORDER, POS_ORDER} TraversalOrder;
+
+/**
+ * Callback of walk, called once per node with the context given to walk.
+ */
+typedef void (*NodeVisitor)(Node * node, void * context);
+
+/**
+ * Position in an avl tree, see avltree_cursor. The path from the root to
+ * the current node is kept on a bounded stack, so every step is O(1)
+ * amortized and nothing recurses. Inserting or removing invalidates it.
+ */
+typedef struct avlcursor {
+   Node * root;
+   Node * path[AVL_MAX_HEIGHT];  /* path[top - 1] is the current node */
+   int top;                      /* 0 once the cursor ran off either end */
+}AvlCursor;
+
 typedef struct avltree {
    void (*insert)(Node ** tree, itemtype value);
    Node* (*search)(Node * tree, itemtype value);
@@ -39,13 +98,196 @@ typedef struct avltree {
    void (*posOrder)(Node * tree);
    void (*inOrder)(Node * tree);
    bool (*remove) (Node ** tree, itemtype value);
+   void (*insertPool)(NodePool * pool, Node ** tree, itemtype value);
+   bool (*removePool) (NodePool * pool, Node ** tree, itemtype value);
+   void (*release) (NodePool * pool, Node ** tree);
+   void (*insertBatch)(NodePool * pool, Node ** tree, itemtype * values, size_t n);
+   void (*searchBatch)(Node * tree, const itemtype * values, size_t n, Node ** out);
+   void (*walk)(Node * tree, TraversalOrder order, NodeVisitor visit, void * context);
+   Node* (*lowerBound)(Node * tree, itemtype value);
+   Node* (*upperBound)(Node * tree, itemtype value);
+   Node* (*floor)(Node * tree, itemtype value);
+   Node* (*ceil)(Node * tree, itemtype value);
+   void (*rangeScan)(Node * tree, itemtype lo, itemtype hi, NodeVisitor visit, void * context);
+   void (*setUnion)(NodePool * pool, Node ** tree, Node * other);
+   void (*setIntersection)(NodePool * pool, Node ** tree, Node * other);
+   void (*setDifference)(NodePool * pool, Node ** tree, Node * other);
+#ifdef AVL_ORDER_STATISTICS
+   size_t (*rank)(Node * tree, itemtype value);
+   Node* (*select)(Node * tree, size_t k);
+   size_t (*countRange)(Node * tree, itemtype lo, itemtype hi);
+#endif
    Node * root;
+   NodePool * pool;
 }AvlTree;
 
 
+#ifdef TREE_STATS
+/**
+ * Number of single rotations done by every tree, counted when compiled
+ * with -DTREE_STATS.
+ */
+extern unsigned long avltree_rotations;
+#endif
+
 /**
  * method constructor
  *
  * @returns a new BinaryTree type and all functions
  */
 AvlTree avltree();
+
+/**
+ * method constructor of a tree whose nodes live in a NodePool
+ *
+ * @param size_t chunk_nodes, nodes per chunk, 0 for NODEPOOL_CHUNK.
+ *
+ * @returns a new AvlTree type with its own pool
+ */
+AvlTree avltree_pool(size_t chunk_nodes);
+
+/**
+ * create an empty node pool.
+ *
+ * @param size_t chunk_nodes, nodes per chunk, 0 for NODEPOOL_CHUNK.
+ *
+ * @returns a new pool or NULL if out of memory
+ */
+NodePool * avltree_pool_create(size_t chunk_nodes);
+
+/**
+ * give back every node of the pool at once, the pool stays usable.
+ *
+ * @param NodePool * pool, the pool to empty.
+ */
+void avltree_pool_release(NodePool * pool);
+
+/**
+ * release every node of the pool and the pool itself.
+ *
+ * @param NodePool * pool, the pool to destroy.
+ */
+void avltree_pool_destroy(NodePool * pool);
+
+/**
+ * method constructor of a balanced tree holding sorted values, built in
+ * linear time.
+ *
+ * @param const itemtype * values, the values in strictly ascending order.
+ * @param size_t n, number of values.
+ *
+ * @returns a new AvlTree type, empty if out of memory
+ */
+AvlTree avltree_from_sorted(const itemtype * values, size_t n);
+
+/**
+ * method constructor of a balanced tree holding the values of an unsorted
+ * buffer, duplicates are kept once.
+ *
+ * @param const itemtype * values, the values in any order.
+ * @param size_t n, number of values.
+ *
+ * @returns a new AvlTree type, empty if out of memory
+ */
+AvlTree avltree_from_array(const itemtype * values, size_t n);
+
+/**
+ * insert a value, telling whether it was added, for callers that keep
+ * their own counts. tree.insert and tree.insertPool call it.
+ *
+ * @param NodePool * pool, the pool of the tree, NULL to use calloc.
+ * @param Node ** tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, value to insert.
+ *
+ * @returns true if the value was added, false if it was already there or out of memory
+ */
+bool avltree_add(NodePool * pool, Node ** tree, itemtype value);
+
+/**
+ * split a tree around a value into the values lower and the values
+ * greater, in O(log n). The tree is consumed.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the value to split at.
+ * @param Node ** left, receives the tree of lower values.
+ * @param Node ** right, receives the tree of greater values.
+ *
+ * @returns the node of value, detached from both trees, NULL if absent
+ */
+Node * avltree_split(Node * tree, itemtype value, Node ** left, Node ** right);
+
+/**
+ * join two trees, every value of left lower than every value of right,
+ * in O(log n). Both trees are consumed.
+ *
+ * @param Node * left, tree of the lower values.
+ * @param Node * middle, a detached node whose value lies between both trees, or NULL.
+ * @param Node * right, tree of the greater values.
+ *
+ * @returns the root of the joined tree
+ */
+Node * avltree_join(Node * left, Node * middle, Node * right);
+
+/**
+ * give back a list of nodes linked through their left pointer.
+ *
+ * @param NodePool * pool, the pool of the nodes, NULL if they came from calloc.
+ * @param Node * list, the first node.
+ */
+void avltree_free_nodes(NodePool * pool, Node * list);
+
+/**
+ * start a cursor on a tree, positioned nowhere until first, last or seek.
+ *
+ * @param AvlCursor * cursor, the cursor.
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ */
+void avltree_cursor(AvlCursor * cursor, Node * tree);
+
+/**
+ * move a cursor to the lowest value.
+ *
+ * @param AvlCursor * cursor, the cursor.
+ *
+ * @returns the current node, NULL if the tree is empty
+ */
+Node * avltree_cursor_first(AvlCursor * cursor);
+
+/**
+ * move a cursor to the highest value.
+ *
+ * @param AvlCursor * cursor, the cursor.
+ *
+ * @returns the current node, NULL if the tree is empty
+ */
+Node * avltree_cursor_last(AvlCursor * cursor);
+
+/**
+ * move a cursor to the next value in ascending order.
+ *
+ * @param AvlCursor * cursor, the cursor.
+ *
+ * @returns the current node, NULL past the highest value
+ */
+Node * avltree_cursor_next(AvlCursor * cursor);
+
+/**
+ * move a cursor to the previous value in ascending order.
+ *
+ * @param AvlCursor * cursor, the cursor.
+ *
+ * @returns the current node, NULL before the lowest value
+ */
+Node * avltree_cursor_prev(AvlCursor * cursor);
+
+/**
+ * move a cursor to the lowest value not lower than value.
+ *
+ * @param AvlCursor * cursor, the cursor.
+ * @param itemtype value, value searched.
+ *
+ * @returns the current node, NULL if every value is lower
+ */
+Node * avltree_cursor_seek(AvlCursor * cursor, itemtype value);
+
+#endif
@@ -0,0 +1,653 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "avl_tree.h"
+#include "avl_tree_inline.h"
+#include "avl_tree_frozen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+/**
+ * monotonic clock in nanoseconds
+ *
+ * @returns the current time in nanoseconds
+ */
+static double now_ns(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * fill keys with a random permutation of 0 .. n-1
+ *
+ * @param itemtype * keys, the buffer to fill.
+ * @param size_t n, number of keys.
+ * @param unsigned long seed, seed of the xorshift generator.
+ */
+static void shuffled_keys(itemtype * keys, size_t n, unsigned long seed){
+	size_t i, j;
+	itemtype aux;
+	for (i = 0; i < n; i++){
+		keys[i] = (itemtype) i;
+	}
+	for (i = n; i > 1; i--){
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		j = seed % i;
+		aux = keys[i - 1];
+		keys[i - 1] = keys[j];
+		keys[j] = aux;
+	}
+}
+
+/**
+ * fill keys with random values over the whole itemtype range
+ *
+ * @param itemtype * keys, the buffer to fill.
+ * @param size_t n, number of keys.
+ * @param unsigned long seed, seed of the xorshift generator.
+ */
+static void random_keys(itemtype * keys, size_t n, unsigned long seed){
+	size_t i;
+	for (i = 0; i < n; i++){
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		keys[i] = (itemtype) (seed >> 32);
+	}
+}
+
+/**
+ * insert all keys, remove half of them, insert them again and tear the
+ * tree down, once through calloc and once through a NodePool.
+ *
+ * @param size_t n, number of keys.
+ */
+static void bench_pool(size_t n){
+	itemtype * keys = malloc(n * sizeof(itemtype));
+	AvlTree plain = avltree();
+	AvlTree pooled = avltree_pool(0);
+	double t0, t1, t2, t3;
+	size_t i;
+
+	shuffled_keys(keys, n, 88172645463325252UL);
+
+	t0 = now_ns();
+	for (i = 0; i < n; i++){
+		plain.insert(&plain.root, keys[i]);
+	}
+	t1 = now_ns();
+	for (i = 0; i < n / 2; i++){
+		plain.remove(&plain.root, keys[i]);
+	}
+	for (i = 0; i < n / 2; i++){
+		plain.insert(&plain.root, keys[i]);
+	}
+	t2 = now_ns();
+	plain.delete(plain.root);
+	t3 = now_ns();
+	printf("calloc: %.1f ns/insert, %.1f ns/remove+insert, teardown %.3f ms\n",
+			(t1 - t0) / n, (t2 - t1) / (n / 2 ? n / 2 : 1), (t3 - t2) / 1e6);
+
+	t0 = now_ns();
+	for (i = 0; i < n; i++){
+		pooled.insertPool(pooled.pool, &pooled.root, keys[i]);
+	}
+	t1 = now_ns();
+	for (i = 0; i < n / 2; i++){
+		pooled.removePool(pooled.pool, &pooled.root, keys[i]);
+	}
+	for (i = 0; i < n / 2; i++){
+		pooled.insertPool(pooled.pool, &pooled.root, keys[i]);
+	}
+	t2 = now_ns();
+	pooled.release(pooled.pool, &pooled.root);
+	t3 = now_ns();
+	printf("pool:   %zu allocations, %.1f ns/insert, %.1f ns/remove+insert, teardown %.3f ms\n",
+			pooled.pool->allocations, (t1 - t0) / n, (t2 - t1) / (n / 2 ? n / 2 : 1), (t3 - t2) / 1e6);
+
+	avltree_pool_destroy(pooled.pool);
+	free(keys);
+}
+
+/**
+ * load ascending keys with one insert per key and with avltree_from_sorted.
+ *
+ * @param size_t n, number of keys.
+ */
+static void bench_bulk(size_t n){
+	itemtype * keys = malloc(n * sizeof(itemtype));
+	AvlTree tree = avltree();
+	double t0, t1, t2;
+	size_t i;
+	int h;
+
+	for (i = 0; i < n; i++){
+		keys[i] = (itemtype) i;
+	}
+	t0 = now_ns();
+	for (i = 0; i < n; i++){
+		tree.insert(&tree.root, keys[i]);
+	}
+	t1 = now_ns();
+	h = tree.height(&tree.root);
+	tree.delete(tree.root);
+	t2 = now_ns();
+	tree = avltree_from_sorted(keys, n);
+	printf("insert loop:         %.1f ns/key, height %d\n", (t1 - t0) / n, h);
+	printf("avltree_from_sorted: %.1f ns/key, height %d\n", (now_ns() - t2) / n, tree.height(&tree.root));
+	tree.delete(tree.root);
+	free(keys);
+}
+
+/**
+ * merge batches of several sizes into a tree of n random keys, once with
+ * one insert per key and once with insertBatch.
+ *
+ * @param size_t n, number of keys already in the tree.
+ */
+static void bench_batch(size_t n){
+	static const size_t sizes[] = {10000, 100000, 1000000};
+	itemtype * keys = malloc(n * sizeof(itemtype));
+	itemtype * batch = malloc(sizes[2] * sizeof(itemtype));
+	AvlTree tree;
+	double t0, t1;
+	size_t i, s, m;
+
+	random_keys(keys, n, 88172645463325252UL);
+	for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++){
+		m = sizes[s];
+		random_keys(batch, m, 2463534242UL + s);
+		tree = avltree_from_array(keys, n);
+		t0 = now_ns();
+		for (i = 0; i < m; i++){
+			tree.insert(&tree.root, batch[i]);
+		}
+		t1 = now_ns();
+		printf("batch %7zu into %zu: insert loop %.2f Mkeys/s, ", m, n, m / (t1 - t0) * 1e3);
+		tree.delete(tree.root);
+
+		tree = avltree_from_array(keys, n);
+		t0 = now_ns();
+		tree.insertBatch(tree.pool, &tree.root, batch, m);
+		t1 = now_ns();
+		printf("insertBatch %.2f Mkeys/s\n", m / (t1 - t0) * 1e3);
+		tree.delete(tree.root);
+	}
+	free(batch);
+	free(keys);
+}
+
+/**
+ * look up random present keys through the AvlTree.search function pointer
+ * and through the inlined avl_search, on a tree that fits in L1 and on a
+ * tree of n keys that only fits in DRAM. Best of three runs each.
+ *
+ * @param size_t n, number of keys of the large tree.
+ */
+static void bench_inline(size_t n){
+	const size_t queries = 4000000;
+	size_t sizes[2];
+	itemtype * keys = malloc(n * sizeof(itemtype));
+	itemtype * lookups = malloc(queries * sizeof(itemtype));
+	AvlTree tree;
+	double t0, t1, t2, best_pointer, best_inline;
+	long found_pointer, found_inline;
+	size_t i, s;
+	int r;
+
+	sizes[0] = 512;
+	sizes[1] = n;
+	for (s = 0; s < 2; s++){
+		shuffled_keys(keys, sizes[s], 88172645463325252UL);
+		random_keys(lookups, queries, 2463534242UL);
+		for (i = 0; i < queries; i++){
+			lookups[i] = (itemtype) ((unsigned) lookups[i] % sizes[s]);
+		}
+		tree = avltree_from_array(keys, sizes[s]);
+
+		best_pointer = best_inline = 0;
+		for (r = 0; r < 3; r++){
+			found_pointer = 0;
+			found_inline = 0;
+			t0 = now_ns();
+			for (i = 0; i < queries; i++){
+				found_pointer += tree.search(tree.root, lookups[i]) != NULL;
+			}
+			t1 = now_ns();
+			for (i = 0; i < queries; i++){
+				found_inline += avl_search(tree.root, lookups[i]) != NULL;
+			}
+			t2 = now_ns();
+			if (r == 0 || t1 - t0 < best_pointer){
+				best_pointer = t1 - t0;
+			}
+			if (r == 0 || t2 - t1 < best_inline){
+				best_inline = t2 - t1;
+			}
+		}
+		printf("%s %zu keys: tree.search %.1f ns/search, avl_search %.1f ns/search (%ld/%ld found)\n",
+				(s == 0)? "L1  " : "DRAM", sizes[s], best_pointer / queries, best_inline / queries,
+				found_pointer, found_inline);
+		tree.delete(tree.root);
+	}
+	free(lookups);
+	free(keys);
+}
+
+/**
+ * look up random keys, half of them present, in a tree of n even keys
+ * through the live tree and through a frozen copy of it. The tree lives
+ * in a NodePool so 100M keys fit in memory.
+ *
+ * @param size_t n, number of keys.
+ */
+static void bench_frozen(size_t n){
+	const size_t queries = 4000000;
+	itemtype * keys = malloc(n * sizeof(itemtype));
+	itemtype * lookups = malloc(queries * sizeof(itemtype));
+	AvlTree tree = avltree_pool(0);
+	FrozenTree frozen;
+	double t0, t1, t2, t3, t4, t5;
+	long found = 0;
+	size_t i;
+
+	for (i = 0; i < n; i++){
+		keys[i] = (itemtype) (2 * i);
+	}
+	tree.insertBatch(tree.pool, &tree.root, keys, n);
+	free(keys);
+	random_keys(lookups, queries, 2463534242UL);
+	for (i = 0; i < queries; i++){
+		lookups[i] = (itemtype) ((unsigned) lookups[i] % (2 * n));
+	}
+
+	t0 = now_ns();
+	frozen = avltree_freeze(tree.root);
+	t1 = now_ns();
+	for (i = 0; i < queries; i++){
+		found += tree.search(tree.root, lookups[i]) != NULL;
+	}
+	t2 = now_ns();
+	for (i = 0; i < queries; i++){
+		found += avl_search(tree.root, lookups[i]) != NULL;
+	}
+	t3 = now_ns();
+	for (i = 0; i < queries; i++){
+		found += frozen_search(&frozen, lookups[i]) != NULL;
+	}
+	t4 = now_ns();
+	for (i = 0; i < queries; i++){
+		found += frozen_lower_bound(&frozen, lookups[i]) != NULL;
+	}
+	t5 = now_ns();
+	printf("%zu keys, freeze %.0f ms: tree.search %.1f ns, avl_search %.1f ns, "
+			"frozen_search %.1f ns, frozen_lower_bound %.1f ns (%ld)\n",
+			n, (t1 - t0) / 1e6, (t2 - t1) / queries, (t3 - t2) / queries,
+			(t4 - t3) / queries, (t5 - t4) / queries, found);
+
+	frozentree_free(&frozen);
+	tree.release(tree.pool, &tree.root);
+	avltree_pool_destroy(tree.pool);
+	free(lookups);
+}
+
+/**
+ * minor and major page faults of the process so far
+ *
+ * @returns the number of page faults
+ */
+static long page_faults(){
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_minflt + usage.ru_majflt;
+}
+
+/**
+ * what a restart costs: inserting n random keys one by one against
+ * loading a snapshot saved by avltree_save, mapped with frozentree_load
+ * and searched in place, or rebuilt with avltree_load. Page faults show
+ * how much of the mapping 1000 lookups read.
+ *
+ * @param size_t n, number of keys.
+ * @param const char * path, the snapshot file, removed at the end.
+ */
+static void bench_snapshot(size_t n, const char * path){
+	const size_t queries = 1000;
+	itemtype * keys = malloc(n * sizeof(itemtype));
+	AvlTree tree = avltree_pool(0);
+	AvlTree loaded;
+	FrozenTree frozen;
+	FrozenStatus status;
+	double t0, t1, t2;
+	long faults, found = 0;
+	size_t i;
+
+	shuffled_keys(keys, n, 88172645463325252UL);
+	t0 = now_ns();
+	for (i = 0; i < n; i++){
+		tree.insertPool(tree.pool, &tree.root, keys[i]);
+	}
+	t1 = now_ns();
+	status = avltree_save(tree.root, path);
+	t2 = now_ns();
+	if (status != FROZEN_OK){
+		fprintf(stderr, "avltree_save: %d\n", status);
+		exit(1);
+	}
+	printf("%zu keys: insert one by one %.0f ms, avltree_save %.0f ms\n", n, (t1 - t0) / 1e6, (t2 - t1) / 1e6);
+
+	t0 = now_ns();
+	status = frozentree_load(path, 0, &frozen);
+	t1 = now_ns();
+	faults = page_faults();
+	for (i = 0; i < queries; i++){
+		found += frozen_search(&frozen, keys[i]) != NULL;
+	}
+	t2 = now_ns();
+	printf("frozentree_load %.3f ms, then %zu lookups %.3f ms, %ld page faults for %zu pages (%ld found)\n",
+			(t1 - t0) / 1e6, queries, (t2 - t1) / 1e6, page_faults() - faults, frozen.map_bytes / 4096, found);
+	frozentree_free(&frozen);
+
+	t0 = now_ns();
+	status = frozentree_load(path, 1, &frozen);
+	t1 = now_ns();
+	printf("frozentree_load verified %.0f ms (%d)\n", (t1 - t0) / 1e6, status);
+	frozentree_free(&frozen);
+
+	t0 = now_ns();
+	status = avltree_load(path, &loaded);
+	t1 = now_ns();
+	printf("avltree_load %.0f ms, height %d (%d)\n", (t1 - t0) / 1e6, loaded.height(&loaded.root), status);
+
+	loaded.delete(loaded.root);
+	remove(path);
+	tree.release(tree.pool, &tree.root);
+	avltree_pool_destroy(tree.pool);
+	free(keys);
+}
+
+/**
+ * look up random keys, half of them present, in a tree
+ * of n even keys, one tree.search per key against tree.searchBatch over
+ * batches of several sizes.
+ *
+ * @param size_t n, number of keys.
+ */
+static void bench_search_batch(size_t n){
+	static const size_t sizes[] = {16, 64, 256, 1024};
+	const size_t queries = 4000000;
+	itemtype * keys = malloc(n * sizeof(itemtype));
+	itemtype * lookups = malloc(queries * sizeof(itemtype));
+	Node ** out = malloc(sizes[3] * sizeof(Node*));
+	AvlTree tree = avltree_pool(0);
+	double t0, t1;
+	long found = 0;
+	size_t i, j, s, m;
+
+	for (i = 0; i < n; i++){
+		keys[i] = (itemtype) (2 * i);
+	}
+	tree.insertBatch(tree.pool, &tree.root, keys, n);
+	free(keys);
+	random_keys(lookups, queries, 2463534242UL);
+	for (i = 0; i < queries; i++){
+		lookups[i] = (itemtype) ((unsigned) lookups[i] % (2 * n));
+	}
+
+	t0 = now_ns();
+	for (i = 0; i < queries; i++){
+		found += tree.search(tree.root, lookups[i]) != NULL;
+	}
+	t1 = now_ns();
+	printf("%zu keys: per key loop %.2f Mlookups/s\n", n, queries / (t1 - t0) * 1e3);
+	for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++){
+		m = sizes[s];
+		t0 = now_ns();
+		for (i = 0; i + m <= queries; i += m){
+			tree.searchBatch(tree.root, lookups + i, m, out);
+			for (j = 0; j < m; j++){
+				found += out[j] != NULL;
+			}
+		}
+		t1 = now_ns();
+		printf("%zu keys: searchBatch of %4zu %.2f Mlookups/s\n", n, m, (queries - queries % m) / (t1 - t0) * 1e3);
+	}
+	printf("(%ld found)\n", found);
+
+	tree.release(tree.pool, &tree.root);
+	avltree_pool_destroy(tree.pool);
+	free(out);
+	free(lookups);
+}
+
+/**
+ * NodeVisitor adding the value of a node to a long.
+ */
+static void sum_node(Node * node, void * context){
+	*(long*) context += node->value;
+}
+
+/**
+ * scan a tree of n random keys in order, through tree.inOrder writing to
+ * /dev/null, tree.walk with a visitor and a cursor.
+ *
+ * @param size_t n, number of keys.
+ */
+static void bench_walk(size_t n){
+	itemtype * keys = malloc(n * sizeof(itemtype));
+	AvlTree tree = avltree_pool(0);
+	AvlCursor cursor;
+	Node * node;
+	double t0, t1, t2, t3;
+	long sum_walk = 0, sum_cursor = 0;
+	size_t i;
+
+	shuffled_keys(keys, n, 88172645463325252UL);
+	for (i = 0; i < n; i++){
+		tree.insertPool(tree.pool, &tree.root, keys[i]);
+	}
+	free(keys);
+
+	t0 = now_ns();
+	if (freopen("/dev/null", "w", stdout) != NULL){
+		tree.inOrder(tree.root);
+		fflush(stdout);
+	}
+	t1 = now_ns();
+	tree.walk(tree.root, IN_ORDER, sum_node, &sum_walk);
+	t2 = now_ns();
+	avltree_cursor(&cursor, tree.root);
+	for (node = avltree_cursor_first(&cursor); node != NULL; node = avltree_cursor_next(&cursor)){
+		sum_cursor += node->value;
+	}
+	t3 = now_ns();
+	fprintf(stderr, "%zu keys: inOrder %.1f ns/node, walk %.1f ns/node, cursor %.1f ns/node (sums %ld %ld)\n",
+			n, (t1 - t0) / n, (t2 - t1) / n, (t3 - t2) / n, sum_walk, sum_cursor);
+
+	tree.release(tree.pool, &tree.root);
+	avltree_pool_destroy(tree.pool);
+}
+
+/**
+ * Window of values counted by count_in_window.
+ */
+typedef struct {
+	itemtype lo;
+	itemtype hi;
+	long count;
+} Window;
+
+/**
+ * NodeVisitor counting the nodes whose value falls in a Window.
+ */
+static void count_in_window(Node * node, void * context){
+	Window * window = (Window*) context;
+	if (node->value >= window->lo && node->value < window->hi){
+		window->count++;
+	}
+}
+
+/**
+ * count the values of windows of 100 consecutive keys in a tree of n
+ * random keys, filtering a full tree.walk against tree.rangeScan.
+ *
+ * @param size_t n, number of keys.
+ */
+static void bench_range(size_t n){
+	const size_t windows = 10000;
+	const size_t walks = 20;
+	itemtype * keys = malloc((n > windows ? n : windows) * sizeof(itemtype));
+	AvlTree tree = avltree_pool(0);
+	Window window;
+	double t0, t1, t2;
+	long filtered = 0, scanned = 0;
+	size_t i;
+
+	shuffled_keys(keys, n, 88172645463325252UL);
+	for (i = 0; i < n; i++){
+		tree.insertPool(tree.pool, &tree.root, keys[i]);
+	}
+	random_keys(keys, windows, 2463534242UL);
+
+	t0 = now_ns();
+	for (i = 0; i < walks; i++){
+		window.lo = (itemtype) ((unsigned) keys[i] % n);
+		window.hi = window.lo + 100;
+		window.count = 0;
+		tree.walk(tree.root, IN_ORDER, count_in_window, &window);
+		filtered += window.count;
+	}
+	t1 = now_ns();
+	for (i = 0; i < windows; i++){
+		window.lo = (itemtype) ((unsigned) keys[i] % n);
+		window.hi = window.lo + 100;
+		window.count = 0;
+		tree.rangeScan(tree.root, window.lo, window.hi, count_in_window, &window);
+		scanned += window.count;
+	}
+	t2 = now_ns();
+	printf("%zu keys: filtered walk %.1f us/window, rangeScan %.2f us/window (%ld %ld in range)\n",
+			n, (t1 - t0) / walks / 1e3, (t2 - t1) / windows / 1e3, filtered, scanned);
+
+	tree.release(tree.pool, &tree.root);
+	avltree_pool_destroy(tree.pool);
+	free(keys);
+}
+
+/**
+ * insert n random keys and remove half of them, then, when the tree keeps
+ * subtree sizes, time rank and select. Built with and without
+ * -DAVL_ORDER_STATISTICS it shows what keeping the sizes costs.
+ *
+ * @param size_t n, number of keys.
+ */
+static void bench_order(size_t n){
+	itemtype * keys = malloc(n * sizeof(itemtype));
+	AvlTree tree = avltree_pool(0);
+	double t0, t1, t2;
+	size_t i;
+
+	shuffled_keys(keys, n, 88172645463325252UL);
+	t0 = now_ns();
+	for (i = 0; i < n; i++){
+		tree.insertPool(tree.pool, &tree.root, keys[i]);
+	}
+	t1 = now_ns();
+	for (i = 0; i < n / 2; i++){
+		tree.removePool(tree.pool, &tree.root, keys[i]);
+	}
+	t2 = now_ns();
+	printf("%zu keys, %zu byte nodes: %.1f ns/insert, %.1f ns/remove\n",
+			n, sizeof(Node), (t1 - t0) / n, (t2 - t1) / (n / 2 ? n / 2 : 1));
+#ifdef AVL_ORDER_STATISTICS
+	{
+		size_t queries = n / 2, sum = 0;
+		Node * node;
+		t0 = now_ns();
+		for (i = 0; i < queries; i++){
+			sum += tree.rank(tree.root, keys[i]);
+		}
+		t1 = now_ns();
+		for (i = 0; i < queries; i++){
+			node = tree.select(tree.root, (size_t) keys[i] % (n - n / 2));
+			sum += (node != NULL)? (size_t) node->value : 0;
+		}
+		t2 = now_ns();
+		printf("%.1f ns/rank, %.1f ns/select (%zu)\n",
+				(t1 - t0) / (queries ? queries : 1), (t2 - t1) / (queries ? queries : 1), sum);
+	}
+#endif
+
+	tree.release(tree.pool, &tree.root);
+	avltree_pool_destroy(tree.pool);
+	free(keys);
+}
+
+/**
+ * Benchmark program
+ * usage: ./bench [pool|bulk|batch|inline|frozen|searchbatch|walk|range|order] [keys]
+ *        ./bench snapshot [keys] [file]
+ *
+ */
+int main(int argc, char ** argv){
+	const char * mode = (argc > 1)? argv[1] : "pool";
+	size_t n = (argc > 2)? strtoul(argv[2], NULL, 10) : 1000000;
+
+	if (strcmp(mode, "pool") == 0){
+		bench_pool(n);
+	}
+	else if (strcmp(mode, "bulk") == 0){
+		bench_bulk(n);
+	}
+	else if (strcmp(mode, "batch") == 0){
+		bench_batch(n);
+	}
+	else if (strcmp(mode, "inline") == 0){
+		bench_inline(n);
+	}
+	else if (strcmp(mode, "frozen") == 0){
+		bench_frozen(n);
+	}
+	else if (strcmp(mode, "searchbatch") == 0){
+		bench_search_batch(n);
+	}
+	else if (strcmp(mode, "snapshot") == 0){
+		bench_snapshot(n, (argc > 3)? argv[3] : "avl_tree.snapshot");
+	}
+	else if (strcmp(mode, "walk") == 0){
+		bench_walk(n);
+	}
+	else if (strcmp(mode, "range") == 0){
+		bench_range(n);
+	}
+	else if (strcmp(mode, "order") == 0){
+		bench_order(n);
+	}
+	else{
+		fprintf(stderr, "unknown benchmark %s\n", mode);
+		return 1;
+	}
+	return 0;
+}
@@ -18,6 +18,13 @@
 #include "avl_tree.h"
 #include <stdio.h>
 
+/**
+ * NodeVisitor adding the value of a node to an int.
+ */
+static void sum_node(Node * node, void * context){
+	*(int*) context += node->value;
+}
+
 /**
  * Main program 
  * Example of how to use the functions of the avl tree
@@ -25,9 +32,15 @@
  */
 int main(){
 	Node * temp;
+	itemtype sorted[] = {5, 10, 20, 30, 40, 50};
+	itemtype more[] = {1, 20, 35, 60};
 
 	AvlTree tree = avltree();
+	AvlTree bulk;
+	AvlTree other;
+	AvlCursor cursor;
 	int h = 0;
+	int sum = 0;
 
 	tree.insert(&tree.root, 5);
 	tree.insert(&tree.root, 10);
@@ -46,6 +59,16 @@ int main(){
 	tree.posOrder(tree.root); 
 	printf("\n\n");	 
 
+	printf("From 25 up\n");
+	avltree_cursor(&cursor, tree.root);
+	for(temp = avltree_cursor_seek(&cursor, 25); temp != NULL; temp = avltree_cursor_next(&cursor)){
+		printf("%d ", temp->value);
+	}
+	printf("\n\n");
+
+	tree.walk(tree.root, IN_ORDER, sum_node, &sum);
+	printf("sum: %d\n", sum);
+
 	temp = tree.search(tree.root, 11); 
 	if(temp != NULL) {
 		printf("Found element %d\n", temp->value);
@@ -58,5 +81,19 @@ int main(){
 
 	tree.delete(tree.root);
 
+	bulk = avltree_from_sorted(sorted, 6);
+	printf("Bulk Pre Order\n");
+	bulk.preOrder(bulk.root);
+	printf("\n\n");
+	bulk.delete(bulk.root);
+
+	bulk = avltree_from_sorted(sorted, 6);
+	other = avltree_from_sorted(more, 4);
+	bulk.setUnion(NULL, &bulk.root, other.root);
+	printf("Union In Order\n");
+	bulk.inOrder(bulk.root);
+	printf("\n\n");
+	bulk.delete(bulk.root);
+
 	return 0;
 }
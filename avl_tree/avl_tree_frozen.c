@@ -0,0 +1,100 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+ */
+
+#include <stdlib.h>
+
+#include "avl_tree_frozen.h"
+
+/**
+ * state of an in order walk, the ancestors still to visit on a stack.
+ */
+typedef struct {
+	const Node * stack[AVL_MAX_HEIGHT];
+	int top;
+	const Node * node;
+}InOrderWalk;
+
+/**
+ * next value of an in order walk, the context of avltree_freeze.
+ *
+ * @param void * context, an InOrderWalk.
+ *
+ * @returns the next value, the walk must not be past the last node
+ */
+static itemtype nextInOrder(void * context){
+	InOrderWalk * walk = (InOrderWalk*) context;
+	const Node * node;
+	while (walk->node != NULL){
+		walk->stack[walk->top++] = walk->node;
+		walk->node = walk->node->left;
+	}
+	node = walk->stack[--walk->top];
+	walk->node = node->right;
+	return node->value;
+}
+
+FrozenTree avltree_freeze(const Node * tree){
+	InOrderWalk walk;
+	size_t n = 0;
+
+	walk.top = 0;
+	walk.node = tree;
+	while (walk.node != NULL || walk.top > 0){
+		nextInOrder(&walk);
+		n++;
+	}
+	walk.node = tree;
+	return frozentree_build(n, nextInOrder, &walk);
+}
+
+FrozenStatus avltree_save(const Node * tree, const char * path){
+	FrozenTree frozen = avltree_freeze(tree);
+	FrozenStatus result;
+	if (tree != NULL && frozen.keys == NULL){
+		return FROZEN_ENOMEM;
+	}
+	result = frozentree_save(&frozen, path);
+	frozentree_free(&frozen);
+	return result;
+}
+
+/**
+ * The keys are copied out in order once and the tree built from them as
+ * avltree_from_sorted does, with no descent per key.
+ */
+FrozenStatus avltree_load(const char * path, AvlTree * tree){
+	FrozenTree frozen;
+	FrozenStatus result;
+	itemtype * sorted;
+
+	*tree = avltree();
+	result = frozentree_load(path, 1, &frozen);
+	if (result != FROZEN_OK){
+		return result;
+	}
+	sorted = (itemtype*) malloc((frozen.n + 1) * sizeof(itemtype));
+	if (sorted == NULL){
+		frozentree_free(&frozen);
+		return FROZEN_ENOMEM;
+	}
+	frozentree_to_sorted(&frozen, sorted);
+	*tree = avltree_from_sorted(sorted, frozen.n);
+	result = (tree->root == NULL && frozen.n > 0)? FROZEN_ENOMEM : FROZEN_OK;
+	free(sorted);
+	frozentree_free(&frozen);
+	return result;
+}
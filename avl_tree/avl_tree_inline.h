@@ -0,0 +1,317 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+ */
+
+/**
+ * INLINE READ PATH.
+ *
+ * static inline versions of the read-only operations of avl_tree.c. A call
+ * through AvlTree goes through a function pointer the compiler cannot see
+ * past; these are expanded into the caller, so a lookup loop keeps its
+ * keys and nodes in registers across iterations. AvlTree.search and
+ * AvlTree.height are thin wrappers over avl_search and avl_height.
+ *
+ */
+#ifndef AVL_TREE_INLINE_H
+#define AVL_TREE_INLINE_H
+
+#include "avl_tree.h"
+
+/**
+ * Search elements in avl tree.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, value to searched.
+ *
+ * @returns Node type pointer, Node referring to found element, NULL if absent.
+ */
+static inline Node * avl_search(Node * tree, itemtype value){
+   while (tree != NULL && value != tree->value){
+      tree = (value < tree->value)? tree->left : tree->right;
+   }
+   return tree;
+}
+
+/**
+ * check if a value is in the avl tree.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, value to searched.
+ *
+ * @returns true if the value is in the tree
+ */
+static inline bool avl_contains(Node * tree, itemtype value){
+   return (avl_search(tree, value) != NULL)? true : false;
+}
+
+/**
+ * get height of avl tree.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ *
+ * @returns a integer type, is the height of tree, 0 if empty
+ */
+static inline int avl_height(Node * tree){
+   return (tree == NULL)? 0 : tree->height;
+}
+
+/**
+ * node holding the lowest value.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ *
+ * @returns Node type pointer, NULL if the tree is empty.
+ */
+static inline Node * avl_min(Node * tree){
+   if (tree != NULL){
+      while (tree->left != NULL){
+         tree = tree->left;
+      }
+   }
+   return tree;
+}
+
+/**
+ * node holding the highest value.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ *
+ * @returns Node type pointer, NULL if the tree is empty.
+ */
+static inline Node * avl_max(Node * tree){
+   if (tree != NULL){
+      while (tree->right != NULL){
+         tree = tree->right;
+      }
+   }
+   return tree;
+}
+
+/**
+ * node holding the lowest value not lower than value.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns Node type pointer, NULL if every value is lower.
+ */
+static inline Node * avl_lower_bound(Node * tree, itemtype value){
+   Node * result = NULL;
+   while (tree != NULL){
+      if (tree->value < value){
+         tree = tree->right;
+      }
+      else{
+         result = tree;
+         tree = tree->left;
+      }
+   }
+   return result;
+}
+
+/**
+ * node holding the lowest value greater than value.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns Node type pointer, NULL if no value is greater.
+ */
+static inline Node * avl_upper_bound(Node * tree, itemtype value){
+   Node * result = NULL;
+   while (tree != NULL){
+      if (tree->value <= value){
+         tree = tree->right;
+      }
+      else{
+         result = tree;
+         tree = tree->left;
+      }
+   }
+   return result;
+}
+
+/**
+ * node holding the highest value not greater than value.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns Node type pointer, NULL if every value is greater.
+ */
+static inline Node * avl_floor(Node * tree, itemtype value){
+   Node * result = NULL;
+   while (tree != NULL){
+      if (value < tree->value){
+         tree = tree->left;
+      }
+      else{
+         result = tree;
+         tree = tree->right;
+      }
+   }
+   return result;
+}
+
+/**
+ * node holding the lowest value not lower than value, the same node as
+ * avl_lower_bound.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns Node type pointer, NULL if every value is lower.
+ */
+static inline Node * avl_ceil(Node * tree, itemtype value){
+   return avl_lower_bound(tree, value);
+}
+
+#ifdef AVL_ORDER_STATISTICS
+/**
+ * number of nodes of avl tree.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ *
+ * @returns the number of nodes, 0 if empty
+ */
+static inline size_t avl_size(Node * tree){
+   return (tree == NULL)? 0 : tree->size;
+}
+
+/**
+ * number of values lower than value, its position once the tree is sorted.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the value ranked, need not be in the tree.
+ *
+ * @returns the number of values lower than value
+ */
+static inline size_t avl_rank(Node * tree, itemtype value){
+   size_t rank = 0;
+   while (tree != NULL){
+      if (tree->value < value){
+         rank += avl_size(tree->left) + 1;
+         tree = tree->right;
+      }
+      else{
+         tree = tree->left;
+      }
+   }
+   return rank;
+}
+
+/**
+ * node holding the k-th lowest value, counting from 0.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param size_t k, position of the value.
+ *
+ * @returns Node type pointer, NULL if k is not lower than the size.
+ */
+static inline Node * avl_select(Node * tree, size_t k){
+   size_t left;
+   while (tree != NULL){
+      left = avl_size(tree->left);
+      if (k == left){
+         return tree;
+      }
+      if (k < left){
+         tree = tree->left;
+      }
+      else{
+         k -= left + 1;
+         tree = tree->right;
+      }
+   }
+   return NULL;
+}
+
+/**
+ * number of values in [lo, hi).
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype lo, lowest value counted.
+ * @param itemtype hi, first value not counted.
+ *
+ * @returns the number of values in range, 0 if hi is not greater than lo
+ */
+static inline size_t avl_count_range(Node * tree, itemtype lo, itemtype hi){
+   size_t below_hi, below_lo;
+   if (!(lo < hi)){
+      return 0;
+   }
+   below_hi = avl_rank(tree, hi);
+   below_lo = avl_rank(tree, lo);
+   return below_hi - below_lo;
+}
+#endif
+
+/**
+ * Lookups advanced together by avl_search_batch. Each round moves every
+ * lookup of the group one level down, so up to this many cache misses are
+ * in flight at once. Can be set with -DAVL_BATCH_GROUP=n.
+ */
+#ifndef AVL_BATCH_GROUP
+#define AVL_BATCH_GROUP 16
+#endif
+
+/**
+ * Search many elements in avl tree at once. The lookups of a group go
+ * down the tree in lockstep, each one prefetching the child it moves to,
+ * so the misses of different lookups overlap instead of queuing one behind
+ * the other.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param const itemtype * values, the values to search.
+ * @param size_t n, number of values.
+ * @param Node ** out, receives the node of each value, NULL if absent.
+ */
+static inline void avl_search_batch(Node * tree, const itemtype * values, size_t n, Node ** out){
+   Node * cursor[AVL_BATCH_GROUP];
+   Node * node;
+   size_t base, i, group;
+   int active;
+
+   for (base = 0; base < n; base += group){
+      group = (n - base < AVL_BATCH_GROUP)? n - base : AVL_BATCH_GROUP;
+      for (i = 0; i < group; i++){
+         cursor[i] = tree;
+         out[base + i] = NULL;
+      }
+      do{
+         active = 0;
+         for (i = 0; i < group; i++){
+            node = cursor[i];
+            if (node == NULL){
+               continue;
+            }
+            if (values[base + i] == node->value){
+               out[base + i] = node;
+               cursor[i] = NULL;
+               continue;
+            }
+            node = (values[base + i] < node->value)? node->left : node->right;
+            if (node != NULL){
+               __builtin_prefetch(node);
+               active++;
+            }
+            cursor[i] = node;
+         }
+      } while (active > 0);
+   }
+}
+
+#endif
@@ -0,0 +1,331 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include <stdlib.h>
+
+#include "avl_tree_parallel.h"
+#include "avl_tree_inline.h"
+
+typedef enum {UNION, INTERSECTION, DIFFERENCE} SetOperation;
+
+/**
+ * nodes left out of a result, linked through left. Lists of forked
+ * halves are spliced together in O(1) through the tail.
+ */
+typedef struct {
+	Node * head;
+	Node * tail;
+}Dropped;
+
+/**
+ * one combination of two trees, forked or not.
+ */
+typedef struct {
+	ForkJoinPool * workers;
+	SetOperation operation;
+	Node * tree;
+	Node * other;
+	Node * result;
+	Dropped dropped;
+}SetTask;
+
+/**
+ * leave a node out of the result.
+ *
+ * @param Dropped * dropped, the list.
+ * @param Node * node, the node.
+ */
+static void dropNode(Dropped * dropped, Node * node){
+	node->left = dropped->head;
+	dropped->head = node;
+	if (dropped->tail == NULL){
+		dropped->tail = node;
+	}
+}
+
+/**
+ * leave every node of a tree out of the result.
+ *
+ * @param Dropped * dropped, the list.
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ */
+static void dropTree(Dropped * dropped, Node * tree){
+	Node * right;
+	if (tree != NULL){
+		right = tree->right;
+		dropTree(dropped, tree->left);
+		dropTree(dropped, right);
+		dropNode(dropped, tree);
+	}
+}
+
+/**
+ * append one list to another.
+ *
+ * @param Dropped * into, the list that grows.
+ * @param Dropped * from, the list appended.
+ */
+static void splice(Dropped * into, Dropped * from){
+	if (from->head == NULL){
+		return;
+	}
+	from->tail->left = into->head;
+	into->head = from->head;
+	if (into->tail == NULL){
+		into->tail = from->tail;
+	}
+}
+
+static void runTask(void * argument);
+
+/**
+ * combine two trees: split the other tree at the root of the tree,
+ * combine the lower halves and the greater halves, forking the lower ones
+ * when both trees there are large, and join the results through the root
+ * if it stays.
+ *
+ * @param ForkJoinPool * workers, the threads, NULL to run on the caller only.
+ * @param SetOperation operation, what to compute.
+ * @param Node * tree, the root of the first tree.
+ * @param Node * other, the root of the second tree.
+ * @param Dropped * dropped, receives the nodes left out.
+ *
+ * @returns the root of the result.
+ */
+static Node * combine(ForkJoinPool * workers, SetOperation operation, Node * tree, Node * other, Dropped * dropped){
+	Node * found;
+	Node * left;
+	Node * right;
+	Node * high;
+	Node * high_other;
+	SetTask low;
+	ForkJoinJob job;
+
+	if (tree == NULL || other == NULL){
+		if (operation == UNION){
+			return (tree != NULL)? tree : other;
+		}
+		dropTree(dropped, other);
+		if (operation == INTERSECTION){
+			dropTree(dropped, tree);
+			return NULL;
+		}
+		return tree;
+	}
+	found = avltree_split(other, tree->value, &low.other, &high_other);
+	low.tree = tree->left;
+	high = tree->right;
+
+	if (workers != NULL && avl_height(low.tree) >= AVL_PARALLEL_HEIGHT
+			&& avl_height(low.other) >= AVL_PARALLEL_HEIGHT){
+		low.workers = workers;
+		low.operation = operation;
+		low.dropped.head = low.dropped.tail = NULL;
+		forkjoin_fork(workers, &job, runTask, &low);
+		right = combine(workers, operation, high, high_other, dropped);
+		forkjoin_join(workers, &job);
+		splice(dropped, &low.dropped);
+		left = low.result;
+	}
+	else{
+		left = combine(workers, operation, low.tree, low.other, dropped);
+		right = combine(workers, operation, high, high_other, dropped);
+	}
+
+	if (found != NULL){
+		dropNode(dropped, found);
+	}
+	if (operation == UNION || (operation == INTERSECTION) == (found != NULL)){
+		return avltree_join(left, tree, right);
+	}
+	dropNode(dropped, tree);
+	return avltree_join(left, NULL, right);
+}
+
+/**
+ * body of a forked combination.
+ *
+ * @param void * argument, the SetTask.
+ */
+static void runTask(void * argument){
+	SetTask * task = (SetTask*) argument;
+	task->result = combine(task->workers, task->operation, task->tree, task->other, &task->dropped);
+}
+
+/**
+ * run a set operation and give the dropped nodes back.
+ *
+ * @param ForkJoinPool * workers, the threads, NULL to run on the caller only.
+ * @param NodePool * pool, the pool of both trees, NULL if nodes came from calloc.
+ * @param SetOperation operation, what to compute.
+ * @param Node ** tree, the root of the tree, receives the result.
+ * @param Node * other, the root of the other tree.
+ */
+static void setOperation(ForkJoinPool * workers, NodePool * pool, SetOperation operation, Node ** tree, Node * other){
+	AvlTree ops;
+	Dropped dropped;
+	if (workers == NULL || workers->workers == 0){
+		/* nothing to fork to, the sequential versions in avl_tree.c
+		 * inline split and join into their recursion */
+		ops = avltree();
+		if (operation == UNION){
+			ops.setUnion(pool, tree, other);
+		}
+		else if (operation == INTERSECTION){
+			ops.setIntersection(pool, tree, other);
+		}
+		else{
+			ops.setDifference(pool, tree, other);
+		}
+		return;
+	}
+	dropped.head = dropped.tail = NULL;
+	*tree = combine(workers, operation, *tree, other, &dropped);
+	avltree_free_nodes(pool, dropped.head);
+}
+
+void avltree_union_parallel(ForkJoinPool * workers, NodePool * pool, Node ** tree, Node * other){
+	setOperation(workers, pool, UNION, tree, other);
+}
+
+void avltree_intersection_parallel(ForkJoinPool * workers, NodePool * pool, Node ** tree, Node * other){
+	setOperation(workers, pool, INTERSECTION, tree, other);
+}
+
+void avltree_difference_parallel(ForkJoinPool * workers, NodePool * pool, Node ** tree, Node * other){
+	setOperation(workers, pool, DIFFERENCE, tree, other);
+}
+
+/**
+ * one fold of a subtree, forked or not.
+ */
+typedef struct {
+	ForkJoinPool * workers;
+	Node * tree;
+	NodeVisitor visit;
+	size_t size;
+	FoldInit init;
+	FoldMerge merge;
+	void * accumulator;
+}FoldTask;
+
+static void runFold(void * argument);
+
+/**
+ * fold a subtree: below AVL_PARALLEL_HEIGHT walk it, above fork the
+ * right subtree into an accumulator of its own, fold the left one and
+ * the node here and merge.
+ *
+ * @param FoldTask * task, the subtree and the accumulator.
+ */
+static void fold(FoldTask * task){
+	AvlTree ops;
+	FoldTask right;
+	ForkJoinJob job;
+	Node * tree = task->tree;
+
+	if (task->workers == NULL || avl_height(tree) < AVL_PARALLEL_HEIGHT){
+		ops = avltree();
+		ops.walk(tree, IN_ORDER, task->visit, task->accumulator);
+		return;
+	}
+	right = *task;
+	right.tree = tree->right;
+	if (task->size > 0){
+		right.accumulator = malloc(task->size);
+		if (right.accumulator == NULL){
+			task->workers = NULL;
+			fold(task);
+			return;
+		}
+		task->init(right.accumulator);
+	}
+	forkjoin_fork(task->workers, &job, runFold, &right);
+	task->tree = tree->left;
+	fold(task);
+	task->visit(tree, task->accumulator);
+	forkjoin_join(task->workers, &job);
+	if (task->size > 0){
+		task->merge(task->accumulator, right.accumulator);
+		free(right.accumulator);
+	}
+}
+
+/**
+ * body of a forked fold.
+ *
+ * @param void * argument, the FoldTask.
+ */
+static void runFold(void * argument){
+	fold((FoldTask*) argument);
+}
+
+void avltree_fold_parallel(ForkJoinPool * workers, Node * tree, NodeVisitor visit, size_t size, FoldInit init, FoldMerge merge, void * accumulator){
+	FoldTask task;
+	task.workers = (workers != NULL && workers->workers > 0)? workers : NULL;
+	task.tree = tree;
+	task.visit = visit;
+	task.size = size;
+	task.init = init;
+	task.merge = merge;
+	task.accumulator = accumulator;
+	fold(&task);
+}
+
+/**
+ * free a node, the walk visitor of the sequential teardown.
+ *
+ * @param Node * node, the node.
+ * @param void * context, unused.
+ */
+static void freeVisited(Node * node, void * context){
+	(void) context;
+	free(node);
+}
+
+/**
+ * free a subtree, forking the right subtree of nodes high enough.
+ *
+ * @param void * argument, the FoldTask, only workers and tree are used.
+ */
+static void teardown(void * argument){
+	FoldTask * task = (FoldTask*) argument;
+	FoldTask right;
+	ForkJoinJob job;
+	Node * tree = task->tree;
+	AvlTree ops;
+
+	if (task->workers == NULL || avl_height(tree) < AVL_PARALLEL_HEIGHT){
+		ops = avltree();
+		ops.walk(tree, POS_ORDER, freeVisited, NULL);
+		return;
+	}
+	right.workers = task->workers;
+	right.tree = tree->right;
+	forkjoin_fork(task->workers, &job, teardown, &right);
+	task->tree = tree->left;
+	teardown(task);
+	forkjoin_join(task->workers, &job);
+	free(tree);
+}
+
+void avltree_delete_parallel(ForkJoinPool * workers, Node * tree){
+	FoldTask task;
+	task.workers = (workers != NULL && workers->workers > 0)? workers : NULL;
+	task.tree = tree;
+	teardown(&task);
+}
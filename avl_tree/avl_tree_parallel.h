@@ -0,0 +1,116 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+/**
+ * PARALLEL OPERATIONS ON AVL TREES.
+ *
+ * Union, intersection and difference of AvlTrees built on avltree_split
+ * and avltree_join, after Blelloch, Ferizovic and Sun, "Just Join for
+ * Parallel Ordered Sets" (SPAA 2016): one tree is split at the root of
+ * the other and the two halves are combined independently, forked to a
+ * ForkJoinPool of ../fork_join while both are large.
+ *
+ * Folds and teardown of a whole tree the same way: the right subtree of
+ * every node high enough is forked, lower subtrees are walked where they
+ * are.
+ *
+ */
+#ifndef AVL_TREE_PARALLEL_H
+#define AVL_TREE_PARALLEL_H
+
+#include "avl_tree.h"
+#include "../fork_join/fork_join.h"
+
+/**
+ * Halves are forked while both trees of one are at least this high,
+ * smaller ones are combined where they are.
+ */
+#define AVL_PARALLEL_HEIGHT 12
+
+/**
+ * Start of an accumulator, see avltree_fold_parallel.
+ */
+typedef void (*FoldInit)(void * accumulator);
+
+/**
+ * Add to an accumulator what another gathered over the values right of
+ * it, see avltree_fold_parallel.
+ */
+typedef void (*FoldMerge)(void * accumulator, void * other);
+
+/**
+ * tree.setUnion forking to a pool. The other tree is consumed, nodes of
+ * values in both go back to the node pool once the union is built.
+ *
+ * @param ForkJoinPool * workers, the threads, NULL to run on the caller only.
+ * @param NodePool * pool, the pool of both trees, NULL if nodes came from calloc.
+ * @param Node ** tree, the root of the tree, receives the union.
+ * @param Node * other, the root of the other tree.
+ */
+void avltree_union_parallel(ForkJoinPool * workers, NodePool * pool, Node ** tree, Node * other);
+
+/**
+ * tree.setIntersection forking to a pool. The other tree is consumed,
+ * nodes left out go back to the node pool once the result is built.
+ *
+ * @param ForkJoinPool * workers, the threads, NULL to run on the caller only.
+ * @param NodePool * pool, the pool of both trees, NULL if nodes came from calloc.
+ * @param Node ** tree, the root of the tree, receives the intersection.
+ * @param Node * other, the root of the other tree.
+ */
+void avltree_intersection_parallel(ForkJoinPool * workers, NodePool * pool, Node ** tree, Node * other);
+
+/**
+ * tree.setDifference forking to a pool. The other tree is consumed,
+ * nodes left out go back to the node pool once the result is built.
+ *
+ * @param ForkJoinPool * workers, the threads, NULL to run on the caller only.
+ * @param NodePool * pool, the pool of both trees, NULL if nodes came from calloc.
+ * @param Node ** tree, the root of the tree, receives the difference.
+ * @param Node * other, the root of the other tree.
+ */
+void avltree_difference_parallel(ForkJoinPool * workers, NodePool * pool, Node ** tree, Node * other);
+
+/**
+ * fold a tree in ascending order into an accumulator, forking subtrees.
+ * visit(node, accumulator) is called once per node; a forked subtree is
+ * folded into an accumulator of its own, size bytes started with init,
+ * then merged into the one of the values left of it, so visit and merge
+ * only need to be associative. With size 0 there is no accumulator of
+ * its own: every visit gets the accumulator given, possibly from several
+ * threads at once, and init and merge are not used.
+ *
+ * @param ForkJoinPool * workers, the threads, NULL to run on the caller only.
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param NodeVisitor visit, called once per node.
+ * @param size_t size, bytes of an accumulator, 0 for none.
+ * @param FoldInit init, starts an accumulator.
+ * @param FoldMerge merge, adds the second accumulator to the first.
+ * @param void * accumulator, the result, started by the caller.
+ */
+void avltree_fold_parallel(ForkJoinPool * workers, Node * tree, NodeVisitor visit, size_t size, FoldInit init, FoldMerge merge, void * accumulator);
+
+/**
+ * tree.delete freeing subtrees on several threads, for trees whose nodes
+ * came from calloc; a pooled tree is released at once by tree.release.
+ *
+ * @param ForkJoinPool * workers, the threads, NULL to run on the caller only.
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ */
+void avltree_delete_parallel(ForkJoinPool * workers, Node * tree);
+
+#endif
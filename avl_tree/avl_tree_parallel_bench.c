@@ -0,0 +1,351 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "avl_tree_parallel.h"
+#include "avl_tree_inline.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/**
+ * Each time printed is the best of RUNS.
+ */
+#define RUNS 3
+
+/**
+ * monotonic clock in nanoseconds
+ *
+ * @returns the current time in nanoseconds
+ */
+static double now_ns(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * fill keys with random values in [0, range)
+ *
+ * @param itemtype * keys, the buffer to fill.
+ * @param size_t n, number of keys.
+ * @param size_t range, bound of the values.
+ * @param unsigned long seed, seed of the xorshift generator.
+ */
+static void random_keys(itemtype * keys, size_t n, size_t range, unsigned long seed){
+	size_t i;
+	for (i = 0; i < n; i++){
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		keys[i] = (itemtype) ((seed >> 32) % range);
+	}
+}
+
+/**
+ * the two inputs of one measure, rebuilt before each as the operations
+ * consume them.
+ */
+typedef struct {
+	itemtype * a;
+	itemtype * b;
+	size_t n;
+	size_t m;
+	itemtype * scratch;
+	NodePool * pool;
+	Node * tree;
+	Node * other;
+}Inputs;
+
+/**
+ * build both trees of the inputs in a fresh node pool.
+ *
+ * @param Inputs * in, the inputs.
+ */
+static void build(Inputs * in){
+	AvlTree ops = avltree();
+	in->pool = avltree_pool_create(0);
+	in->tree = NULL;
+	in->other = NULL;
+	memcpy(in->scratch, in->a, in->n * sizeof(itemtype));
+	ops.insertBatch(in->pool, &in->tree, in->scratch, in->n);
+	memcpy(in->scratch, in->b, in->m * sizeof(itemtype));
+	ops.insertBatch(in->pool, &in->other, in->scratch, in->m);
+}
+
+/**
+ * collecting visitor of the per key loops, the context is an array
+ * cursor.
+ */
+static void collect(Node * node, void * context){
+	*(*(itemtype**) context)++ = node->value;
+}
+
+/**
+ * visitor linking the nodes of a dead tree through left, for
+ * avltree_free_nodes.
+ */
+static void drop(Node * node, void * context){
+	node->left = *(Node**) context;
+	*(Node**) context = node;
+}
+
+/**
+ * what the operation costs done one key at a time: walk the other tree
+ * and insert or remove each key, or for the intersection search each key
+ * and insert it into a new tree, then give the old one back.
+ *
+ * @param Inputs * in, the inputs.
+ * @param int operation, 0 union, 1 intersection, 2 difference.
+ *
+ * @returns the time taken in ms
+ */
+static double per_key(Inputs * in, int operation){
+	AvlTree ops = avltree();
+	itemtype * cursor = in->scratch;
+	Node * result = NULL;
+	Node * dropped;
+	size_t i, k;
+	double t0, t1;
+
+	build(in);
+	t0 = now_ns();
+	ops.walk(in->other, IN_ORDER, collect, &cursor);
+	k = cursor - in->scratch;
+	for (i = 0; i < k; i++){
+		if (operation == 0){
+			ops.insertPool(in->pool, &in->tree, in->scratch[i]);
+		}
+		else if (operation == 1){
+			if (avl_search(in->tree, in->scratch[i]) != NULL){
+				ops.insertPool(in->pool, &result, in->scratch[i]);
+			}
+		}
+		else{
+			ops.removePool(in->pool, &in->tree, in->scratch[i]);
+		}
+	}
+	if (operation == 1){
+		dropped = NULL;
+		ops.walk(in->tree, POS_ORDER, drop, &dropped);
+		avltree_free_nodes(in->pool, dropped);
+		in->tree = result;
+	}
+	t1 = now_ns();
+	avltree_pool_destroy(in->pool);
+	return (t1 - t0) / 1e6;
+}
+
+/**
+ * time a join based operation.
+ *
+ * @param Inputs * in, the inputs.
+ * @param int operation, 0 union, 1 intersection, 2 difference.
+ * @param ForkJoinPool * workers, the threads, NULL for tree.setUnion and the others.
+ *
+ * @returns the time taken in ms
+ */
+static double joined(Inputs * in, int operation, ForkJoinPool * workers){
+	AvlTree ops = avltree();
+	double t0, t1;
+
+	build(in);
+	t0 = now_ns();
+	if (workers == NULL){
+		if (operation == 0){
+			ops.setUnion(in->pool, &in->tree, in->other);
+		}
+		else if (operation == 1){
+			ops.setIntersection(in->pool, &in->tree, in->other);
+		}
+		else{
+			ops.setDifference(in->pool, &in->tree, in->other);
+		}
+	}
+	else if (operation == 0){
+		avltree_union_parallel(workers, in->pool, &in->tree, in->other);
+	}
+	else if (operation == 1){
+		avltree_intersection_parallel(workers, in->pool, &in->tree, in->other);
+	}
+	else{
+		avltree_difference_parallel(workers, in->pool, &in->tree, in->other);
+	}
+	t1 = now_ns();
+	avltree_pool_destroy(in->pool);
+	return (t1 - t0) / 1e6;
+}
+
+/**
+ * for union, intersection and difference of two random trees print the
+ * time of the per key loop, of the sequential join based operation and
+ * of the parallel one on 1, 2, 4 ... up to max threads.
+ *
+ * @param size_t n, keys of the first tree.
+ * @param size_t m, keys of the other tree.
+ * @param int max_threads, the most threads tried.
+ */
+static void bench_setops(size_t n, size_t m, int max_threads){
+	static const char * names[] = {"union", "intersection", "difference"};
+	Inputs in;
+	ForkJoinPool * workers;
+	double best[2];
+	int operation, threads, run;
+
+	in.n = n;
+	in.m = m;
+	in.a = malloc(in.n * sizeof(itemtype));
+	in.b = malloc(in.m * sizeof(itemtype));
+	in.scratch = malloc((in.n > in.m ? in.n : in.m) * sizeof(itemtype));
+	random_keys(in.a, in.n, 2 * in.n, 88172645463325252UL);
+	random_keys(in.b, in.m, 2 * in.n, 2463534242UL);
+
+	printf("%zu and %zu random keys in [0, %zu), best of %d runs\n", in.n, in.m, 2 * in.n, RUNS);
+	for (operation = 0; operation < 3; operation++){
+		best[0] = best[1] = 1e300;
+		for (run = 0; run < RUNS; run++){
+			best[0] = fmin(best[0], per_key(&in, operation));
+			best[1] = fmin(best[1], joined(&in, operation, NULL));
+		}
+		printf("%-12s  per key %7.1f ms   joined %7.1f ms", names[operation], best[0], best[1]);
+		for (threads = 1; threads <= max_threads; threads *= 2){
+			workers = forkjoin_create(threads - 1);
+			best[0] = 1e300;
+			for (run = 0; run < RUNS; run++){
+				best[0] = fmin(best[0], joined(&in, operation, workers));
+			}
+			printf("   %d: %.1f ms", threads, best[0]);
+			forkjoin_destroy(workers);
+		}
+		printf("\n");
+		fflush(stdout);
+	}
+	free(in.a);
+	free(in.b);
+	free(in.scratch);
+}
+
+/**
+ * fold visitor of the sums, the accumulator is a long long.
+ */
+static void sum(Node * node, void * accumulator){
+	*(long long*) accumulator += node->value;
+}
+
+/**
+ * FoldInit of the sums.
+ */
+static void sum_init(void * accumulator){
+	*(long long*) accumulator = 0;
+}
+
+/**
+ * FoldMerge of the sums.
+ */
+static void sum_merge(void * accumulator, void * other){
+	*(long long*) accumulator += *(long long*) other;
+}
+
+/**
+ * sum the values of a tree of n random keys and tear it down, with
+ * tree.walk and tree.delete against avltree_fold_parallel and
+ * avltree_delete_parallel on 1, 2, 4 ... up to max threads. The tree
+ * comes from calloc, as tree.delete needs.
+ *
+ * @param size_t n, number of keys.
+ * @param int max_threads, the most threads tried.
+ */
+static void bench_fold(size_t n, int max_threads){
+	AvlTree ops = avltree();
+	itemtype * keys = malloc(n * sizeof(itemtype));
+	ForkJoinPool * workers;
+	Node * tree;
+	long long total, check = 0;
+	double best[2], t0, t1;
+	int threads, run;
+
+	random_keys(keys, n, 2 * n, 88172645463325252UL);
+	printf("%zu random keys in [0, %zu), best of %d runs\n", n, 2 * n, RUNS);
+	for (threads = 0; threads <= max_threads; threads = threads ? 2 * threads : 1){
+		workers = threads ? forkjoin_create(threads - 1) : NULL;
+		best[0] = best[1] = 1e300;
+		for (run = 0; run < RUNS; run++){
+			tree = NULL;
+			ops.insertBatch(NULL, &tree, keys, n);
+			total = 0;
+			t0 = now_ns();
+			if (workers == NULL){
+				ops.walk(tree, IN_ORDER, sum, &total);
+			}
+			else{
+				avltree_fold_parallel(workers, tree, sum, sizeof(total), sum_init, sum_merge, &total);
+			}
+			t1 = now_ns();
+			best[0] = fmin(best[0], (t1 - t0) / 1e6);
+			if (threads == 0 && run == 0){
+				check = total;
+			}
+			else if (total != check){
+				fprintf(stderr, "sum %lld, expected %lld\n", total, check);
+			}
+			t0 = now_ns();
+			if (workers == NULL){
+				ops.delete(tree);
+			}
+			else{
+				avltree_delete_parallel(workers, tree);
+			}
+			t1 = now_ns();
+			best[1] = fmin(best[1], (t1 - t0) / 1e6);
+		}
+		if (workers == NULL){
+			printf("walk     sum %7.1f ms   delete          %7.1f ms\n", best[0], best[1]);
+		}
+		else{
+			printf("%2d: fold sum %7.1f ms   delete_parallel %7.1f ms\n", threads, best[0], best[1]);
+			forkjoin_destroy(workers);
+		}
+		fflush(stdout);
+	}
+	free(keys);
+}
+
+/**
+ * Benchmark program
+ * usage: ./parallel setops [keys] [keys of the other tree] [max threads]
+ *        ./parallel fold [keys] [max threads]
+ *
+ */
+int main(int argc, char ** argv){
+	const char * mode = (argc > 1)? argv[1] : "setops";
+	size_t n = (argc > 2)? strtoul(argv[2], NULL, 10) : 4000000;
+
+	if (strcmp(mode, "setops") == 0){
+		bench_setops(n, (argc > 3)? strtoul(argv[3], NULL, 10) : n, (argc > 4)? atoi(argv[4]) : 8);
+	}
+	else if (strcmp(mode, "fold") == 0){
+		bench_fold(n, (argc > 3)? atoi(argv[3]) : 8);
+	}
+	else{
+		fprintf(stderr, "unknown benchmark %s\n", mode);
+		return 1;
+	}
+	return 0;
+}
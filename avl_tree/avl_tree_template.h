@@ -0,0 +1,211 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+ */
+
+/**
+ * AVL TREE TEMPLATE.
+ *
+ * AVL_DEFINE(name, key_t, cmp) generates an avl tree specialized for one
+ * key type: a name_node type and static inline functions name_insert,
+ * name_search, name_remove, name_height, name_walk and name_delete.
+ * cmp(a, b) is a function or macro returning a negative, zero or positive
+ * int as a is lower, equal or greater than b; it is called directly, so
+ * the compiler inlines it into every descent.
+ *
+ * Every instantiation has its own names, so several key types can live in
+ * the same program next to AvlTree.
+ *
+ *    AVL_DEFINE(ids, uint64_t, AVL_CMP_SCALAR)
+ *
+ *    ids_node * root = NULL;
+ *    ids_insert(&root, 42);
+ *    if(ids_search(root, 42) != NULL) ...
+ *    ids_delete(root);
+ */
+#ifndef AVL_TREE_TEMPLATE_H
+#define AVL_TREE_TEMPLATE_H
+
+#include <stdlib.h>
+
+#ifndef AVL_MAX_HEIGHT
+#define AVL_MAX_HEIGHT 96
+#endif
+
+/**
+ * comparison of any type ordered by < and >
+ */
+#define AVL_CMP_SCALAR(a, b) (((a) > (b)) - ((a) < (b)))
+
+#define AVL_DEFINE(name, key_t, cmp)                                           \
+                                                                               \
+typedef struct name##_node {                                                   \
+   key_t value;                                                                \
+   struct name##_node * left;                                                  \
+   struct name##_node * right;                                                 \
+   int height;                                                                 \
+}name##_node;                                                                  \
+                                                                               \
+/* height of a subtree, 0 when empty */                                        \
+static inline int name##_height(name##_node * tree){                          \
+   return (tree == NULL)? 0 : tree->height;                                    \
+}                                                                              \
+                                                                               \
+/* recompute the height of a node from its children */                         \
+static inline void name##_fix_height(name##_node * tree){                     \
+   int left = name##_height(tree->left);                                       \
+   int right = name##_height(tree->right);                                     \
+   tree->height = 1 + ((left > right)? left : right);                          \
+}                                                                              \
+                                                                               \
+static inline void name##_right_rotate(name##_node ** tree){                  \
+   name##_node * tree_balance = (*tree)->left;                                 \
+   (*tree)->left = tree_balance->right;                                        \
+   tree_balance->right = *tree;                                                \
+   name##_fix_height(*tree);                                                   \
+   name##_fix_height(tree_balance);                                            \
+   *tree = tree_balance;                                                       \
+}                                                                              \
+                                                                               \
+static inline void name##_left_rotate(name##_node ** tree){                   \
+   name##_node * tree_balance = (*tree)->right;                                \
+   (*tree)->right = tree_balance->left;                                        \
+   tree_balance->left = *tree;                                                 \
+   name##_fix_height(*tree);                                                   \
+   name##_fix_height(tree_balance);                                            \
+   *tree = tree_balance;                                                       \
+}                                                                              \
+                                                                               \
+/* restore the avl property of a node whose children changed */                \
+static inline void name##_rebalance(name##_node ** tree){                     \
+   int balance;                                                                \
+   name##_fix_height(*tree);                                                   \
+   balance = name##_height((*tree)->left) - name##_height((*tree)->right);     \
+   if(balance > 1){                                                            \
+      if(name##_height((*tree)->left->left) <                                  \
+            name##_height((*tree)->left->right)){                              \
+         name##_left_rotate(&(*tree)->left);                                   \
+      }                                                                        \
+      name##_right_rotate(tree);                                               \
+   }                                                                           \
+   else if(balance < -1){                                                      \
+      if(name##_height((*tree)->right->right) <                                \
+            name##_height((*tree)->right->left)){                              \
+         name##_right_rotate(&(*tree)->right);                                 \
+      }                                                                        \
+      name##_left_rotate(tree);                                                \
+   }                                                                           \
+}                                                                              \
+                                                                               \
+/* rebalance a recorded path bottom up until a height stops changing */        \
+static inline void name##_rebalance_path(name##_node ** path[], int top){     \
+   int old;                                                                    \
+   while(top > 0){                                                             \
+      old = (*path[--top])->height;                                            \
+      name##_rebalance(path[top]);                                             \
+      if((*path[top])->height == old){                                         \
+         return;                                                               \
+      }                                                                        \
+   }                                                                           \
+}                                                                              \
+                                                                               \
+/* node holding value, NULL if absent */                                       \
+static inline name##_node * name##_search(name##_node * tree, key_t value){   \
+   int c;                                                                      \
+   while(tree != NULL && (c = cmp(value, tree->value)) != 0){                  \
+      tree = (c < 0)? tree->left : tree->right;                                \
+   }                                                                           \
+   return tree;                                                                \
+}                                                                              \
+                                                                               \
+/* insert value, 1 if inserted, 0 if present or out of memory */               \
+static inline int name##_insert(name##_node ** tree, key_t value){            \
+   name##_node ** path[AVL_MAX_HEIGHT];                                        \
+   int top = 0, c;                                                             \
+   while(*tree != NULL){                                                       \
+      if((c = cmp(value, (*tree)->value)) == 0){                               \
+         return 0;                                                             \
+      }                                                                        \
+      path[top++] = tree;                                                      \
+      tree = (c < 0)? &(*tree)->left : &(*tree)->right;                        \
+   }                                                                           \
+   *tree = (name##_node*) malloc(sizeof(name##_node));                         \
+   if(*tree == NULL){                                                          \
+      return 0;                                                                \
+   }                                                                           \
+   (*tree)->value = value;                                                     \
+   (*tree)->left = NULL;                                                       \
+   (*tree)->right = NULL;                                                      \
+   (*tree)->height = 1;                                                        \
+   name##_rebalance_path(path, top);                                           \
+   return 1;                                                                   \
+}                                                                              \
+                                                                               \
+/* remove value, 1 if removed, 0 if absent */                                  \
+static inline int name##_remove(name##_node ** tree, key_t value){            \
+   name##_node ** path[AVL_MAX_HEIGHT];                                        \
+   name##_node * found;                                                        \
+   name##_node * temp;                                                         \
+   int top = 0, c;                                                             \
+   while(*tree != NULL && (c = cmp(value, (*tree)->value)) != 0){              \
+      path[top++] = tree;                                                      \
+      tree = (c < 0)? &(*tree)->left : &(*tree)->right;                        \
+   }                                                                           \
+   if(*tree == NULL){                                                          \
+      return 0;                                                                \
+   }                                                                           \
+   found = *tree;                                                              \
+   if(found->left != NULL && found->right != NULL){                            \
+      path[top++] = tree;                                                      \
+      tree = &found->right;                                                    \
+      while((*tree)->left != NULL){                                            \
+         path[top++] = tree;                                                   \
+         tree = &(*tree)->left;                                                \
+      }                                                                        \
+      found->value = (*tree)->value;                                           \
+   }                                                                           \
+   temp = *tree;                                                               \
+   *tree = (temp->left != NULL)? temp->left : temp->right;                     \
+   free(temp);                                                                 \
+   name##_rebalance_path(path, top);                                           \
+   return 1;                                                                   \
+}                                                                              \
+                                                                               \
+/* call visit on every value in ascending order */                             \
+static inline void name##_walk(name##_node * tree,                            \
+      void (*visit)(key_t * value, void * context), void * context){           \
+   name##_node * stack[AVL_MAX_HEIGHT];                                        \
+   int top = 0;                                                                \
+   while(tree != NULL || top > 0){                                             \
+      while(tree != NULL){                                                     \
+         stack[top++] = tree;                                                  \
+         tree = tree->left;                                                    \
+      }                                                                        \
+      tree = stack[--top];                                                     \
+      visit(&tree->value, context);                                            \
+      tree = tree->right;                                                      \
+   }                                                                           \
+}                                                                              \
+                                                                               \
+/* free every node */                                                          \
+static inline void name##_delete(name##_node * tree){                         \
+   if(tree != NULL){                                                           \
+      name##_delete(tree->left);                                               \
+      name##_delete(tree->right);                                              \
+      free(tree);                                                              \
+   }                                                                           \
+}
+
+#endif
@@ -0,0 +1,102 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+ */
+
+#include "avl_tree.h"
+#include "avl_tree_template.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * fixed size key compared byte by byte
+ */
+typedef struct {
+	char code[8];
+} Sku;
+
+static inline int sku_cmp(Sku a, Sku b){
+	return memcmp(a.code, b.code, sizeof(a.code));
+}
+
+AVL_DEFINE(ids, uint64_t, AVL_CMP_SCALAR)
+AVL_DEFINE(prices, double, AVL_CMP_SCALAR)
+AVL_DEFINE(skus, Sku, sku_cmp)
+
+static void print_id(uint64_t * value, void * context){
+	(void) context;
+	printf("%llu ", (unsigned long long) *value);
+}
+
+static void print_price(double * value, void * context){
+	(void) context;
+	printf("%.2f ", *value);
+}
+
+static void print_sku(Sku * value, void * context){
+	(void) context;
+	printf("%.8s ", value->code);
+}
+
+/**
+ * Main program
+ * Three specialized trees and the int AvlTree in the same program
+ *
+ */
+int main(){
+	ids_node * ids = NULL;
+	prices_node * prices = NULL;
+	skus_node * skus = NULL;
+	Sku sku = {"BOLT-M06"};
+	AvlTree tree = avltree();
+
+	ids_insert(&ids, 18446744073709551557ULL);
+	ids_insert(&ids, 42);
+	ids_insert(&ids, 4294967296ULL);
+	ids_remove(&ids, 42);
+
+	prices_insert(&prices, 9.99);
+	prices_insert(&prices, 0.5);
+	prices_insert(&prices, 120.0);
+
+	skus_insert(&skus, (Sku){"NUT-M004"});
+	skus_insert(&skus, sku);
+	skus_insert(&skus, (Sku){"WASHER-8"});
+
+	tree.insert(&tree.root, 7);
+
+	printf("ids: ");
+	ids_walk(ids, print_id, NULL);
+	printf("\nprices: ");
+	prices_walk(prices, print_price, NULL);
+	printf("\nskus: ");
+	skus_walk(skus, print_sku, NULL);
+	printf("\nint tree: ");
+	tree.inOrder(tree.root);
+	printf("\n\n");
+
+	if(skus_search(skus, sku) != NULL){
+		printf("Found element %.8s\n", sku.code);
+	}
+	printf("height: %d\n", prices_height(prices));
+
+	ids_delete(ids);
+	prices_delete(prices);
+	skus_delete(skus);
+	tree.delete(tree.root);
+
+	return 0;
+}
@@ -0,0 +1,517 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/**
+ * Version of the result records, bumped whenever a field changes meaning.
+ */
+#define SUITE_VERSION 2
+
+/**
+ * Keys and operation rolls are drawn this many at a time, outside the
+ * timed calls, so the zipf sampler is not measured with the trees.
+ */
+#define OP_BATCH 4096
+
+/**
+ * Latency histogram: values below HIST_SUB are exact, above that every
+ * power of two is split in HIST_SUB buckets (about 6% resolution).
+ */
+#define HIST_SUB 16
+#define HIST_BUCKETS (64 * HIST_SUB)
+
+static const TreeOps * trees[] = { &binary_ops, &avl_ops, &red_black_ops, &compact_avl_ops, &btree_ops };
+
+static const char * distributions[] = { "sequential", "random", "zipf" };
+
+typedef struct workload {
+   const char * name;
+   int search_percent;
+   int insert_percent;
+   int remove_percent;
+}Workload;
+
+static const Workload workloads[] = {
+   { "read-heavy", 90, 5, 5 },
+   { "write-heavy", 10, 45, 45 },
+   { "mixed", 50, 25, 25 },
+   { "delete-storm", 0, 0, 100 }
+};
+
+typedef struct config {
+   size_t keys;
+   size_t ops;
+   double budget;
+   double zipf;
+   const char * trees;
+   const char * distributions;
+   const char * workloads;
+   const char * output;
+   const char * label;
+}Config;
+
+typedef struct zipf {
+   double s;
+   double n;
+   double h_x1;
+   double h_n;
+   double threshold;
+}Zipf;
+
+typedef struct keygen {
+   int kind; /* index in distributions */
+   unsigned long seed;
+   unsigned long counter;
+   unsigned long range;
+   Zipf zipf;
+}KeyGen;
+
+/**
+ * monotonic clock in nanoseconds
+ *
+ * @returns the current time in nanoseconds
+ */
+static double now_ns(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * next value of a xorshift generator
+ *
+ * @param unsigned long * seed, the generator state.
+ *
+ * @returns a pseudo random number
+ */
+static unsigned long next_random(unsigned long * seed){
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 7;
+	*seed ^= *seed << 17;
+	return *seed;
+}
+
+/**
+ * uniform double in [0, 1)
+ *
+ * @param unsigned long * seed, the generator state.
+ *
+ * @returns a pseudo random double
+ */
+static double next_double(unsigned long * seed){
+	return (next_random(seed) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * log1p(x) / x, continuous at 0
+ */
+static double helper1(double x){
+	return (fabs(x) > 1e-8)? log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+}
+
+/**
+ * expm1(x) / x, continuous at 0
+ */
+static double helper2(double x){
+	return (fabs(x) > 1e-8)? expm1(x) / x : 1 + x * 0.5 * (1 + x * (1.0 / 3) * (1 + 0.25 * x));
+}
+
+/**
+ * h(x) = x^-s, the density the sampler inverts
+ */
+static double zipf_h(const Zipf * z, double x){
+	return exp(-z->s * log(x));
+}
+
+/**
+ * integral of h from 1 to x
+ */
+static double zipf_h_integral(const Zipf * z, double x){
+	double log_x = log(x);
+	return helper2((1 - z->s) * log_x) * log_x;
+}
+
+/**
+ * inverse of zipf_h_integral
+ */
+static double zipf_h_integral_inverse(const Zipf * z, double x){
+	double t = x * (1 - z->s);
+	if (t < -1){
+		t = -1;
+	}
+	return exp(helper1(t) * x);
+}
+
+/**
+ * prepare a Zipf sampler over ranks 1 .. n using rejection inversion
+ * (Hormann and Derflinger), which needs no table of probabilities.
+ *
+ * @param Zipf * z, the sampler.
+ * @param double s, the exponent.
+ * @param unsigned long n, number of ranks.
+ */
+static void zipf_init(Zipf * z, double s, unsigned long n){
+	z->s = s;
+	z->n = (double) n;
+	z->h_x1 = zipf_h_integral(z, 1.5) - 1;
+	z->h_n = zipf_h_integral(z, z->n + 0.5);
+	z->threshold = 2 - zipf_h_integral_inverse(z, zipf_h_integral(z, 2.5) - zipf_h(z, 2));
+}
+
+/**
+ * draw a Zipf distributed rank
+ *
+ * @param const Zipf * z, the sampler.
+ * @param unsigned long * seed, the generator state.
+ *
+ * @returns a rank in 1 .. n, rank 1 being the most frequent
+ */
+static unsigned long zipf_next(const Zipf * z, unsigned long * seed){
+	double u, x, k;
+	for (;;){
+		u = z->h_n + next_double(seed) * (z->h_x1 - z->h_n);
+		x = zipf_h_integral_inverse(z, u);
+		k = floor(x + 0.5);
+		if (k < 1){
+			k = 1;
+		}
+		else if (k > z->n){
+			k = z->n;
+		}
+		if (k - x <= z->threshold || u >= zipf_h_integral(z, k + 0.5) - zipf_h(z, k)){
+			return (unsigned long) k;
+		}
+	}
+}
+
+/**
+ * next key of a distribution. Sequential keys count up and wrap around
+ * the range, Zipf ranks are scattered over the range by a multiplicative
+ * permutation so hot keys do not sit next to each other.
+ *
+ * @param KeyGen * gen, the key generator.
+ *
+ * @returns a key in [0, range)
+ */
+static int next_key(KeyGen * gen){
+	switch (gen->kind){
+	case 0:
+		return (int) (gen->counter++ % gen->range);
+	case 1:
+		return (int) ((next_random(&gen->seed) >> 8) % gen->range);
+	default:
+		return (int) (((zipf_next(&gen->zipf, &gen->seed) - 1) * 2654435761UL) % gen->range);
+	}
+}
+
+/**
+ * histogram bucket of a latency
+ *
+ * @param unsigned long ns, latency in nanoseconds.
+ *
+ * @returns the bucket index
+ */
+static size_t bucket_of(unsigned long ns){
+	int msb;
+	if (ns < HIST_SUB){
+		return ns;
+	}
+	msb = 63 - __builtin_clzl(ns);
+	return (msb - 3) * HIST_SUB + ((ns >> (msb - 4)) & (HIST_SUB - 1));
+}
+
+/**
+ * lowest latency that falls in a bucket
+ *
+ * @param size_t bucket, the bucket index.
+ *
+ * @returns latency in nanoseconds
+ */
+static unsigned long bucket_value(size_t bucket){
+	if (bucket < HIST_SUB){
+		return bucket;
+	}
+	return (unsigned long) (HIST_SUB + bucket % HIST_SUB) << (bucket / HIST_SUB - 1);
+}
+
+/**
+ * latency below which a fraction of the operations completed
+ *
+ * @param const unsigned long * hist, the histogram.
+ * @param unsigned long total, number of samples.
+ * @param double q, the quantile in [0, 1].
+ *
+ * @returns latency in nanoseconds
+ */
+static unsigned long percentile(const unsigned long * hist, unsigned long total, double q){
+	unsigned long seen = 0, rank = (unsigned long) ceil(q * total);
+	size_t b;
+	for (b = 0; b < HIST_BUCKETS; b++){
+		seen += hist[b];
+		if (seen >= rank && seen > 0){
+			return bucket_value(b);
+		}
+	}
+	return 0;
+}
+
+/**
+ * resident set size of the process
+ *
+ * @returns bytes in memory right now, 0 where /proc is not available
+ */
+static size_t current_rss(){
+	unsigned long size, resident = 0;
+	FILE * statm = fopen("/proc/self/statm", "r");
+	if (statm == NULL){
+		return 0;
+	}
+	if (fscanf(statm, "%lu %lu", &size, &resident) != 2){
+		resident = 0;
+	}
+	fclose(statm);
+	return resident * (size_t) sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * check whether a name is in a comma separated list, "all" matches any.
+ *
+ * @param const char * list, the list.
+ * @param const char * name, the name.
+ *
+ * @returns 1 if the name is selected
+ */
+static int selected(const char * list, const char * name){
+	size_t len = strlen(name);
+	const char * at = list;
+	if (strcmp(list, "all") == 0){
+		return 1;
+	}
+	while ((at = strstr(at, name)) != NULL){
+		if ((at == list || at[-1] == ',') && (at[len] == '\0' || at[len] == ',')){
+			return 1;
+		}
+		at += len;
+	}
+	return 0;
+}
+
+/**
+ * write a string as a quoted JSON string, escaping quotes, backslashes
+ * and control characters so any label keeps the record valid.
+ *
+ * @param FILE * out, the output file.
+ * @param const char * text, the string.
+ */
+static void write_json_string(FILE * out, const char * text){
+	const unsigned char * at;
+	fputc('"', out);
+	for (at = (const unsigned char *) text; *at != '\0'; at++){
+		if (*at == '"' || *at == '\\'){
+			fprintf(out, "\\%c", *at);
+		}
+		else if (*at < 0x20){
+			fprintf(out, "\\u%04x", *at);
+		}
+		else{
+			fputc(*at, out);
+		}
+	}
+	fputc('"', out);
+}
+
+/**
+ * load keys then run a workload on one tree, in its own process so that
+ * peak RSS belongs to this run only. Both phases stop at the time budget.
+ * Only the tree calls are timed: keys and rolls are drawn beforehand in
+ * batches of OP_BATCH, small enough not to count in the RSS, and ops/s
+ * is the number of calls over the time spent in them.
+ * Prints a line for humans and appends a JSON record to the output file.
+ *
+ * @param const Config * config, the command line.
+ * @param const TreeOps * ops_table, the tree.
+ * @param int kind, index of the key distribution.
+ * @param const Workload * workload, the operation mix.
+ */
+static void run(const Config * config, const TreeOps * ops_table, int kind, const Workload * workload){
+	static unsigned long hist[HIST_BUCKETS];
+	static int batch_keys[OP_BATCH];
+	static int batch_rolls[OP_BATCH];
+	KeyGen gen;
+	struct rusage usage;
+	unsigned long seed = 2463534242UL, rotations;
+	size_t attempts, loaded = 0, done, i, rss_before, rss_after;
+	double t0, t1, elapsed = 0, deadline;
+	void * tree;
+	int key, roll_percent;
+	FILE * out;
+
+	memset(hist, 0, sizeof(hist));
+	memset(&gen, 0, sizeof(gen));
+	gen.kind = kind;
+	gen.seed = 88172645463325252UL;
+	gen.range = 2 * config->keys;
+	zipf_init(&gen.zipf, config->zipf, gen.range);
+
+	rss_before = current_rss();
+	tree = ops_table->create();
+	deadline = now_ns() + config->budget * 1e9;
+	for (attempts = 0; attempts < config->keys; attempts++){
+		key = (kind == 0)? (int) attempts : (int) ((next_random(&gen.seed) >> 8) % gen.range);
+		if (!ops_table->search(tree, key)){
+			ops_table->insert(tree, key);
+			loaded++;
+		}
+		if ((attempts & 1023) == 0 && now_ns() > deadline){
+			break;
+		}
+	}
+	rss_after = current_rss();
+	gen.counter = attempts;
+
+	rotations = ops_table->rotations();
+	deadline = now_ns() + config->budget * 1e9;
+	for (done = 0; done < config->ops; done++){
+		if (done % OP_BATCH == 0){
+			if (now_ns() > deadline){
+				break;
+			}
+			for (i = 0; i < OP_BATCH; i++){
+				batch_keys[i] = next_key(&gen);
+				batch_rolls[i] = (int) (next_random(&seed) % 100);
+			}
+		}
+		key = batch_keys[done % OP_BATCH];
+		roll_percent = batch_rolls[done % OP_BATCH];
+		t0 = now_ns();
+		if (roll_percent < workload->search_percent){
+			ops_table->search(tree, key);
+		}
+		else if (roll_percent < workload->search_percent + workload->insert_percent){
+			ops_table->insert(tree, key);
+		}
+		else{
+			ops_table->remove(tree, key);
+		}
+		t1 = now_ns();
+		hist[bucket_of((unsigned long) (t1 - t0))]++;
+		elapsed += t1 - t0;
+	}
+	rotations = ops_table->rotations() - rotations;
+	getrusage(RUSAGE_SELF, &usage);
+
+	printf("%-12s %-10s %-12s %10.0f ops/s  p50 %6lu ns  p99 %7lu ns  p999 %8lu ns  rss %7ld KB  %5.1f B/node  height %d%s\n",
+			ops_table->name, distributions[kind], workload->name,
+			(elapsed > 0)? done / (elapsed / 1e9) : 0.0, percentile(hist, done, 0.50),
+			percentile(hist, done, 0.99), percentile(hist, done, 0.999),
+			usage.ru_maxrss, loaded ? (double) (rss_after - rss_before) / loaded : 0.0,
+			ops_table->height(tree), (attempts < config->keys || done < config->ops)? "  (budget hit)" : "");
+
+	if (config->output != NULL && (out = fopen(config->output, "a")) != NULL){
+		fprintf(out, "{\"suite_version\": %d, \"label\": ", SUITE_VERSION);
+		write_json_string(out, config->label);
+		fprintf(out, ", \"tree\": \"%s\", "
+				"\"keys\": \"%s\", \"workload\": \"%s\", \"n\": %zu, \"loaded\": %zu, "
+				"\"ops\": %zu, \"ops_per_sec\": %.1f, \"p50_ns\": %lu, \"p99_ns\": %lu, "
+				"\"p999_ns\": %lu, \"peak_rss_kb\": %ld, \"node_bytes\": %zu, "
+				"\"rss_bytes_per_node\": %.1f, \"height\": %d, \"rotations\": %lu}\n",
+				ops_table->name, distributions[kind],
+				workload->name, config->keys, loaded, done, (elapsed > 0)? done / (elapsed / 1e9) : 0.0,
+				percentile(hist, done, 0.50), percentile(hist, done, 0.99),
+				percentile(hist, done, 0.999), usage.ru_maxrss, ops_table->node_size,
+				loaded ? (double) (rss_after - rss_before) / loaded : 0.0,
+				ops_table->height(tree), rotations);
+		fclose(out);
+	}
+	ops_table->destroy(tree);
+}
+
+/**
+ * Benchmark program
+ * usage: ./bench [-n keys] [-o operations] [-b seconds] [-z exponent]
+ *                [-t trees] [-k distributions] [-w workloads]
+ *                [-f results.jsonl] [-l label]
+ *
+ */
+int main(int argc, char ** argv){
+	Config config = { 1000000, 2000000, 10.0, 0.99, "all", "all", "all", NULL, "" };
+	size_t t, k, w;
+	pid_t child;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:o:b:z:t:k:w:f:l:")) != -1){
+		switch (opt){
+		case 'n': config.keys = strtoul(optarg, NULL, 10); break;
+		case 'o': config.ops = strtoul(optarg, NULL, 10); break;
+		case 'b': config.budget = atof(optarg); break;
+		case 'z': config.zipf = atof(optarg); break;
+		case 't': config.trees = optarg; break;
+		case 'k': config.distributions = optarg; break;
+		case 'w': config.workloads = optarg; break;
+		case 'f': config.output = optarg; break;
+		case 'l': config.label = optarg; break;
+		default:
+			fprintf(stderr, "usage: %s [-n keys] [-o operations] [-b seconds] [-z exponent] "
+					"[-t trees] [-k distributions] [-w workloads] [-f results.jsonl] [-l label]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (config.keys == 0){
+		config.keys = 1;
+	}
+
+	for (t = 0; t < sizeof(trees) / sizeof(trees[0]); t++){
+		if (!selected(config.trees, trees[t]->name)){
+			continue;
+		}
+		for (k = 0; k < sizeof(distributions) / sizeof(distributions[0]); k++){
+			if (!selected(config.distributions, distributions[k])){
+				continue;
+			}
+			for (w = 0; w < sizeof(workloads) / sizeof(workloads[0]); w++){
+				if (!selected(config.workloads, workloads[w].name)){
+					continue;
+				}
+				fflush(stdout);
+				child = fork();
+				if (child == 0){
+					run(&config, trees[t], (int) k, &workloads[w]);
+					fflush(stdout);
+					_exit(0);
+				}
+				else if (child > 0){
+					waitpid(child, NULL, 0);
+				}
+				else{
+					run(&config, trees[t], (int) k, &workloads[w]);
+				}
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,41 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+ */
+
+/**
+ * Every tree header defines its own Node, so each tree is wrapped in its
+ * own translation unit behind this table of functions on an opaque tree.
+ *
+ */
+#include <stddef.h>
+
+typedef struct treeops {
+   const char * name;
+   size_t node_size;
+   void * (*create)(void);
+   void (*insert)(void * tree, int key);
+   int (*search)(void * tree, int key);
+   int (*remove)(void * tree, int key);
+   int (*height)(void * tree);
+   void (*destroy)(void * tree);
+   unsigned long (*rotations)(void);
+}TreeOps;
+
+extern const TreeOps binary_ops;
+extern const TreeOps avl_ops;
+extern const TreeOps red_black_ops;
+extern const TreeOps compact_avl_ops;
+extern const TreeOps btree_ops;
@@ -0,0 +1,64 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+ */
+
+#include "../binary_tree/binary_tree.h"
+#include "bench.h"
+#include <stdlib.h>
+
+static void * create(void){
+	BinaryTree * tree = (BinaryTree*) malloc(sizeof(BinaryTree));
+	*tree = binarytree();
+	return tree;
+}
+
+static void insert(void * tree, int key){
+	BinaryTree * bt = (BinaryTree*) tree;
+	bt->insert(&bt->root, key);
+}
+
+static int search(void * tree, int key){
+	BinaryTree * bt = (BinaryTree*) tree;
+	return bt->search(bt->root, key) != NULL;
+}
+
+static int removeKey(void * tree, int key){
+	BinaryTree * bt = (BinaryTree*) tree;
+	return bt->remove(&bt->root, key);
+}
+
+static int height(void * tree){
+	BinaryTree * bt = (BinaryTree*) tree;
+	return bt->height(bt->root);
+}
+
+static void destroy(void * tree){
+	BinaryTree * bt = (BinaryTree*) tree;
+	bt->delete(bt->root);
+	free(bt);
+}
+
+static unsigned long rotations(void){
+	return 0;
+}
+
+/**
+ * the tree behind the TreeOps table used by the benchmark
+ *
+ */
+const TreeOps binary_ops = {
+	"binary", sizeof(Node), create, insert, search, removeKey, height, destroy, rotations
+};
@@ -0,0 +1,65 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+ */
+
+#include "../btree/btree.h"
+#include "bench.h"
+#include <stdlib.h>
+
+static void * create(void){
+	BTree * tree = (BTree*) malloc(sizeof(BTree));
+	*tree = btree();
+	return tree;
+}
+
+static void insert(void * tree, int key){
+	BTree * b = (BTree*) tree;
+	b->insert(&b->root, key);
+}
+
+static int search(void * tree, int key){
+	BTree * b = (BTree*) tree;
+	return b->search(b->root, key) != NULL;
+}
+
+static int removeKey(void * tree, int key){
+	BTree * b = (BTree*) tree;
+	return b->remove(&b->root, key);
+}
+
+static int height(void * tree){
+	BTree * b = (BTree*) tree;
+	return b->height(&b->root);
+}
+
+static void destroy(void * tree){
+	BTree * b = (BTree*) tree;
+	b->delete(b->root);
+	free(b);
+}
+
+/* a b-tree splits and merges nodes instead of rotating */
+static unsigned long rotations(void){
+	return 0;
+}
+
+/**
+ * the tree behind the TreeOps table used by the benchmark
+ *
+ */
+const TreeOps btree_ops = {
+	"btree", sizeof(BTreeNode), create, insert, search, removeKey, height, destroy, rotations
+};
@@ -0,0 +1,68 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+ */
+
+#include "../compact_avl_tree/compact_avl_tree.h"
+#include "bench.h"
+#include <stdlib.h>
+
+static void * create(void){
+	CompactAvlTree * tree = (CompactAvlTree*) malloc(sizeof(CompactAvlTree));
+	*tree = compactavltree();
+	return tree;
+}
+
+static void insert(void * tree, int key){
+	CompactAvlTree * avl = (CompactAvlTree*) tree;
+	avl->insert(&avl->root, key);
+}
+
+static int search(void * tree, int key){
+	CompactAvlTree * avl = (CompactAvlTree*) tree;
+	return avl->search(&avl->root, key) != NULL;
+}
+
+static int removeKey(void * tree, int key){
+	CompactAvlTree * avl = (CompactAvlTree*) tree;
+	return avl->remove(&avl->root, key);
+}
+
+static int height(void * tree){
+	CompactAvlTree * avl = (CompactAvlTree*) tree;
+	return avl->height(&avl->root);
+}
+
+static void destroy(void * tree){
+	CompactAvlTree * avl = (CompactAvlTree*) tree;
+	avl->delete(&avl->root);
+	free(avl);
+}
+
+static unsigned long rotations(void){
+#ifdef TREE_STATS
+	return compactavltree_rotations;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * the tree behind the TreeOps table used by the benchmark
+ *
+ */
+const TreeOps compact_avl_ops = {
+	"compact-avl", sizeof(CompactNode), create, insert, search, removeKey, height, destroy, rotations
+};
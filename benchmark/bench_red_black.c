@@ -0,0 +1,68 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+ */
+
+#include "../red_black_tree/red_black_tree.h"
+#include "bench.h"
+#include <stdlib.h>
+
+static void * create(void){
+	RedBlackTree * tree = (RedBlackTree*) malloc(sizeof(RedBlackTree));
+	*tree = redblacktree();
+	return tree;
+}
+
+static void insert(void * tree, int key){
+	RedBlackTree * rb = (RedBlackTree*) tree;
+	rb->insert(&rb->root, key);
+}
+
+static int search(void * tree, int key){
+	RedBlackTree * rb = (RedBlackTree*) tree;
+	return rb->search(rb->root, key) != NULL;
+}
+
+static int removeKey(void * tree, int key){
+	RedBlackTree * rb = (RedBlackTree*) tree;
+	return rb->remove(&rb->root, key);
+}
+
+static int height(void * tree){
+	RedBlackTree * rb = (RedBlackTree*) tree;
+	return rb->height(rb->root);
+}
+
+static void destroy(void * tree){
+	RedBlackTree * rb = (RedBlackTree*) tree;
+	rb->delete(rb->root);
+	free(rb);
+}
+
+static unsigned long rotations(void){
+#ifdef TREE_STATS
+	return rbtree_rotations;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * the tree behind the TreeOps table used by the benchmark
+ *
+ */
+const TreeOps red_black_ops = {
+	"red-black", sizeof(Node), create, insert, search, removeKey, height, destroy, rotations
+};
@@ -19,36 +19,116 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
-#define itemtype int
-
-typedef struct node {
-	itemtype value;
-	struct node * right;
-	struct node * left;
-}Node;
-
-typedef struct binarytree {
-	void (*insert)(Node ** tree, itemtype value); 
-	Node* (*search)(Node * tree, itemtype value);
-	bool (*remove) (Node ** tree, itemtype value);
-	int (*height) (Node * tree);
-	void (*delete) (Node * tree);	
-	void (*preOrder)(Node * tree);
-	void (*posOrder)(Node * tree);
-	void (*inOrder)(Node * tree);
-	Node * root;
-}BinaryTree;
+#include "binary_tree.h"
+#include "binary_tree_inline.h"
+
+/**
+ * create an empty node pool.
+ *
+ * @param size_t chunk_nodes, nodes per chunk, 0 for NODEPOOL_CHUNK.
+ *
+ * @returns a new pool or NULL if out of memory
+ */
+NodePool * binarytree_pool_create(size_t chunk_nodes){
+	NodePool * pool;
+	pool = (NodePool*) calloc(1, sizeof(NodePool));
+	if(pool == NULL){
+		return NULL;
+	}
+	pool->chunk_nodes = (chunk_nodes == 0)? NODEPOOL_CHUNK : chunk_nodes;
+	return pool;
+}
+
+/**
+ * give back every node of the pool at once, the pool stays usable.
+ * Costs one free per chunk instead of one free per node.
+ *
+ * @param NodePool * pool, the pool to empty.
+ */
+void binarytree_pool_release(NodePool * pool){
+	NodeChunk * chunk;
+	while(pool->chunks != NULL){
+		chunk = pool->chunks;
+		pool->chunks = chunk->next;
+		free(chunk);
+	}
+	pool->free_list = NULL;
+	pool->used = 0;
+}
+
+/**
+ * release every node of the pool and the pool itself.
+ *
+ * @param NodePool * pool, the pool to destroy.
+ */
+void binarytree_pool_destroy(NodePool * pool){
+	if(pool != NULL){
+		binarytree_pool_release(pool);
+		free(pool);
+	}
+}
+
+/**
+ * take one node from the pool: a recycled node if any, otherwise the next
+ * free slot of the newest chunk, allocating a new chunk when it is full.
+ *
+ * @param NodePool * pool, the pool, NULL to use calloc.
+ *
+ * @returns an uninitialized Node or NULL if out of memory
+ */
+private Node * allocNode(NodePool * pool){
+	Node * aux;
+	NodeChunk * chunk;
+	if(pool == NULL){
+		return (Node*) calloc(1, sizeof(Node));
+	}
+	if(pool->free_list != NULL){
+		aux = pool->free_list;
+		pool->free_list = aux->left;
+		return aux;
+	}
+	if(pool->chunks == NULL || pool->used == pool->chunk_nodes){
+		chunk = (NodeChunk*) malloc(sizeof(NodeChunk) + pool->chunk_nodes * sizeof(Node));
+		if(chunk == NULL){
+			return NULL;
+		}
+		chunk->next = pool->chunks;
+		pool->chunks = chunk;
+		pool->used = 0;
+		pool->allocations++;
+	}
+	return &pool->chunks->nodes[pool->used++];
+}
+
+/**
+ * give a Node back to its pool free list, or to free when there is no pool.
+ *
+ * @param NodePool * pool, the pool owning the Node, NULL if it came from calloc.
+ * @param Node * node, the Node to release.
+ */
+private void freeNode(NodePool * pool, Node * node){
+	if(pool == NULL){
+		free(node);
+		return;
+	}
+	node->left = pool->free_list;
+	pool->free_list = node;
+}
 
 /**
  * createNode allocates a new node with the given value and NULL left and right pointers
  *
+ * @param NodePool * pool, the pool to carve the Node from, NULL to use calloc.
  * @param itemtype value, value to insert.
  *
  * @returns a new Node, a pointer of type Node
  */
-Node * createNode(itemtype value){
+private Node * createNode(NodePool * pool, itemtype value){
 	Node * aux;
-	aux = (Node*) calloc(1, sizeof(Node));
+	aux = allocNode(pool);
+	if(aux == NULL){
+		return NULL;
+	}
 	aux->left = NULL;
 	aux->right = NULL;
 	aux->value = value;
@@ -56,28 +136,39 @@ Node * createNode(itemtype value){
 }
 
 /**
- * Insert elements in binary tree.
+ * Insert elements in binary tree, taking the new Node from a pool.
  *
+ * @param NodePool * pool, the pool of the tree, NULL to use calloc.
  * @param Node ** tree, the root of the tree, is a Node type pointer.
  * @param itemtype value, value to insert.
  *
  * @returns by parameter the tree with the new element.
  */
-void insert(Node ** tree, itemtype value){
-	Node *aux = NULL;
-	if((*tree) == NULL){
-		*tree = createNode(value);
-		return;
-	}
-	if(value < (*tree)->value){
-		insert(&(*tree)->left, value);
-	}
-	else if(value > (*tree)->value){
-		insert(&(*tree)->right, value);
-	}
-	else{
-		return;
+private void insertPool(NodePool * pool, Node ** tree, itemtype value){
+	while((*tree) != NULL){
+		if(value < (*tree)->value){
+			tree = &(*tree)->left;
+		}
+		else if(value > (*tree)->value){
+			tree = &(*tree)->right;
+		}
+		else{
+			return;
+		}
 	}
+	*tree = createNode(pool, value);
+}
+
+/**
+ * Insert elements in binary tree.
+ *
+ * @param Node ** tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, value to insert.
+ *
+ * @returns by parameter the tree with the new element.
+ */
+private void insert(Node ** tree, itemtype value){
+	insertPool(NULL, tree, value);
 }
 
 
@@ -89,134 +180,348 @@ void insert(Node ** tree, itemtype value){
  *
  * @returns Node type pointer, Node referring to found element.
  */
-Node* search(Node * tree, itemtype value){
-	if (tree == NULL){
-		return  NULL;
-	}
-	else if(value < tree->value){
-		search(tree->left, value);
-	}
-	else if(value > tree->value){
-		search(tree->right, value);
-	}
-	else if(value == tree->value){
-		return tree;
-	}
-	else{
-		return NULL;
-	}
+private Node * search(Node * tree, itemtype value){
+	return bst_search(tree, value);
 }
 
 /**
- * find the element with a minimum value on the left side.
+ * Lowest value not lower than value in binary tree, see bst_lower_bound.
  *
- * @param Node ** tree, the root of the tree, is a Node type pointer.
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the bound.
  *
- * @returns by the node referring the minimum element.
+ * @returns Node type pointer, NULL if every value is lower.
  */
-Node * findMinValue(Node * tree){
-	if(tree->left == NULL)
-		return tree;
-	else{
-		findMinValue(tree->left);
-	}
+private Node * lower_bound(Node * tree, itemtype value){
+	return bst_lower_bound(tree, value);
 }
 
+/**
+ * Lowest value greater than value in binary tree, see bst_upper_bound.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns Node type pointer, NULL if no value is greater.
+ */
+private Node * upper_bound(Node * tree, itemtype value){
+	return bst_upper_bound(tree, value);
+}
 
 /**
- * remove elements in binary tree.
+ * Highest value not greater than value in binary tree, see bst_floor.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns Node type pointer, NULL if every value is greater.
+ */
+private Node * floor_node(Node * tree, itemtype value){
+	return bst_floor(tree, value);
+}
+
+/**
+ * Lowest value not lower than value in binary tree, see bst_ceil.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns Node type pointer, NULL if every value is lower.
+ */
+private Node * ceil_node(Node * tree, itemtype value){
+	return bst_ceil(tree, value);
+}
+
+/**
+ * Search many elements in binary tree at once, see bst_search_batch.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param const itemtype * values, the values to search.
+ * @param size_t n, number of values.
+ * @param Node ** out, receives the node of each value, NULL if absent.
+ */
+private void search_batch(Node * tree, const itemtype * values, size_t n, Node ** out){
+	bst_search_batch(tree, values, n, out);
+}
+
+
+/**
+ * remove elements in binary tree, giving the Node back to a pool.
+ * The successor of a Node with two children is unlinked in the same
+ * descent that found the Node.
  *
+ * @param NodePool * pool, the pool of the tree, NULL if nodes came from calloc.
  * @param Node ** tree, the root of the tree, is a Node type pointer.
  * @param itemtype value, value to insert.
  *
  * @returns true if element removed or false if element not remove.
  */
-bool removeNode(Node ** tree, itemtype value){
+private bool removePool(NodePool * pool, Node ** tree, itemtype value){
+	Node * found;
 	Node * temp;
+	while(*tree != NULL && value != (*tree)->value){
+		tree = (value < (*tree)->value)? &(*tree)->left : &(*tree)->right;
+	}
 	if(*tree == NULL){
 		return false;
 	}
-	else if(value < (*tree)->value){
-		removeNode(&(*tree)->left, value);
-	}
-	else if(value > (*tree)->value){
-		removeNode(&(*tree)->right, value);
-	}
-	else{
-		if((*tree)->right && (*tree)->left){
-			temp = findMinValue((*tree)->right);
-			(*tree)->value = temp->value; 
-			removeNode(&(*tree)->right, temp->value);
-		}
-		else{
-			temp = *tree;
-			if((*tree)->left == NULL){
-				*tree = (*tree)->right;
-			}
-			else if((*tree)->right == NULL){
-				*tree = (*tree)->left;
-			}
-			free(temp);
-			return true;			
+	found = *tree;
+	if(found->right && found->left){
+		tree = &found->right;
+		while((*tree)->left != NULL){
+			tree = &(*tree)->left;
 		}
+		found->value = (*tree)->value;
 	}
+	temp = *tree;
+	*tree = (temp->left != NULL)? temp->left : temp->right;
+	freeNode(pool, temp);
+	return true;
+}
+
+/**
+ * remove elements in binary tree.
+ *
+ * @param Node ** tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, value to insert.
+ *
+ * @returns true if element removed or false if element not remove.
+ */
+private bool removeNode(Node ** tree, itemtype value){
+	return removePool(NULL, tree, value);
 }
 
 /**
  * height of binary tree.
+ * Walks the tree depth first on a heap stack, a degenerate tree would
+ * overflow the call stack.
  *
  * @param Node * tree, the root of the tree, is a Node type pointer.
  *
- * @returns a int type, is the height of tree
+ * @returns a int type, is the height of tree, -1 if out of memory
  */
-int height(Node * tree){
+private int height(Node * tree){
+	typedef struct { Node * node; int depth; } Frame;
+	Frame * stack;
+	Frame * grown;
+	size_t top = 0, capacity = 64;
+	int depth, result = 0;
+
 	if (tree == NULL)
 		return 0;
-	int left = height(tree->left);
-	int right = height(tree->right);
-	return (left > right) ? left + 1 : right + 1;
+	stack = (Frame*) malloc(capacity * sizeof(Frame));
+	if(stack == NULL){
+		return -1;
+	}
+	stack[top].node = tree;
+	stack[top++].depth = 1;
+	while(top > 0){
+		tree = stack[--top].node;
+		depth = stack[top].depth;
+		if(depth > result){
+			result = depth;
+		}
+		if(top + 2 > capacity){
+			grown = (Frame*) realloc(stack, 2 * capacity * sizeof(Frame));
+			if(grown == NULL){
+				free(stack);
+				return -1;
+			}
+			stack = grown;
+			capacity *= 2;
+		}
+		if(tree->left != NULL){
+			stack[top].node = tree->left;
+			stack[top++].depth = depth + 1;
+		}
+		if(tree->right != NULL){
+			stack[top].node = tree->right;
+			stack[top++].depth = depth + 1;
+		}
+	}
+	free(stack);
+	return result;
 }
 
 /**
  * Delete and free memory of binary tree.
+ * Rotates every left child up until the root has none, then frees the
+ * root, so no stack is needed at any depth.
  *
  * @param Node * tree, the root of the tree, is a Node type pointer.
  *
  */
-void delete_tree(Node * tree){
-	if(tree != NULL){
-		delete_tree(tree->left);
-		delete_tree(tree->right);
-		free(tree);
+private void delete_tree(Node * tree){
+	Node * aux;
+	while(tree != NULL){
+		if(tree->left != NULL){
+			aux = tree->left;
+			tree->left = aux->right;
+			aux->right = tree;
+			tree = aux;
+		}
+		else{
+			aux = tree->right;
+			free(tree);
+			tree = aux;
+		}
 	}
 }
 
 /**
- * Print binary tree in preorder form.
+ * Delete every Node of a pooled binary tree at once.
+ *
+ * @param NodePool * pool, the pool of the tree, NULL if nodes came from calloc.
+ * @param Node ** tree, the root of the tree, is a Node type pointer.
+ *
+ * @returns by parameter an empty tree.
+ */
+private void release(NodePool * pool, Node ** tree){
+	if(pool == NULL){
+		delete_tree(*tree);
+	}
+	else{
+		binarytree_pool_release(pool);
+	}
+	*tree = NULL;
+}
+
+/**
+ * Visit every node of binary tree in the given order, walking with a heap
+ * stack instead of recursion, so degenerate trees do not overflow the call
+ * stack. The visitor may free the node it gets in POS_ORDER, nothing reads
+ * a node after visiting it.
  *
  * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param TraversalOrder order, PRE_ORDER, IN_ORDER or POS_ORDER.
+ * @param NodeVisitor visit, called once per node.
+ * @param void * context, passed to visit.
  *
+ * @returns false if out of memory, the walk stops where it was
  */
-void print_pre_order(Node * tree) {
-	if(tree != NULL){
-		printf("%d ", tree->value);					
-		print_pre_order(tree->left);
-		print_pre_order(tree->right);
+private bool walk(Node * tree, TraversalOrder order, NodeVisitor visit, void * context){
+	NodeStack stack = {NULL, 0, 0};
+	Node * node;
+	Node * last = NULL;
+	bool ok = true;
+
+	if(order == PRE_ORDER){
+		while(ok && (tree != NULL || stack.top > 0)){
+			if(tree == NULL){
+				tree = stack.items[--stack.top];
+			}
+			if(tree->right != NULL){
+				ok = bst_push(&stack, tree->right);
+			}
+			node = tree->left;
+			visit(tree, context);
+			tree = node;
+		}
+	}
+	else if(order == IN_ORDER){
+		while(ok && (tree != NULL || stack.top > 0)){
+			while(ok && tree != NULL){
+				ok = bst_push(&stack, tree);
+				tree = tree->left;
+			}
+			if(ok){
+				node = stack.items[--stack.top];
+				tree = node->right;
+				visit(node, context);
+			}
+		}
+	}
+	else{
+		while(ok && (tree != NULL || stack.top > 0)){
+			if(tree != NULL){
+				ok = bst_push(&stack, tree);
+				tree = tree->left;
+			}
+			else{
+				node = stack.items[stack.top - 1];
+				if(node->right != NULL && node->right != last){
+					tree = node->right;
+				}
+				else{
+					stack.top--;
+					last = node;
+					visit(node, context);
+				}
+			}
+		}
 	}
+	free(stack.items);
+	return ok;
 }
 
 /**
- * Print binary tree in inorder form.
+ * Visit the nodes of binary tree holding values in [lo, hi), in ascending
+ * order. Subtrees wholly below lo are never entered and the walk stops at
+ * the first value not lower than hi, so it costs O(h + k) for k values.
  *
  * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype lo, lowest value visited.
+ * @param itemtype hi, first value not visited.
+ * @param NodeVisitor visit, called once per node in range.
+ * @param void * context, passed to visit.
  *
+ * @returns false if out of memory, the scan stops where it was
  */
-void print_in_order(Node * tree) {
-	if(tree != NULL){
-		print_in_order(tree->left);		
-		printf("%d ", tree->value);					
-		print_in_order(tree->right);
+private bool range_scan(Node * tree, itemtype lo, itemtype hi, NodeVisitor visit, void * context){
+	NodeStack stack = {NULL, 0, 0};
+	Node * node;
+	bool ok = true;
+
+	while(ok && (tree != NULL || stack.top > 0)){
+		while(ok && tree != NULL){
+			if(tree->value < lo){
+				tree = tree->right;
+			}
+			else{
+				ok = bst_push(&stack, tree);
+				tree = tree->left;
+			}
+		}
+		if(!ok || stack.top == 0){
+			break;
+		}
+		node = stack.items[--stack.top];
+		if(!(node->value < hi)){
+			break;
+		}
+		tree = node->right;
+		visit(node, context);
 	}
+	free(stack.items);
+	return ok;
+}
+
+/**
+ * NodeVisitor printing the value of a node.
+ */
+private void print_node(Node * node, void * context){
+	(void) context;
+	printf("%d ", node->value);
+}
+
+/**
+ * Print binary tree in preorder form.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ *
+ */
+private void print_pre_order(Node * tree) {
+	walk(tree, PRE_ORDER, print_node, NULL);
+}
+
+/**
+ * Print binary tree in inorder form.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ *
+ */
+private void print_in_order(Node * tree) {
+	walk(tree, IN_ORDER, print_node, NULL);
 }
 
 
@@ -226,12 +531,160 @@ void print_in_order(Node * tree) {
  * @param Node * tree, the root of the tree, is a Node type pointer.
  *
  */
-void print_pos_order(Node * tree) {
-	if(tree != NULL){
-		print_pos_order(tree->left);	
-		print_pos_order(tree->right);				
-		printf("%d ", tree->value);					
+private void print_pos_order(Node * tree) {
+	walk(tree, POS_ORDER, print_node, NULL);
+}
+
+/**
+ * compare two items for qsort.
+ *
+ * @param const void * a, pointer to the first item.
+ * @param const void * b, pointer to the second item.
+ *
+ * @returns negative, zero or positive as a is lower, equal or greater than b
+ */
+private int compareItems(const void * a, const void * b){
+	itemtype x = *(const itemtype*) a;
+	itemtype y = *(const itemtype*) b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * build a perfectly balanced binary tree from strictly ascending values,
+ * the middle value becomes the root of each subtree.
+ *
+ * @param const itemtype * values, the values in ascending order.
+ * @param size_t n, number of values.
+ *
+ * @returns the root of the new tree, a Node type pointer, NULL if out of
+ * memory, the nodes built so far are then freed.
+ */
+private Node * buildBalanced(const itemtype * values, size_t n){
+	Node * aux;
+	size_t mid;
+	if(n == 0){
+		return NULL;
+	}
+	mid = n / 2;
+	aux = createNode(NULL, values[mid]);
+	if(aux == NULL){
+		return NULL;
+	}
+	aux->left = buildBalanced(values, mid);
+	if(aux->left == NULL && mid > 0){
+		free(aux);
+		return NULL;
 	}
+	aux->right = buildBalanced(values + mid + 1, n - mid - 1);
+	if(aux->right == NULL && n - mid - 1 > 0){
+		delete_tree(aux);
+		return NULL;
+	}
+	return aux;
+}
+
+void binarytree_cursor(BstCursor * cursor, Node * tree){
+	cursor->root = tree;
+	cursor->path.items = NULL;
+	cursor->path.top = 0;
+	cursor->path.capacity = 0;
+}
+
+void binarytree_cursor_release(BstCursor * cursor){
+	free(cursor->path.items);
+	binarytree_cursor(cursor, cursor->root);
+}
+
+/**
+ * push a node and its leftmost or rightmost descendants on the path.
+ *
+ * @param BstCursor * cursor, the cursor.
+ * @param Node * node, the node, may be NULL.
+ * @param bool right, true to follow right children instead of left ones.
+ *
+ * @returns the last node pushed, the new current node, NULL if out of memory
+ */
+private Node * descend(BstCursor * cursor, Node * node, bool right){
+	while(node != NULL){
+		if(!bst_push(&cursor->path, node)){
+			cursor->path.top = 0;
+			return NULL;
+		}
+		node = right ? node->right : node->left;
+	}
+	return (cursor->path.top == 0)? NULL : cursor->path.items[cursor->path.top - 1];
+}
+
+/**
+ * pop the path while the popped node is the given child of its parent.
+ *
+ * @param BstCursor * cursor, the cursor, not empty.
+ * @param bool right, true to climb out of right subtrees, false for left.
+ *
+ * @returns the first ancestor reached from the other side, NULL if none
+ */
+private Node * ascend(BstCursor * cursor, bool right){
+	Node ** path = cursor->path.items;
+	Node * node;
+	size_t top = cursor->path.top;
+	do{
+		node = path[--top];
+	} while(top > 0 && (right ? path[top - 1]->right : path[top - 1]->left) == node);
+	cursor->path.top = top;
+	return (top == 0)? NULL : path[top - 1];
+}
+
+Node * binarytree_cursor_first(BstCursor * cursor){
+	cursor->path.top = 0;
+	return descend(cursor, cursor->root, false);
+}
+
+Node * binarytree_cursor_last(BstCursor * cursor){
+	cursor->path.top = 0;
+	return descend(cursor, cursor->root, true);
+}
+
+Node * binarytree_cursor_next(BstCursor * cursor){
+	Node * node;
+	if(cursor->path.top == 0){
+		return NULL;
+	}
+	node = cursor->path.items[cursor->path.top - 1];
+	if(node->right != NULL){
+		return descend(cursor, node->right, false);
+	}
+	return ascend(cursor, true);
+}
+
+Node * binarytree_cursor_prev(BstCursor * cursor){
+	Node * node;
+	if(cursor->path.top == 0){
+		return NULL;
+	}
+	node = cursor->path.items[cursor->path.top - 1];
+	if(node->left != NULL){
+		return descend(cursor, node->left, true);
+	}
+	return ascend(cursor, false);
+}
+
+Node * binarytree_cursor_seek(BstCursor * cursor, itemtype value){
+	Node * node = cursor->root;
+	cursor->path.top = 0;
+	while(node != NULL){
+		if(!bst_push(&cursor->path, node)){
+			cursor->path.top = 0;
+			return NULL;
+		}
+		if(value == node->value){
+			return node;
+		}
+		node = (value < node->value)? node->left : node->right;
+	}
+	if(cursor->path.top > 0 && cursor->path.items[cursor->path.top - 1]->value < value){
+		return binarytree_cursor_next(cursor);
+	}
+	return (cursor->path.top == 0)? NULL : cursor->path.items[cursor->path.top - 1];
 }
 
 /**
@@ -249,6 +702,87 @@ BinaryTree binarytree(){
 	new_bt.preOrder = &print_pre_order;
 	new_bt.posOrder = &print_pos_order;
 	new_bt.inOrder = &print_in_order;	
+	new_bt.insertPool = &insertPool;
+	new_bt.removePool = &removePool;
+	new_bt.release = &release;
+	new_bt.searchBatch = &search_batch;
+	new_bt.walk = &walk;
+	new_bt.lowerBound = &lower_bound;
+	new_bt.upperBound = &upper_bound;
+	new_bt.floor = &floor_node;
+	new_bt.ceil = &ceil_node;
+	new_bt.rangeScan = &range_scan;
 	new_bt.root = NULL;
+	new_bt.pool = NULL;
 	return new_bt;
 }
+
+/**
+ * method constructor of a tree whose nodes live in a NodePool
+ *
+ * @param size_t chunk_nodes, nodes per chunk, 0 for NODEPOOL_CHUNK.
+ *
+ * @returns a new BinaryTree type with its own pool
+ */
+BinaryTree binarytree_pool(size_t chunk_nodes){
+	BinaryTree new_bt = binarytree();
+	new_bt.pool = binarytree_pool_create(chunk_nodes);
+	return new_bt;
+}
+
+/**
+ * method constructor of a balanced tree holding sorted values, built in
+ * linear time. Values not in strictly ascending order are handled as by
+ * binarytree_from_array.
+ *
+ * @param const itemtype * values, the values in ascending order.
+ * @param size_t n, number of values.
+ *
+ * @returns a new BinaryTree type, empty if out of memory
+ */
+BinaryTree binarytree_from_sorted(const itemtype * values, size_t n){
+	BinaryTree new_tree = binarytree();
+	size_t i;
+	for(i = 1; i < n; i++){
+		if(!(values[i - 1] < values[i])){
+			return binarytree_from_array(values, n);
+		}
+	}
+	new_tree.root = buildBalanced(values, n);
+	return new_tree;
+}
+
+/**
+ * method constructor of a balanced tree holding the values of an unsorted
+ * buffer, duplicates are kept once. The buffer is copied, sorted and
+ * deduplicated, so it costs O(n log n) instead of n inserts.
+ *
+ * @param const itemtype * values, the values in any order.
+ * @param size_t n, number of values.
+ *
+ * @returns a new BinaryTree type, empty if out of memory
+ */
+BinaryTree binarytree_from_array(const itemtype * values, size_t n){
+	BinaryTree new_tree = binarytree();
+	itemtype * sorted;
+	size_t i, unique = 0;
+	if(n == 0){
+		return new_tree;
+	}
+	sorted = (itemtype*) malloc(n * sizeof(itemtype));
+	if(sorted == NULL){
+		return new_tree;
+	}
+	for(i = 0; i < n; i++){
+		sorted[i] = values[i];
+	}
+	qsort(sorted, n, sizeof(itemtype), compareItems);
+	for(i = 0; i < n; i++){
+		if(unique == 0 || sorted[unique - 1] < sorted[i]){
+			sorted[unique++] = sorted[i];
+		}
+	}
+	new_tree.root = buildBalanced(sorted, unique);
+	free(sorted);
+	return new_tree;
+}
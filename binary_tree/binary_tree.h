@@ -15,6 +15,9 @@
    <http://www.gnu.org/licenses/>
 */
 
+#ifndef BINARY_TREE_H
+#define BINARY_TREE_H
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -29,6 +32,53 @@ typedef struct node {
    struct node * left;
 }Node;
 
+/**
+ * Number of nodes carved from each chunk when a pool is created with 0.
+ */
+#define NODEPOOL_CHUNK 4096
+
+typedef struct nodechunk {
+   struct nodechunk * next;
+   Node nodes[];
+}NodeChunk;
+
+typedef struct nodepool {
+   NodeChunk * chunks;  /* every chunk owned by the pool, newest first */
+   Node * free_list;    /* removed nodes, linked through their left pointer */
+   size_t chunk_nodes;  /* nodes per chunk */
+   size_t used;         /* nodes already carved from the newest chunk */
+   size_t allocations;  /* number of malloc calls made by the pool */
+}NodePool;
+
+/**
+ * Order in which walk visits the nodes.
+ */
+typedef enum {PRE_ORDER, IN_ORDER, POS_ORDER} TraversalOrder;
+
+/**
+ * Callback of walk, called once per node with the context given to walk.
+ */
+typedef void (*NodeVisitor)(Node * node, void * context);
+
+/**
+ * Growable stack of nodes, a plain tree has no bound on its height.
+ */
+typedef struct nodestack {
+   Node ** items;
+   size_t top;
+   size_t capacity;
+}NodeStack;
+
+/**
+ * Position in a binary tree, see binarytree_cursor. The path from the root
+ * to the current node is kept on a NodeStack, so every step is O(1)
+ * amortized and nothing recurses. Inserting or removing invalidates it.
+ */
+typedef struct bstcursor {
+   Node * root;
+   NodeStack path;  /* path.items[path.top - 1] is the current node */
+}BstCursor;
+
 typedef struct binarytree {
    void (*insert)(Node ** tree, itemtype value); 
    Node* (*search)(Node * tree, itemtype value);
@@ -38,8 +88,136 @@ typedef struct binarytree {
    void (*preOrder)(Node * tree);
    void (*posOrder)(Node * tree);
    void (*inOrder)(Node * tree);
+   void (*insertPool)(NodePool * pool, Node ** tree, itemtype value);
+   bool (*removePool) (NodePool * pool, Node ** tree, itemtype value);
+   void (*release) (NodePool * pool, Node ** tree);
+   void (*searchBatch)(Node * tree, const itemtype * values, size_t n, Node ** out);
+   bool (*walk)(Node * tree, TraversalOrder order, NodeVisitor visit, void * context);
+   Node* (*lowerBound)(Node * tree, itemtype value);
+   Node* (*upperBound)(Node * tree, itemtype value);
+   Node* (*floor)(Node * tree, itemtype value);
+   Node* (*ceil)(Node * tree, itemtype value);
+   bool (*rangeScan)(Node * tree, itemtype lo, itemtype hi, NodeVisitor visit, void * context);
    Node * root;
+   NodePool * pool;
 }BinaryTree;
 
 
-public BinaryTree binarytree();
\ No newline at end of file
+public BinaryTree binarytree();
+
+/**
+ * method constructor of a tree whose nodes live in a NodePool
+ *
+ * @param size_t chunk_nodes, nodes per chunk, 0 for NODEPOOL_CHUNK.
+ *
+ * @returns a new BinaryTree type with its own pool
+ */
+public BinaryTree binarytree_pool(size_t chunk_nodes);
+
+/**
+ * create an empty node pool.
+ *
+ * @param size_t chunk_nodes, nodes per chunk, 0 for NODEPOOL_CHUNK.
+ *
+ * @returns a new pool or NULL if out of memory
+ */
+public NodePool * binarytree_pool_create(size_t chunk_nodes);
+
+/**
+ * give back every node of the pool at once, the pool stays usable.
+ *
+ * @param NodePool * pool, the pool to empty.
+ */
+public void binarytree_pool_release(NodePool * pool);
+
+/**
+ * release every node of the pool and the pool itself.
+ *
+ * @param NodePool * pool, the pool to destroy.
+ */
+public void binarytree_pool_destroy(NodePool * pool);
+
+/**
+ * method constructor of a balanced tree holding sorted values, built in
+ * linear time.
+ *
+ * @param const itemtype * values, the values in strictly ascending order.
+ * @param size_t n, number of values.
+ *
+ * @returns a new BinaryTree type, empty if out of memory
+ */
+public BinaryTree binarytree_from_sorted(const itemtype * values, size_t n);
+
+/**
+ * method constructor of a balanced tree holding the values of an unsorted
+ * buffer, duplicates are kept once.
+ *
+ * @param const itemtype * values, the values in any order.
+ * @param size_t n, number of values.
+ *
+ * @returns a new BinaryTree type, empty if out of memory
+ */
+public BinaryTree binarytree_from_array(const itemtype * values, size_t n);
+
+/**
+ * start a cursor on a tree, positioned nowhere until first, last or seek.
+ *
+ * @param BstCursor * cursor, the cursor.
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ */
+public void binarytree_cursor(BstCursor * cursor, Node * tree);
+
+/**
+ * free the path of a cursor, it can be started again afterwards.
+ *
+ * @param BstCursor * cursor, the cursor.
+ */
+public void binarytree_cursor_release(BstCursor * cursor);
+
+/**
+ * move a cursor to the lowest value.
+ *
+ * @param BstCursor * cursor, the cursor.
+ *
+ * @returns the current node, NULL if the tree is empty or out of memory
+ */
+public Node * binarytree_cursor_first(BstCursor * cursor);
+
+/**
+ * move a cursor to the highest value.
+ *
+ * @param BstCursor * cursor, the cursor.
+ *
+ * @returns the current node, NULL if the tree is empty or out of memory
+ */
+public Node * binarytree_cursor_last(BstCursor * cursor);
+
+/**
+ * move a cursor to the next value in ascending order.
+ *
+ * @param BstCursor * cursor, the cursor.
+ *
+ * @returns the current node, NULL past the highest value or out of memory
+ */
+public Node * binarytree_cursor_next(BstCursor * cursor);
+
+/**
+ * move a cursor to the previous value in ascending order.
+ *
+ * @param BstCursor * cursor, the cursor.
+ *
+ * @returns the current node, NULL before the lowest value or out of memory
+ */
+public Node * binarytree_cursor_prev(BstCursor * cursor);
+
+/**
+ * move a cursor to the lowest value not lower than value.
+ *
+ * @param BstCursor * cursor, the cursor.
+ * @param itemtype value, value searched.
+ *
+ * @returns the current node, NULL if every value is lower or out of memory
+ */
+public Node * binarytree_cursor_seek(BstCursor * cursor, itemtype value);
+
+#endif
@@ -0,0 +1,205 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "binary_tree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * monotonic clock in nanoseconds
+ *
+ * @returns the current time in nanoseconds
+ */
+static double now_ns(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * fill keys with a random permutation of 0 .. n-1
+ *
+ * @param itemtype * keys, the buffer to fill.
+ * @param size_t n, number of keys.
+ * @param unsigned long seed, seed of the xorshift generator.
+ */
+static void shuffled_keys(itemtype * keys, size_t n, unsigned long seed){
+	size_t i, j;
+	itemtype aux;
+	for (i = 0; i < n; i++){
+		keys[i] = (itemtype) i;
+	}
+	for (i = n; i > 1; i--){
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		j = seed % i;
+		aux = keys[i - 1];
+		keys[i - 1] = keys[j];
+		keys[j] = aux;
+	}
+}
+
+/**
+ * fill keys with random values over the whole itemtype range
+ *
+ * @param itemtype * keys, the buffer to fill.
+ * @param size_t n, number of keys.
+ * @param unsigned long seed, seed of the xorshift generator.
+ */
+static void random_keys(itemtype * keys, size_t n, unsigned long seed){
+	size_t i;
+	for (i = 0; i < n; i++){
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		keys[i] = (itemtype) (seed >> 32);
+	}
+}
+
+/**
+ * insert all keys, remove half of them, insert them again and tear the
+ * tree down, once through calloc and once through a NodePool.
+ *
+ * @param size_t n, number of keys.
+ */
+static void bench_pool(size_t n){
+	itemtype * keys = malloc(n * sizeof(itemtype));
+	BinaryTree plain = binarytree();
+	BinaryTree pooled = binarytree_pool(0);
+	double t0, t1, t2, t3;
+	size_t i;
+
+	shuffled_keys(keys, n, 88172645463325252UL);
+
+	t0 = now_ns();
+	for (i = 0; i < n; i++){
+		plain.insert(&plain.root, keys[i]);
+	}
+	t1 = now_ns();
+	for (i = 0; i < n / 2; i++){
+		plain.remove(&plain.root, keys[i]);
+	}
+	for (i = 0; i < n / 2; i++){
+		plain.insert(&plain.root, keys[i]);
+	}
+	t2 = now_ns();
+	plain.delete(plain.root);
+	t3 = now_ns();
+	printf("calloc: %zu allocations, %.1f ns/insert, %.1f ns/remove+insert, teardown %.3f ms\n",
+			n + n / 2, (t1 - t0) / n, (t2 - t1) / (n / 2 ? n / 2 : 1), (t3 - t2) / 1e6);
+
+	t0 = now_ns();
+	for (i = 0; i < n; i++){
+		pooled.insertPool(pooled.pool, &pooled.root, keys[i]);
+	}
+	t1 = now_ns();
+	for (i = 0; i < n / 2; i++){
+		pooled.removePool(pooled.pool, &pooled.root, keys[i]);
+	}
+	for (i = 0; i < n / 2; i++){
+		pooled.insertPool(pooled.pool, &pooled.root, keys[i]);
+	}
+	t2 = now_ns();
+	pooled.release(pooled.pool, &pooled.root);
+	t3 = now_ns();
+	printf("pool:   %zu allocations, %.1f ns/insert, %.1f ns/remove+insert, teardown %.3f ms\n",
+			pooled.pool->allocations, (t1 - t0) / n, (t2 - t1) / (n / 2 ? n / 2 : 1), (t3 - t2) / 1e6);
+
+	binarytree_pool_destroy(pooled.pool);
+	free(keys);
+}
+
+/**
+ * look up random keys, half of them present, in a tree
+ * of n even keys inserted in random order, one tree.search per key
+ * against tree.searchBatch over batches of several sizes.
+ *
+ * @param size_t n, number of keys.
+ */
+static void bench_search_batch(size_t n){
+	static const size_t sizes[] = {16, 64, 256, 1024};
+	const size_t queries = 4000000;
+	itemtype * keys = malloc(n * sizeof(itemtype));
+	itemtype * lookups = malloc(queries * sizeof(itemtype));
+	Node ** out = malloc(sizes[3] * sizeof(Node*));
+	BinaryTree tree = binarytree_pool(0);
+	double t0, t1;
+	long found = 0;
+	size_t i, j, s, m;
+
+	shuffled_keys(keys, n, 88172645463325252UL);
+	for (i = 0; i < n; i++){
+		tree.insertPool(tree.pool, &tree.root, 2 * keys[i]);
+	}
+	free(keys);
+	random_keys(lookups, queries, 2463534242UL);
+	for (i = 0; i < queries; i++){
+		lookups[i] = (itemtype) ((unsigned) lookups[i] % (2 * n));
+	}
+
+	t0 = now_ns();
+	for (i = 0; i < queries; i++){
+		found += tree.search(tree.root, lookups[i]) != NULL;
+	}
+	t1 = now_ns();
+	printf("%zu keys: per key loop %.2f Mlookups/s\n", n, queries / (t1 - t0) * 1e3);
+	for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++){
+		m = sizes[s];
+		t0 = now_ns();
+		for (i = 0; i + m <= queries; i += m){
+			tree.searchBatch(tree.root, lookups + i, m, out);
+			for (j = 0; j < m; j++){
+				found += out[j] != NULL;
+			}
+		}
+		t1 = now_ns();
+		printf("%zu keys: searchBatch of %4zu %.2f Mlookups/s\n", n, m, (queries - queries % m) / (t1 - t0) * 1e3);
+	}
+	printf("(%ld found)\n", found);
+
+	tree.release(tree.pool, &tree.root);
+	binarytree_pool_destroy(tree.pool);
+	free(out);
+	free(lookups);
+}
+
+/**
+ * Benchmark program
+ * usage: ./bench [pool|searchbatch] [keys]
+ *
+ */
+int main(int argc, char ** argv){
+	const char * mode = (argc > 1)? argv[1] : "pool";
+	size_t n = (argc > 2)? strtoul(argv[2], NULL, 10) : 1000000;
+
+	if (strcmp(mode, "pool") == 0){
+		bench_pool(n);
+	}
+	else if (strcmp(mode, "searchbatch") == 0){
+		bench_search_batch(n);
+	}
+	else{
+		fprintf(stderr, "unknown benchmark %s\n", mode);
+		return 1;
+	}
+	return 0;
+}
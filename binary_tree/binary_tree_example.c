@@ -24,8 +24,11 @@
  */
 int main(){
    Node * temp;
+   itemtype unsorted[] = {9, 4, 15, 6, 12, 3, 2, 9};
 
    BinaryTree tree = binarytree();
+   BinaryTree bulk;
+   BstCursor cursor;
    int h = 0;
 
    tree.insert(&tree.root, 9);
@@ -46,6 +49,15 @@ int main(){
    tree.posOrder(tree.root); 
    printf("\n\n");    
 
+   printf("Down from 10\n");
+   binarytree_cursor(&cursor, tree.root);
+   temp = binarytree_cursor_seek(&cursor, 10);
+   for(temp = binarytree_cursor_prev(&cursor); temp != NULL; temp = binarytree_cursor_prev(&cursor)){
+      printf("%d ", temp->value);
+   }
+   printf("\n\n");
+   binarytree_cursor_release(&cursor);
+
    temp = tree.search(tree.root, 12); 
    printf("Found element %d\n", temp->value);
 
@@ -58,5 +70,11 @@ int main(){
    printf("\n\n");      
    tree.delete(tree.root);
 
+   bulk = binarytree_from_array(unsorted, 8);
+   printf("Bulk Pre Order\n");
+   bulk.preOrder(bulk.root);
+   printf("\n\n");
+   bulk.delete(bulk.root);
+
    return 0;
 }
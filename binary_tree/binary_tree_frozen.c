@@ -0,0 +1,116 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+*/
+
+#include <stdlib.h>
+
+#include "binary_tree_frozen.h"
+#include "binary_tree_inline.h"
+
+/**
+ * in order walk of binarytree_freeze, the path kept on a NodeStack.
+ */
+typedef struct {
+	NodeStack stack;
+	Node * node;
+	bool ok;               /* the stack could always grow */
+}InOrderWalk;
+
+/**
+ * next value of an in order walk, the context of binarytree_freeze. Once
+ * the stack has held the deepest path of the tree it never grows again.
+ *
+ * @param void * context, an InOrderWalk.
+ *
+ * @returns the next value, the walk must not be past the last node
+ */
+private itemtype nextInOrder(void * context){
+	InOrderWalk * walk = (InOrderWalk*) context;
+	Node * node;
+	while(walk->node != NULL){
+		if(!bst_push(&walk->stack, walk->node)){
+			walk->ok = false;
+			walk->node = NULL;
+			walk->stack.top = 0;
+			return 0;
+		}
+		walk->node = walk->node->left;
+	}
+	node = walk->stack.items[--walk->stack.top];
+	walk->node = node->right;
+	return node->value;
+}
+
+/**
+ * The tree is only read: a first walk counts the nodes and grows the
+ * stack to the deepest path, the second copies the values with it.
+ */
+FrozenTree binarytree_freeze(const Node * tree){
+	InOrderWalk walk = {{NULL, 0, 0}, (Node*) tree, true};
+	FrozenTree frozen;
+	size_t n = 0;
+
+	while(walk.node != NULL || walk.stack.top > 0){
+		nextInOrder(&walk);
+		n++;
+	}
+	if(!walk.ok){
+		free(walk.stack.items);
+		return frozentree_from_sorted(NULL, 0);
+	}
+	walk.node = (Node*) tree;
+	frozen = frozentree_build(n, nextInOrder, &walk);
+	free(walk.stack.items);
+	return frozen;
+}
+
+FrozenStatus binarytree_save(const Node * tree, const char * path){
+	FrozenTree frozen = binarytree_freeze(tree);
+	FrozenStatus result;
+	if(tree != NULL && frozen.keys == NULL){
+		return FROZEN_ENOMEM;
+	}
+	result = frozentree_save(&frozen, path);
+	frozentree_free(&frozen);
+	return result;
+}
+
+/**
+ * The keys are copied out in order once and a balanced tree built from
+ * them as binarytree_from_sorted does, with no descent per key.
+ */
+FrozenStatus binarytree_load(const char * path, BinaryTree * tree){
+	FrozenTree frozen;
+	FrozenStatus result;
+	itemtype * sorted;
+
+	*tree = binarytree();
+	result = frozentree_load(path, 1, &frozen);
+	if(result != FROZEN_OK){
+		return result;
+	}
+	sorted = (itemtype*) malloc((frozen.n + 1) * sizeof(itemtype));
+	if(sorted == NULL){
+		frozentree_free(&frozen);
+		return FROZEN_ENOMEM;
+	}
+	frozentree_to_sorted(&frozen, sorted);
+	*tree = binarytree_from_sorted(sorted, frozen.n);
+	result = (tree->root == NULL && frozen.n > 0)? FROZEN_ENOMEM : FROZEN_OK;
+	free(sorted);
+	frozentree_free(&frozen);
+	return result;
+}
@@ -0,0 +1,66 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+*/
+
+/**
+ * FROZEN SNAPSHOTS OF BINARY TREES.
+ *
+ * Read-only copies of a BinaryTree in the Eytzinger layout of
+ * ../frozen_tree, in memory or saved to a checksummed file, and balanced
+ * trees built back from such a file. Kept apart from binary_tree.c so the
+ * tree builds without ../frozen_tree.
+ *
+ */
+#ifndef BINARY_TREE_FROZEN_H
+#define BINARY_TREE_FROZEN_H
+
+#include "binary_tree.h"
+#include "../frozen_tree/frozen_tree.h"
+
+/**
+ * read-only copy of a tree in Eytzinger order, searched with frozen_search
+ * and frozen_lower_bound of frozen_tree.h. The tree is only read, so it
+ * may keep serving searches meanwhile.
+ *
+ * @param const Node * tree, the root of the tree, is a Node type pointer.
+ *
+ * @returns a new FrozenTree, with no keys if out of memory
+ */
+public FrozenTree binarytree_freeze(const Node * tree);
+
+/**
+ * save a tree to a file as a frozen tree, see frozentree_save. Reading
+ * it back with frozentree_load serves lookups straight from the file.
+ *
+ * @param const Node * tree, the root of the tree, is a Node type pointer.
+ * @param const char * path, the file.
+ *
+ * @returns FROZEN_OK, FROZEN_ENOMEM or FROZEN_EIO
+ */
+public FrozenStatus binarytree_save(const Node * tree, const char * path);
+
+/**
+ * method constructor of a tree holding the keys of a file written by
+ * binarytree_save, checksum verified, built in linear time.
+ *
+ * @param const char * path, the file.
+ * @param BinaryTree * tree, receives the new tree, empty on failure.
+ *
+ * @returns FROZEN_OK or the reason the file was refused
+ */
+public FrozenStatus binarytree_load(const char * path, BinaryTree * tree);
+
+#endif
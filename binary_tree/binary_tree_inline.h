@@ -0,0 +1,250 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+*/
+
+/**
+ * INLINE READ PATH.
+ *
+ * static inline versions of the read-only operations of binary_tree.c,
+ * expanded into the caller instead of called through the BinaryTree
+ * function pointers. BinaryTree.search is a thin wrapper over bst_search.
+ * bst_push grows the NodeStack of the walks and cursors, shared with
+ * binary_tree_frozen.c.
+ *
+ */
+#ifndef BINARY_TREE_INLINE_H
+#define BINARY_TREE_INLINE_H
+
+#include "binary_tree.h"
+
+/**
+ * Search elements in binary tree.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, value to searched.
+ *
+ * @returns Node type pointer, Node referring to found element, NULL if absent.
+ */
+static inline Node * bst_search(Node * tree, itemtype value){
+   while(tree != NULL && value != tree->value){
+      tree = (value < tree->value)? tree->left : tree->right;
+   }
+   return tree;
+}
+
+/**
+ * check if a value is in the binary tree.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, value to searched.
+ *
+ * @returns true if the value is in the tree
+ */
+static inline bool bst_contains(Node * tree, itemtype value){
+   return bst_search(tree, value) != NULL;
+}
+
+/**
+ * node holding the lowest value.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ *
+ * @returns Node type pointer, NULL if the tree is empty.
+ */
+static inline Node * bst_min(Node * tree){
+   if(tree != NULL){
+      while(tree->left != NULL){
+         tree = tree->left;
+      }
+   }
+   return tree;
+}
+
+/**
+ * node holding the highest value.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ *
+ * @returns Node type pointer, NULL if the tree is empty.
+ */
+static inline Node * bst_max(Node * tree){
+   if(tree != NULL){
+      while(tree->right != NULL){
+         tree = tree->right;
+      }
+   }
+   return tree;
+}
+
+/**
+ * node holding the lowest value not lower than value.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns Node type pointer, NULL if every value is lower.
+ */
+static inline Node * bst_lower_bound(Node * tree, itemtype value){
+   Node * result = NULL;
+   while(tree != NULL){
+      if(tree->value < value){
+         tree = tree->right;
+      }
+      else{
+         result = tree;
+         tree = tree->left;
+      }
+   }
+   return result;
+}
+
+/**
+ * node holding the lowest value greater than value.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns Node type pointer, NULL if no value is greater.
+ */
+static inline Node * bst_upper_bound(Node * tree, itemtype value){
+   Node * result = NULL;
+   while(tree != NULL){
+      if(tree->value <= value){
+         tree = tree->right;
+      }
+      else{
+         result = tree;
+         tree = tree->left;
+      }
+   }
+   return result;
+}
+
+/**
+ * node holding the highest value not greater than value.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns Node type pointer, NULL if every value is greater.
+ */
+static inline Node * bst_floor(Node * tree, itemtype value){
+   Node * result = NULL;
+   while(tree != NULL){
+      if(value < tree->value){
+         tree = tree->left;
+      }
+      else{
+         result = tree;
+         tree = tree->right;
+      }
+   }
+   return result;
+}
+
+/**
+ * node holding the lowest value not lower than value, the same node as
+ * bst_lower_bound.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, the bound.
+ *
+ * @returns Node type pointer, NULL if every value is lower.
+ */
+static inline Node * bst_ceil(Node * tree, itemtype value){
+   return bst_lower_bound(tree, value);
+}
+
+/**
+ * Lookups advanced together by bst_search_batch. Each round moves every
+ * lookup of the group one level down, so up to this many cache misses are
+ * in flight at once. Can be set with -DBST_BATCH_GROUP=n.
+ */
+#ifndef BST_BATCH_GROUP
+#define BST_BATCH_GROUP 16
+#endif
+
+/**
+ * Search many elements in binary tree at once. The lookups of a group go
+ * down the tree in lockstep, each one prefetching the child it moves to,
+ * so the misses of different lookups overlap instead of queuing one behind
+ * the other.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param const itemtype * values, the values to search.
+ * @param size_t n, number of values.
+ * @param Node ** out, receives the node of each value, NULL if absent.
+ */
+static inline void bst_search_batch(Node * tree, const itemtype * values, size_t n, Node ** out){
+   Node * cursor[BST_BATCH_GROUP];
+   Node * node;
+   size_t base, i, group;
+   int active;
+
+   for(base = 0; base < n; base += group){
+      group = (n - base < BST_BATCH_GROUP)? n - base : BST_BATCH_GROUP;
+      for(i = 0; i < group; i++){
+         cursor[i] = tree;
+         out[base + i] = NULL;
+      }
+      do{
+         active = 0;
+         for(i = 0; i < group; i++){
+            node = cursor[i];
+            if(node == NULL){
+               continue;
+            }
+            if(values[base + i] == node->value){
+               out[base + i] = node;
+               cursor[i] = NULL;
+               continue;
+            }
+            node = (values[base + i] < node->value)? node->left : node->right;
+            if(node != NULL){
+               __builtin_prefetch(node);
+               active++;
+            }
+            cursor[i] = node;
+         }
+      } while(active > 0);
+   }
+}
+
+/**
+ * push a node on a NodeStack, doubling it when full.
+ *
+ * @param NodeStack * stack, the stack.
+ * @param Node * node, the node.
+ *
+ * @returns false if out of memory, the stack is left as it was
+ */
+static inline bool bst_push(NodeStack * stack, Node * node){
+   Node ** grown;
+   size_t capacity;
+   if(stack->top == stack->capacity){
+      capacity = (stack->capacity == 0)? 64 : 2 * stack->capacity;
+      grown = (Node**) realloc(stack->items, capacity * sizeof(Node*));
+      if(grown == NULL){
+         return false;
+      }
+      stack->items = grown;
+      stack->capacity = capacity;
+   }
+   stack->items[stack->top++] = node;
+   return true;
+}
+
+#endif
@@ -0,0 +1,140 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include <stdlib.h>
+
+#include "binary_tree_parallel.h"
+
+/**
+ * one fold of a subtree, forked or not.
+ */
+typedef struct {
+	ForkJoinPool * workers;
+	Node * tree;
+	int depth;             /* of tree below the root */
+	NodeVisitor visit;
+	size_t size;
+	FoldInit init;
+	FoldMerge merge;
+	void * accumulator;
+	bool ok;               /* no walk ran out of memory */
+}FoldTask;
+
+private void runFold(void * argument);
+
+/**
+ * fold a subtree: from BST_PARALLEL_DEPTH on walk it, above fork the
+ * right subtree into an accumulator of its own, fold the left one and
+ * the node here and merge.
+ *
+ * @param FoldTask * task, the subtree and the accumulator.
+ */
+private void fold(FoldTask * task){
+	BinaryTree ops;
+	FoldTask right;
+	ForkJoinJob job;
+	Node * tree = task->tree;
+
+	if(task->workers == NULL || task->depth >= BST_PARALLEL_DEPTH || tree == NULL || tree->right == NULL){
+		ops = binarytree();
+		task->ok = ops.walk(tree, IN_ORDER, task->visit, task->accumulator) && task->ok;
+		return;
+	}
+	right = *task;
+	right.tree = tree->right;
+	right.depth = task->depth + 1;
+	right.ok = true;
+	if(task->size > 0){
+		right.accumulator = malloc(task->size);
+		if(right.accumulator == NULL){
+			task->workers = NULL;
+			fold(task);
+			return;
+		}
+		task->init(right.accumulator);
+	}
+	forkjoin_fork(task->workers, &job, runFold, &right);
+	task->tree = tree->left;
+	task->depth++;
+	fold(task);
+	task->visit(tree, task->accumulator);
+	forkjoin_join(task->workers, &job);
+	task->ok = task->ok && right.ok;
+	if(task->size > 0){
+		task->merge(task->accumulator, right.accumulator);
+		free(right.accumulator);
+	}
+}
+
+/**
+ * body of a forked fold.
+ *
+ * @param void * argument, the FoldTask.
+ */
+private void runFold(void * argument){
+	fold((FoldTask*) argument);
+}
+
+bool binarytree_fold_parallel(ForkJoinPool * workers, Node * tree, NodeVisitor visit, size_t size, FoldInit init, FoldMerge merge, void * accumulator){
+	FoldTask task;
+	task.workers = (workers != NULL && workers->workers > 0)? workers : NULL;
+	task.tree = tree;
+	task.depth = 0;
+	task.visit = visit;
+	task.size = size;
+	task.init = init;
+	task.merge = merge;
+	task.accumulator = accumulator;
+	task.ok = true;
+	fold(&task);
+	return task.ok;
+}
+
+/**
+ * free a subtree, forking the right subtree of nodes not deep enough.
+ * Deeper subtrees go to tree.delete, which needs no stack.
+ *
+ * @param void * argument, the FoldTask, only workers, tree and depth are used.
+ */
+private void teardown(void * argument){
+	FoldTask * task = (FoldTask*) argument;
+	FoldTask right;
+	ForkJoinJob job;
+	Node * tree = task->tree;
+
+	if(task->workers == NULL || task->depth >= BST_PARALLEL_DEPTH || tree == NULL || tree->right == NULL){
+		binarytree().delete(tree);
+		return;
+	}
+	right.workers = task->workers;
+	right.tree = tree->right;
+	right.depth = task->depth + 1;
+	forkjoin_fork(task->workers, &job, teardown, &right);
+	task->tree = tree->left;
+	task->depth++;
+	teardown(task);
+	forkjoin_join(task->workers, &job);
+	free(tree);
+}
+
+void binarytree_delete_parallel(ForkJoinPool * workers, Node * tree){
+	FoldTask task;
+	task.workers = (workers != NULL && workers->workers > 0)? workers : NULL;
+	task.tree = tree;
+	task.depth = 0;
+	teardown(&task);
+}
@@ -0,0 +1,82 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+/**
+ * PARALLEL OPERATIONS ON BINARY TREES.
+ *
+ * Folds and teardown of a whole BinaryTree on a ForkJoinPool of
+ * ../fork_join. A plain tree keeps neither heights nor sizes, so the
+ * right subtree of every node less than BST_PARALLEL_DEPTH deep is
+ * forked, deeper subtrees are walked where they are. Random trees split
+ * evenly this way; a degenerate one forks little and runs mostly on the
+ * caller.
+ *
+ */
+#ifndef BINARY_TREE_PARALLEL_H
+#define BINARY_TREE_PARALLEL_H
+
+#include "binary_tree.h"
+#include "../fork_join/fork_join.h"
+
+/**
+ * Right subtrees of nodes at depths below this are forked, up to
+ * 2^BST_PARALLEL_DEPTH - 1 tasks.
+ */
+#define BST_PARALLEL_DEPTH 10
+
+/**
+ * Start of an accumulator, see binarytree_fold_parallel.
+ */
+typedef void (*FoldInit)(void * accumulator);
+
+/**
+ * Add to an accumulator what another gathered over the values right of
+ * it, see binarytree_fold_parallel.
+ */
+typedef void (*FoldMerge)(void * accumulator, void * other);
+
+/**
+ * fold a tree in ascending order into an accumulator, forking subtrees.
+ * visit(node, accumulator) is called once per node; a forked subtree is
+ * folded into an accumulator of its own, size bytes started with init,
+ * then merged into the one of the values left of it, so visit and merge
+ * only need to be associative. With size 0 there is no accumulator of
+ * its own: every visit gets the accumulator given, possibly from several
+ * threads at once, and init and merge are not used.
+ *
+ * @param ForkJoinPool * workers, the threads, NULL to run on the caller only.
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param NodeVisitor visit, called once per node.
+ * @param size_t size, bytes of an accumulator, 0 for none.
+ * @param FoldInit init, starts an accumulator.
+ * @param FoldMerge merge, adds the second accumulator to the first.
+ * @param void * accumulator, the result, started by the caller.
+ *
+ * @returns false if a walk ran out of memory, some nodes were not visited
+ */
+public bool binarytree_fold_parallel(ForkJoinPool * workers, Node * tree, NodeVisitor visit, size_t size, FoldInit init, FoldMerge merge, void * accumulator);
+
+/**
+ * tree.delete freeing subtrees on several threads, for trees whose nodes
+ * came from calloc; a pooled tree is released at once by tree.release.
+ *
+ * @param ForkJoinPool * workers, the threads, NULL to run on the caller only.
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ */
+public void binarytree_delete_parallel(ForkJoinPool * workers, Node * tree);
+
+#endif
@@ -0,0 +1,204 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "binary_tree_parallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/**
+ * Each time printed is the best of RUNS.
+ */
+#define RUNS 3
+
+/**
+ * monotonic clock in nanoseconds
+ *
+ * @returns the current time in nanoseconds
+ */
+static double now_ns(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * fill keys with random values in [0, range)
+ *
+ * @param itemtype * keys, the buffer to fill.
+ * @param size_t n, number of keys.
+ * @param size_t range, bound of the values.
+ * @param unsigned long seed, seed of the xorshift generator.
+ */
+static void random_keys(itemtype * keys, size_t n, size_t range, unsigned long seed){
+	size_t i;
+	for (i = 0; i < n; i++){
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		keys[i] = (itemtype) ((seed >> 32) % range);
+	}
+}
+
+/**
+ * build a tree of calloc nodes, as tree.delete needs: the keys inserted
+ * in their order, or 0 .. n-1 inserted in ascending order. The ascending
+ * tree is the chain of right children such inserts leave, each key put
+ * below the last node instead of descending the whole chain.
+ *
+ * @param BinaryTree * ops, the operations.
+ * @param const itemtype * keys, the random keys.
+ * @param size_t n, number of keys.
+ * @param bool ascending, build the ascending chain instead.
+ *
+ * @returns the root of the tree, a Node type pointer.
+ */
+static Node * build(BinaryTree * ops, const itemtype * keys, size_t n, bool ascending){
+	Node * tree = NULL;
+	Node * last;
+	size_t i;
+	if (!ascending){
+		for (i = 0; i < n; i++){
+			ops->insert(&tree, keys[i]);
+		}
+		return tree;
+	}
+	ops->insert(&tree, 0);
+	for (i = 1, last = tree; i < n && last != NULL; i++, last = last->right){
+		ops->insert(&last->right, (itemtype) i);
+	}
+	return tree;
+}
+
+/**
+ * fold visitor of the sums, the accumulator is a long long.
+ */
+static void sum(Node * node, void * accumulator){
+	*(long long*) accumulator += node->value;
+}
+
+/**
+ * FoldInit of the sums.
+ */
+static void sum_init(void * accumulator){
+	*(long long*) accumulator = 0;
+}
+
+/**
+ * FoldMerge of the sums.
+ */
+static void sum_merge(void * accumulator, void * other){
+	*(long long*) accumulator += *(long long*) other;
+}
+
+/**
+ * sum the values of a tree of n keys and tear it down, with tree.walk
+ * and tree.delete against binarytree_fold_parallel and
+ * binarytree_delete_parallel on 1, 2, 4 ... up to max threads.
+ *
+ * @param size_t n, number of keys.
+ * @param int max_threads, the most threads tried.
+ * @param bool ascending, a tree of keys inserted in ascending order
+ *        instead of random ones.
+ */
+static void bench_fold(size_t n, int max_threads, bool ascending){
+	BinaryTree ops = binarytree();
+	itemtype * keys = malloc(n * sizeof(itemtype));
+	ForkJoinPool * workers;
+	Node * tree;
+	long long total, check = 0;
+	double best[2], t0, t1;
+	int threads, run;
+
+	random_keys(keys, n, 2 * n, 88172645463325252UL);
+	if (ascending){
+		printf("%zu keys inserted in ascending order, best of %d runs\n", n, RUNS);
+	}
+	else{
+		printf("%zu random keys in [0, %zu), best of %d runs\n", n, 2 * n, RUNS);
+	}
+	for (threads = 0; threads <= max_threads; threads = threads ? 2 * threads : 1){
+		workers = threads ? forkjoin_create(threads - 1) : NULL;
+		best[0] = best[1] = 1e300;
+		for (run = 0; run < RUNS; run++){
+			tree = build(&ops, keys, n, ascending);
+			total = 0;
+			t0 = now_ns();
+			if (workers == NULL){
+				ops.walk(tree, IN_ORDER, sum, &total);
+			}
+			else{
+				binarytree_fold_parallel(workers, tree, sum, sizeof(total), sum_init, sum_merge, &total);
+			}
+			t1 = now_ns();
+			best[0] = fmin(best[0], (t1 - t0) / 1e6);
+			if (threads == 0 && run == 0){
+				check = total;
+			}
+			else if (total != check){
+				fprintf(stderr, "sum %lld, expected %lld\n", total, check);
+			}
+			t0 = now_ns();
+			if (workers == NULL){
+				ops.delete(tree);
+			}
+			else{
+				binarytree_delete_parallel(workers, tree);
+			}
+			t1 = now_ns();
+			best[1] = fmin(best[1], (t1 - t0) / 1e6);
+		}
+		if (workers == NULL){
+			printf("walk     sum %7.1f ms   delete          %7.1f ms\n", best[0], best[1]);
+		}
+		else{
+			printf("%2d: fold sum %7.1f ms   delete_parallel %7.1f ms\n", threads, best[0], best[1]);
+			forkjoin_destroy(workers);
+		}
+		fflush(stdout);
+	}
+	free(keys);
+}
+
+/**
+ * Benchmark program
+ * usage: ./parallel fold [keys] [max threads]
+ *
+ * Runs the fold and teardown on a random tree, then on the chain left by
+ * ascending inserts, where the forks by depth fall back to one thread.
+ *
+ */
+int main(int argc, char ** argv){
+	const char * mode = (argc > 1)? argv[1] : "fold";
+	size_t n = (argc > 2)? strtoul(argv[2], NULL, 10) : 1000000;
+	int max_threads = (argc > 3)? atoi(argv[3]) : 8;
+
+	if (strcmp(mode, "fold") == 0){
+		bench_fold(n, max_threads, false);
+		printf("\n");
+		bench_fold(n, max_threads, true);
+	}
+	else{
+		fprintf(stderr, "unknown benchmark %s\n", mode);
+		return 1;
+	}
+	return 0;
+}
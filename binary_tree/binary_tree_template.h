@@ -0,0 +1,200 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+*/
+
+/**
+ * BINARY TREE TEMPLATE.
+ *
+ * BST_DEFINE(name, key_t, cmp) generates a binary search tree specialized
+ * for one key type: a name_node type and static inline functions
+ * name_insert, name_search, name_remove, name_height, name_walk and
+ * name_delete. cmp(a, b) returns a negative, zero or positive int as a is
+ * lower, equal or greater than b and is inlined into every descent.
+ *
+ * Nothing recurses, so a degenerate tree of any depth is fine: name_walk
+ * and name_height keep their path on a heap stack and never write to
+ * the tree.
+ *
+ *    BST_DEFINE(prices, double, BST_CMP_SCALAR)
+ *
+ *    prices_node * root = NULL;
+ *    prices_insert(&root, 9.5);
+ */
+#ifndef BINARY_TREE_TEMPLATE_H
+#define BINARY_TREE_TEMPLATE_H
+
+#include <stdlib.h>
+
+/**
+ * comparison of any type ordered by < and >
+ */
+#define BST_CMP_SCALAR(a, b) (((a) > (b)) - ((a) < (b)))
+
+#define BST_DEFINE(name, key_t, cmp)                                           \
+                                                                               \
+typedef struct name##_node {                                                   \
+   key_t value;                                                                \
+   struct name##_node * right;                                                 \
+   struct name##_node * left;                                                  \
+}name##_node;                                                                  \
+                                                                               \
+/* node holding value, NULL if absent */                                       \
+static inline name##_node * name##_search(name##_node * tree, key_t value){   \
+   int c;                                                                      \
+   while(tree != NULL && (c = cmp(value, tree->value)) != 0){                  \
+      tree = (c < 0)? tree->left : tree->right;                                \
+   }                                                                           \
+   return tree;                                                                \
+}                                                                              \
+                                                                               \
+/* insert value, 1 if inserted, 0 if present or out of memory */               \
+static inline int name##_insert(name##_node ** tree, key_t value){            \
+   int c;                                                                      \
+   while(*tree != NULL){                                                       \
+      if((c = cmp(value, (*tree)->value)) == 0){                               \
+         return 0;                                                             \
+      }                                                                        \
+      tree = (c < 0)? &(*tree)->left : &(*tree)->right;                        \
+   }                                                                           \
+   *tree = (name##_node*) malloc(sizeof(name##_node));                         \
+   if(*tree == NULL){                                                          \
+      return 0;                                                                \
+   }                                                                           \
+   (*tree)->value = value;                                                     \
+   (*tree)->left = NULL;                                                       \
+   (*tree)->right = NULL;                                                      \
+   return 1;                                                                   \
+}                                                                              \
+                                                                               \
+/* remove value, 1 if removed, 0 if absent */                                  \
+static inline int name##_remove(name##_node ** tree, key_t value){            \
+   name##_node * found;                                                        \
+   name##_node * temp;                                                         \
+   int c;                                                                      \
+   while(*tree != NULL && (c = cmp(value, (*tree)->value)) != 0){              \
+      tree = (c < 0)? &(*tree)->left : &(*tree)->right;                        \
+   }                                                                           \
+   if(*tree == NULL){                                                          \
+      return 0;                                                                \
+   }                                                                           \
+   found = *tree;                                                              \
+   if(found->left != NULL && found->right != NULL){                            \
+      tree = &found->right;                                                    \
+      while((*tree)->left != NULL){                                            \
+         tree = &(*tree)->left;                                                \
+      }                                                                        \
+      found->value = (*tree)->value;                                           \
+   }                                                                           \
+   temp = *tree;                                                               \
+   *tree = (temp->left != NULL)? temp->left : temp->right;                     \
+   free(temp);                                                                 \
+   return 1;                                                                   \
+}                                                                              \
+                                                                               \
+/* push a node on a stack grown by doubling, 0 if out of memory */             \
+static inline int name##_push(name##_node *** stack, size_t * top,             \
+      size_t * capacity, name##_node * node){                                  \
+   name##_node ** grown;                                                       \
+   size_t size;                                                                \
+   if(*top == *capacity){                                                      \
+      size = (*capacity == 0)? 64 : 2 * *capacity;                             \
+      grown = (name##_node**) realloc(*stack, size * sizeof(name##_node*));    \
+      if(grown == NULL){                                                       \
+         return 0;                                                             \
+      }                                                                        \
+      *stack = grown;                                                          \
+      *capacity = size;                                                        \
+   }                                                                           \
+   (*stack)[(*top)++] = node;                                                  \
+   return 1;                                                                   \
+}                                                                              \
+                                                                               \
+/* call visit on every value in ascending order, 1 when done, 0 if out of      \
+   memory. The path is kept on a heap stack and the tree only read, so         \
+   readers may walk it together and visit may search it, not change it */      \
+static inline int name##_walk(name##_node * tree,                              \
+      void (*visit)(key_t * value, void * context), void * context){           \
+   name##_node ** stack = NULL;                                                \
+   name##_node * node;                                                         \
+   size_t top = 0, capacity = 0;                                               \
+   int ok = 1;                                                                 \
+   while(ok && (tree != NULL || top > 0)){                                     \
+      while(ok && tree != NULL){                                               \
+         ok = name##_push(&stack, &top, &capacity, tree);                      \
+         tree = tree->left;                                                    \
+      }                                                                        \
+      if(ok){                                                                  \
+         node = stack[--top];                                                  \
+         tree = node->right;                                                   \
+         visit(&node->value, context);                                         \
+      }                                                                        \
+   }                                                                           \
+   free(stack);                                                                \
+   return ok;                                                                  \
+}                                                                              \
+                                                                               \
+/* height of the tree, -1 if out of memory. A post order walk keeps the        \
+   whole path on a heap stack, its deepest size is the height */               \
+static inline int name##_height(name##_node * tree){                           \
+   name##_node ** stack = NULL;                                                \
+   name##_node * node;                                                         \
+   name##_node * last = NULL;                                                  \
+   size_t top = 0, capacity = 0, result = 0;                                   \
+   while(tree != NULL || top > 0){                                             \
+      if(tree != NULL){                                                        \
+         if(!name##_push(&stack, &top, &capacity, tree)){                      \
+            free(stack);                                                       \
+            return -1;                                                         \
+         }                                                                     \
+         if(top > result){                                                     \
+            result = top;                                                      \
+         }                                                                     \
+         tree = tree->left;                                                    \
+      }                                                                        \
+      else{                                                                    \
+         node = stack[top - 1];                                                \
+         if(node->right != NULL && node->right != last){                       \
+            tree = node->right;                                                \
+         }                                                                     \
+         else{                                                                 \
+            top--;                                                             \
+            last = node;                                                       \
+         }                                                                     \
+      }                                                                        \
+   }                                                                           \
+   free(stack);                                                                \
+   return (int) result;                                                        \
+}                                                                              \
+                                                                               \
+/* free every node, rotating left children up instead of recursing */          \
+static inline void name##_delete(name##_node * tree){                         \
+   name##_node * aux;                                                          \
+   while(tree != NULL){                                                        \
+      if(tree->left != NULL){                                                  \
+         aux = tree->left;                                                     \
+         tree->left = aux->right;                                              \
+         aux->right = tree;                                                    \
+         tree = aux;                                                           \
+      }                                                                        \
+      else{                                                                    \
+         aux = tree->right;                                                    \
+         free(tree);                                                           \
+         tree = aux;                                                           \
+      }                                                                        \
+   }                                                                           \
+}
+
+#endif
@@ -0,0 +1,68 @@
+/*
+   The C programming language includes a very limited standard library in
+   comparison to other modern programming languages.  This is a collection of
+   common Computer Science algorithms which may be used in C projects.
+
+   Copyright (C) 2016, Guilherme Castro Diniz.
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation (FSF); in version 2 of the
+   license.
+   This program is distributed in the hope that it can be useful,
+   but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+   MARKET OR APPLICATION IN PARTICULAR. See the
+   GNU General Public License for more details.
+   <http://www.gnu.org/licenses/>
+*/
+
+#include "binary_tree_template.h"
+#include <stdio.h>
+#include <stdint.h>
+
+BST_DEFINE(ids, uint64_t, BST_CMP_SCALAR)
+BST_DEFINE(prices, double, BST_CMP_SCALAR)
+
+static void print_id(uint64_t * value, void * context){
+   (void) context;
+   printf("%llu ", (unsigned long long) *value);
+}
+
+static void print_price(double * value, void * context){
+   (void) context;
+   printf("%.2f ", *value);
+}
+
+/**
+ * Main program
+ * Two specialized binary trees in the same program
+ *
+ */
+int main(){
+   ids_node * ids = NULL;
+   prices_node * prices = NULL;
+
+   ids_insert(&ids, 18446744073709551557ULL);
+   ids_insert(&ids, 42);
+   ids_insert(&ids, 4294967296ULL);
+
+   prices_insert(&prices, 9.99);
+   prices_insert(&prices, 0.5);
+   prices_insert(&prices, 120.0);
+   prices_remove(&prices, 9.99);
+
+   printf("ids: ");
+   ids_walk(ids, print_id, NULL);
+   printf("\nprices: ");
+   prices_walk(prices, print_price, NULL);
+   printf("\n\n");
+
+   if(ids_search(ids, 42) != NULL){
+      printf("Found element 42\n");
+   }
+   printf("height: %d\n", ids_height(ids));
+
+   ids_delete(ids);
+   prices_delete(prices);
+
+   return 0;
+}
@@ -0,0 +1,439 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "btree.h"
+
+/**
+ * createNode allocates an empty node on its own cache lines
+ *
+ * @param bool leaf, true for a leaf node.
+ *
+ * @returns a new node, a pointer of type node
+ */
+private BTreeNode * createNode(bool leaf){
+	BTreeNode * aux;
+	aux = (BTreeNode*) aligned_alloc(_Alignof(BTreeNode), sizeof(BTreeNode));
+	if(aux == NULL){
+		return NULL;
+	}
+	memset(aux, 0, sizeof(BTreeNode));
+	aux->leaf = leaf;
+	return aux;
+}
+
+/**
+ * number of keys of a node lower than value, which is the position of
+ * value in the node or the child to descend into. All 16 slots are compared
+ * at once and the slots past count are masked out of the result.
+ *
+ * @param BTreeNode * node, the node.
+ * @param itemtype value, value searched.
+ *
+ * @returns the rank of value among the keys of node
+ */
+private inline int rank(BTreeNode * node, itemtype value){
+#if defined(__AVX2__)
+	__m256i needle = _mm256_set1_epi32(value);
+	__m256i low = _mm256_load_si256((const __m256i*) &node->keys[0]);
+	__m256i high = _mm256_load_si256((const __m256i*) &node->keys[8]);
+	unsigned mask = (unsigned) _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(needle, low)))
+			| (unsigned) _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(needle, high))) << 8;
+	return __builtin_popcount(mask & ((1u << node->count) - 1));
+#elif defined(__SSE2__)
+	__m128i needle = _mm_set1_epi32(value);
+	const __m128i * keys = (const __m128i*) node->keys;
+	unsigned mask = (unsigned) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(needle, _mm_load_si128(keys))))
+			| (unsigned) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(needle, _mm_load_si128(keys + 1)))) << 4
+			| (unsigned) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(needle, _mm_load_si128(keys + 2)))) << 8
+			| (unsigned) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(needle, _mm_load_si128(keys + 3)))) << 12;
+	return __builtin_popcount(mask & ((1u << node->count) - 1));
+#else
+	int i, result = 0;
+	for(i = 0; i < node->count; i++){
+		result += node->keys[i] < value;
+	}
+	return result;
+#endif
+}
+
+/**
+ * split the full child i of a node around its median key, which moves up
+ * into the node.
+ *
+ * @param BTreeNode * node, a node that is not full.
+ * @param int i, position of the full child.
+ *
+ * @returns false if out of memory
+ */
+private bool splitChild(BTreeNode * node, int i){
+	BTreeNode * full = node->children[i];
+	BTreeNode * half = createNode(full->leaf);
+	if(half == NULL){
+		return false;
+	}
+	half->count = BTREE_T - 1;
+	memcpy(half->keys, &full->keys[BTREE_T], (BTREE_T - 1) * sizeof(itemtype));
+	if(!full->leaf){
+		memcpy(half->children, &full->children[BTREE_T], BTREE_T * sizeof(BTreeNode*));
+	}
+	full->count = BTREE_T - 1;
+
+	memmove(&node->children[i + 2], &node->children[i + 1], (node->count - i) * sizeof(BTreeNode*));
+	memmove(&node->keys[i + 1], &node->keys[i], (node->count - i) * sizeof(itemtype));
+	node->children[i + 1] = half;
+	node->keys[i] = full->keys[BTREE_T - 1];
+	node->count++;
+	return true;
+}
+
+/**
+ * Insert elements in b-tree.
+ * Full nodes are split on the way down, so the key always lands in a leaf
+ * with room and nothing has to be walked back up.
+ *
+ * @param BTreeNode ** tree, the root of the tree, is a BTreeNode type pointer.
+ * @param itemtype value, value to insert.
+ *
+ * @returns by parameter the tree with the new element.
+ */
+private void insert(BTreeNode ** tree, itemtype value){
+	BTreeNode * node;
+	BTreeNode * top;
+	int i;
+
+	if(*tree == NULL){
+		*tree = createNode(true);
+		if(*tree == NULL){
+			return;
+		}
+	}
+	if((*tree)->count == BTREE_MAX_KEYS){
+		top = createNode(false);
+		if(top == NULL){
+			return;
+		}
+		top->children[0] = *tree;
+		if(!splitChild(top, 0)){
+			free(top);
+			return;
+		}
+		*tree = top;
+	}
+	node = *tree;
+	for(;;){
+		i = rank(node, value);
+		if(i < node->count && node->keys[i] == value){
+			return;
+		}
+		if(node->leaf){
+			memmove(&node->keys[i + 1], &node->keys[i], (node->count - i) * sizeof(itemtype));
+			node->keys[i] = value;
+			node->count++;
+			return;
+		}
+		if(node->children[i]->count == BTREE_MAX_KEYS){
+			if(!splitChild(node, i)){
+				return;
+			}
+			if(value == node->keys[i]){
+				return;
+			}
+			if(value > node->keys[i]){
+				i++;
+			}
+		}
+		node = node->children[i];
+	}
+}
+
+/**
+ * Search elements in b-tree.
+ *
+ * @param BTreeNode * tree, the root of the tree, is a BTreeNode type pointer.
+ * @param itemtype value, value to searched.
+ *
+ * @returns BTreeNode type pointer, the node holding the element, NULL if absent.
+ */
+private BTreeNode * search(BTreeNode * tree, itemtype value){
+	int i;
+	while(tree != NULL){
+		i = rank(tree, value);
+		if(i < tree->count && tree->keys[i] == value){
+			return tree;
+		}
+		tree = tree->leaf ? NULL : tree->children[i];
+	}
+	return NULL;
+}
+
+/**
+ * merge child i + 1 of a node and the key between them into child i.
+ *
+ * @param BTreeNode * node, the parent, loses one key.
+ * @param int i, position of the left child.
+ */
+private void mergeChildren(BTreeNode * node, int i){
+	BTreeNode * left = node->children[i];
+	BTreeNode * right = node->children[i + 1];
+
+	left->keys[left->count] = node->keys[i];
+	memcpy(&left->keys[left->count + 1], right->keys, right->count * sizeof(itemtype));
+	if(!left->leaf){
+		memcpy(&left->children[left->count + 1], right->children, (right->count + 1) * sizeof(BTreeNode*));
+	}
+	left->count += right->count + 1;
+
+	memmove(&node->keys[i], &node->keys[i + 1], (node->count - i - 1) * sizeof(itemtype));
+	memmove(&node->children[i + 1], &node->children[i + 2], (node->count - i - 1) * sizeof(BTreeNode*));
+	node->count--;
+	free(right);
+}
+
+/**
+ * give child i of a node at least BTREE_T keys before descending into it,
+ * borrowing a key through the parent from a sibling that can spare one or
+ * merging with a sibling otherwise.
+ *
+ * @param BTreeNode * node, the parent.
+ * @param int i, position of the child.
+ *
+ * @returns the position of the child to descend into
+ */
+private int fillChild(BTreeNode * node, int i){
+	BTreeNode * child = node->children[i];
+	BTreeNode * sibling;
+
+	if(i > 0 && node->children[i - 1]->count >= BTREE_T){
+		sibling = node->children[i - 1];
+		memmove(&child->keys[1], child->keys, child->count * sizeof(itemtype));
+		if(!child->leaf){
+			memmove(&child->children[1], child->children, (child->count + 1) * sizeof(BTreeNode*));
+			child->children[0] = sibling->children[sibling->count];
+		}
+		child->keys[0] = node->keys[i - 1];
+		node->keys[i - 1] = sibling->keys[sibling->count - 1];
+		child->count++;
+		sibling->count--;
+		return i;
+	}
+	if(i < node->count && node->children[i + 1]->count >= BTREE_T){
+		sibling = node->children[i + 1];
+		child->keys[child->count] = node->keys[i];
+		if(!child->leaf){
+			child->children[child->count + 1] = sibling->children[0];
+			memmove(sibling->children, &sibling->children[1], sibling->count * sizeof(BTreeNode*));
+		}
+		node->keys[i] = sibling->keys[0];
+		memmove(sibling->keys, &sibling->keys[1], (sibling->count - 1) * sizeof(itemtype));
+		child->count++;
+		sibling->count--;
+		return i;
+	}
+	if(i == node->count){
+		i--;
+	}
+	mergeChildren(node, i);
+	return i;
+}
+
+/**
+ * remove elements in b-tree.
+ * Every node entered on the way down has at least BTREE_T keys, so a key
+ * can always be taken out of a leaf without walking back up.
+ *
+ * @param BTreeNode ** tree, the root of the tree, is a BTreeNode type pointer.
+ * @param itemtype value, value to remove.
+ *
+ * @returns true if element removed or false if element not remove.
+ */
+private bool removeValue(BTreeNode ** tree, itemtype value){
+	BTreeNode * node = *tree;
+	BTreeNode * next;
+	bool removed = false;
+	int i;
+
+	while(node != NULL){
+		i = rank(node, value);
+		if(i < node->count && node->keys[i] == value){
+			if(node->leaf){
+				memmove(&node->keys[i], &node->keys[i + 1], (node->count - i - 1) * sizeof(itemtype));
+				node->count--;
+				removed = true;
+				break;
+			}
+			if(node->children[i]->count >= BTREE_T){
+				next = node->children[i];
+				while(!next->leaf){
+					next = next->children[next->count];
+				}
+				value = node->keys[i] = next->keys[next->count - 1];
+				node = node->children[i];
+			}
+			else if(node->children[i + 1]->count >= BTREE_T){
+				next = node->children[i + 1];
+				while(!next->leaf){
+					next = next->children[0];
+				}
+				value = node->keys[i] = next->keys[0];
+				node = node->children[i + 1];
+			}
+			else{
+				mergeChildren(node, i);
+				node = node->children[i];
+			}
+			continue;
+		}
+		if(node->leaf){
+			break;
+		}
+		if(node->children[i]->count < BTREE_T){
+			i = fillChild(node, i);
+		}
+		node = node->children[i];
+	}
+
+	node = *tree;
+	if(node != NULL && node->count == 0){
+		*tree = node->leaf ? NULL : node->children[0];
+		free(node);
+	}
+	return removed;
+}
+
+/**
+ * get height of b-tree, every leaf is at the same depth.
+ *
+ * @param BTreeNode ** tree, the root of the tree, is a BTreeNode type pointer.
+ *
+ * @returns a integer type, is the number of levels of tree
+ */
+private int height(BTreeNode ** tree){
+	BTreeNode * node = *tree;
+	int result = 0;
+	while(node != NULL){
+		result++;
+		node = node->leaf ? NULL : node->children[0];
+	}
+	return result;
+}
+
+/**
+ * Delete and free memory of b-tree.
+ *
+ * @param BTreeNode * tree, the root of the tree, is a BTreeNode type pointer.
+ *
+ */
+private void delete_tree(BTreeNode * tree){
+	int i;
+	if(tree != NULL){
+		if(!tree->leaf){
+			for(i = 0; i <= tree->count; i++){
+				delete_tree(tree->children[i]);
+			}
+		}
+		free(tree);
+	}
+}
+
+/**
+ * Print b-tree in preorder form, the keys of a node before its children.
+ *
+ * @param BTreeNode * tree, the root of the tree, is a BTreeNode type pointer.
+ *
+ */
+private void print_pre_order(BTreeNode * tree){
+	int i;
+	if(tree != NULL){
+		for(i = 0; i < tree->count; i++){
+			printf("%d ", tree->keys[i]);
+		}
+		if(!tree->leaf){
+			for(i = 0; i <= tree->count; i++){
+				print_pre_order(tree->children[i]);
+			}
+		}
+	}
+}
+
+/**
+ * Print b-tree in inorder form.
+ *
+ * @param BTreeNode * tree, the root of the tree, is a BTreeNode type pointer.
+ *
+ */
+private void print_in_order(BTreeNode * tree){
+	int i;
+	if(tree != NULL){
+		for(i = 0; i < tree->count; i++){
+			if(!tree->leaf){
+				print_in_order(tree->children[i]);
+			}
+			printf("%d ", tree->keys[i]);
+		}
+		if(!tree->leaf){
+			print_in_order(tree->children[tree->count]);
+		}
+	}
+}
+
+/**
+ * Print b-tree in posorder form, the children of a node before its keys.
+ *
+ * @param BTreeNode * tree, the root of the tree, is a BTreeNode type pointer.
+ *
+ */
+private void print_pos_order(BTreeNode * tree){
+	int i;
+	if(tree != NULL){
+		if(!tree->leaf){
+			for(i = 0; i <= tree->count; i++){
+				print_pos_order(tree->children[i]);
+			}
+		}
+		for(i = 0; i < tree->count; i++){
+			printf("%d ", tree->keys[i]);
+		}
+	}
+}
+
+/**
+ * method constructor
+ *
+ * @returns a new BTree type and all functions
+ */
+public BTree btree(){
+	BTree new_tree;
+	new_tree.insert = &insert;
+	new_tree.search = &search;
+	new_tree.height = &height;
+	new_tree.delete = &delete_tree;
+	new_tree.preOrder = &print_pre_order;
+	new_tree.posOrder = &print_pos_order;
+	new_tree.inOrder = &print_in_order;
+	new_tree.remove = &removeValue;
+	new_tree.root = NULL;
+	return new_tree;
+}
@@ -0,0 +1,76 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+/**
+ * B-TREE STRUCTURES, TYPES.
+ *
+ * Up to BTREE_MAX_KEYS keys per node. The keys of a node fill one 64-byte
+ * cache line and are searched with SSE2 or AVX2 compares when the compiler
+ * targets them (-msse2 is the x86-64 default, -mavx2 or -march=native for
+ * AVX2), with a scalar loop otherwise.
+ *
+ */
+#ifndef BTREE_H
+#define BTREE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#define itemtype int
+#define public
+#define private static
+
+/**
+ * Minimum degree: every node but the root holds between BTREE_T - 1 and
+ * 2 * BTREE_T - 1 keys.
+ */
+#define BTREE_T 8
+#define BTREE_MAX_KEYS (2 * BTREE_T - 1)
+
+/**
+ * Key slots of a node, one cache line of itemtype; the last one is unused.
+ */
+#define BTREE_SLOTS 16
+
+typedef struct btreenode {
+   _Alignas(64) itemtype keys[BTREE_SLOTS];     /* keys[0 .. count-1] ascending */
+   int count;                                    /* number of keys */
+   bool leaf;                                    /* true if children are unused */
+   struct btreenode * children[BTREE_SLOTS];     /* children[0 .. count] */
+}BTreeNode;
+
+typedef struct btree {
+   void (*insert)(BTreeNode ** tree, itemtype value);
+   BTreeNode* (*search)(BTreeNode * tree, itemtype value);
+   int (*height) (BTreeNode ** tree);
+   void (*delete) (BTreeNode * tree);
+   void (*preOrder)(BTreeNode * tree);
+   void (*posOrder)(BTreeNode * tree);
+   void (*inOrder)(BTreeNode * tree);
+   bool (*remove) (BTreeNode ** tree, itemtype value);
+   BTreeNode * root;
+}BTree;
+
+/**
+ * method constructor
+ *
+ * @returns a new BTree type and all functions
+ */
+public BTree btree();
+
+#endif
@@ -0,0 +1,63 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include "btree.h"
+
+/**
+ * Main program
+ * Example of how to use the functions of the b-tree
+ *
+ */
+int main(){
+	BTreeNode * temp;
+	int i;
+
+	BTree tree = btree();
+	int h = 0;
+
+	for(i = 1; i <= 40; i++){
+		tree.insert(&tree.root, i * 5);
+	}
+
+	printf("Pre Order\n");
+	tree.preOrder(tree.root);
+	printf("\n\n");
+	printf("In Order\n");
+	tree.inOrder(tree.root);
+	printf("\n\n");
+	printf("Pos Order\n");
+	tree.posOrder(tree.root);
+	printf("\n\n");
+
+	temp = tree.search(tree.root, 20);
+	if(temp != NULL) {
+		printf("Found element 20 in a node of %d keys\n", temp->count);
+	}
+
+	h = tree.height(&tree.root);
+	printf("height: %d\n", h);
+
+	for(i = 1; i <= 40; i += 2){
+		tree.remove(&tree.root, i * 5);
+	}
+
+	tree.inOrder(tree.root);
+	printf("\n\n");
+	tree.delete(tree.root);
+
+	return 0;
+}
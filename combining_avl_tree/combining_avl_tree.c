@@ -0,0 +1,312 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+
+#include "combining_avl_tree.h"
+#include "../avl_tree/avl_tree_inline.h"
+
+/**
+ * make room for n requests in the buffers of a pass.
+ *
+ * @param CombiningRoot * tree, the tree.
+ * @param size_t n, requests needed.
+ *
+ * @returns true if there is room, false if out of memory
+ */
+private bool reserve(CombiningRoot * tree, size_t n){
+	CombiningSlot ** batch;
+	itemtype * values;
+	Node ** found;
+	size_t capacity = (tree->capacity > 0)? tree->capacity : 16;
+	if(n <= tree->capacity){
+		return true;
+	}
+	while(capacity < n){
+		capacity *= 2;
+	}
+	batch = (CombiningSlot**) realloc(tree->batch, capacity * sizeof(CombiningSlot*));
+	if(batch == NULL){
+		return false;
+	}
+	tree->batch = batch;
+	values = (itemtype*) realloc(tree->values, capacity * sizeof(itemtype));
+	if(values == NULL){
+		return false;
+	}
+	tree->values = values;
+	found = (Node**) realloc(tree->found, capacity * sizeof(Node*));
+	if(found == NULL){
+		return false;
+	}
+	tree->found = found;
+	tree->capacity = capacity;
+	return true;
+}
+
+/**
+ * gather the pending requests into the batch. Requests that do not fit
+ * when the batch cannot grow wait for the next pass.
+ *
+ * @param CombiningRoot * tree, the tree.
+ *
+ * @returns number of requests gathered
+ */
+private size_t collect(CombiningRoot * tree){
+	CombiningSlot * slot;
+	size_t n = 0;
+	for(slot = atomic_load_explicit(&tree->slots, memory_order_acquire); slot != NULL; slot = slot->next){
+		if(atomic_load_explicit(&slot->request, memory_order_acquire) == COMBINING_NONE){
+			continue;
+		}
+		if(n == tree->capacity && !reserve(tree, n + 1)){
+			break;
+		}
+		tree->batch[n++] = slot;
+	}
+	return n;
+}
+
+/**
+ * sort a batch by value, insertion sort as a batch holds at most one
+ * request per thread.
+ *
+ * @param CombiningSlot ** batch, the requests.
+ * @param size_t n, number of requests.
+ */
+private void sortBatch(CombiningSlot ** batch, size_t n){
+	CombiningSlot * slot;
+	size_t i, j;
+	for(i = 1; i < n; i++){
+		slot = batch[i];
+		for(j = i; j > 0 && batch[j - 1]->value > slot->value; j--){
+			batch[j] = batch[j - 1];
+		}
+		batch[j] = slot;
+	}
+}
+
+/**
+ * hand a result back to the thread waiting on a slot.
+ *
+ * @param CombiningSlot * slot, the slot.
+ * @param bool result, the result of its request.
+ */
+private void serve(CombiningSlot * slot, bool result){
+	slot->result = result;
+	atomic_store_explicit(&slot->request, COMBINING_NONE, memory_order_release);
+}
+
+/**
+ * apply a sorted batch. Inserts and removes go in ascending order, so
+ * each descent finds the upper part of its path still in cache from the
+ * one before; the searches are then made together with avl_search_batch,
+ * their cache misses overlapping. Requests in one batch are concurrent,
+ * any order among them is a valid one.
+ *
+ * @param CombiningRoot * tree, the tree.
+ * @param size_t n, number of requests.
+ */
+private void apply(CombiningRoot * tree, size_t n){
+	CombiningSlot * slot;
+	size_t i, searches = 0;
+	for(i = 0; i < n; i++){
+		slot = tree->batch[i];
+		switch(atomic_load_explicit(&slot->request, memory_order_relaxed)){
+			case COMBINING_INSERT:
+				serve(slot, avltree_add(tree->tree.pool, &tree->tree.root, slot->value));
+				break;
+			case COMBINING_REMOVE:
+				serve(slot, tree->tree.removePool(tree->tree.pool, &tree->tree.root, slot->value));
+				break;
+			default:
+				tree->values[searches] = slot->value;
+				tree->batch[searches++] = slot;
+				break;
+		}
+	}
+	avl_search_batch(tree->tree.root, tree->values, searches, tree->found);
+	for(i = 0; i < searches; i++){
+		serve(tree->batch[i], tree->found[i] != NULL);
+	}
+}
+
+/**
+ * serve pending requests as the combiner, the lock held.
+ *
+ * @param CombiningRoot * tree, the tree.
+ */
+private void combine(CombiningRoot * tree){
+	size_t pass, n;
+	for(pass = 0; pass < COMBINING_PASSES; pass++){
+		n = collect(tree);
+		if(n == 0){
+			break;
+		}
+		sortBatch(tree->batch, n);
+		apply(tree, n);
+		tree->batches++;
+		tree->served += n;
+	}
+}
+
+/**
+ * publish a request and wait for it, combining whenever the lock is free.
+ *
+ * @param CombiningSlot * self, the slot of the calling thread.
+ * @param CombiningRequest request, what to do.
+ * @param itemtype value, the value.
+ *
+ * @returns the result of the request
+ */
+private bool run(CombiningSlot * self, CombiningRequest request, itemtype value){
+	CombiningRoot * tree = self->tree;
+	int spin, unlocked;
+	self->value = value;
+	atomic_store_explicit(&self->request, request, memory_order_release);
+	for(;;){
+		unlocked = 0;
+		if(atomic_load_explicit(&tree->lock, memory_order_relaxed) == 0
+				&& atomic_compare_exchange_strong_explicit(&tree->lock, &unlocked, 1, memory_order_acquire, memory_order_relaxed)){
+			combine(tree);
+			atomic_store_explicit(&tree->lock, 0, memory_order_release);
+		}
+		for(spin = 0; spin < COMBINING_SPIN; spin++){
+			if(atomic_load_explicit(&self->request, memory_order_acquire) == COMBINING_NONE){
+				return self->result;
+			}
+		}
+		sched_yield();
+	}
+}
+
+/**
+ * Insert elements in the tree.
+ *
+ * @param CombiningSlot * self, the slot of the calling thread.
+ * @param itemtype value, value to insert.
+ *
+ * @returns true if the value was added, false if it was already there or out of memory
+ */
+private bool insert(CombiningSlot * self, itemtype value){
+	return run(self, COMBINING_INSERT, value);
+}
+
+/**
+ * remove elements in the tree.
+ *
+ * @param CombiningSlot * self, the slot of the calling thread.
+ * @param itemtype value, value to remove.
+ *
+ * @returns true if element removed or false if element not remove.
+ */
+private bool removeValue(CombiningSlot * self, itemtype value){
+	return run(self, COMBINING_REMOVE, value);
+}
+
+/**
+ * Search elements in the tree.
+ *
+ * @param CombiningSlot * self, the slot of the calling thread.
+ * @param itemtype value, value searched.
+ *
+ * @returns true if the value is in the tree
+ */
+private bool search(CombiningSlot * self, itemtype value){
+	return run(self, COMBINING_SEARCH, value);
+}
+
+CombiningSlot * combiningavltree_thread(CombiningRoot * tree){
+	CombiningSlot * slot;
+	int expected;
+
+	for(slot = atomic_load(&tree->slots); slot != NULL; slot = slot->next){
+		expected = 0;
+		if(!atomic_load(&slot->taken) && atomic_compare_exchange_strong(&slot->taken, &expected, 1)){
+			return slot;
+		}
+	}
+	slot = (CombiningSlot*) aligned_alloc(64, sizeof(CombiningSlot));
+	if(slot == NULL){
+		return NULL;
+	}
+	atomic_init(&slot->request, COMBINING_NONE);
+	atomic_init(&slot->taken, 1);
+	slot->result = false;
+	slot->tree = tree;
+	slot->next = atomic_load(&tree->slots);
+	while(!atomic_compare_exchange_weak(&tree->slots, &slot->next, slot)){
+	}
+	return slot;
+}
+
+void combiningavltree_thread_release(CombiningSlot * self){
+	atomic_store(&self->taken, 0);
+}
+
+/**
+ * free the tree and every slot, no thread may be using it.
+ *
+ * @param CombiningRoot * tree, the tree.
+ */
+private void delete_tree(CombiningRoot * tree){
+	CombiningSlot * slot;
+	CombiningSlot * next;
+	if(tree == NULL){
+		return;
+	}
+	tree->tree.release(tree->tree.pool, &tree->tree.root);
+	avltree_pool_destroy(tree->tree.pool);
+	for(slot = atomic_load(&tree->slots); slot != NULL; slot = next){
+		next = slot->next;
+		free(slot);
+	}
+	free(tree->batch);
+	free(tree->values);
+	free(tree->found);
+	free(tree);
+}
+
+/**
+ * method constructor
+ *
+ * @returns a new CombiningAvlTree type, root NULL if out of memory
+ */
+CombiningAvlTree combiningavltree(){
+	CombiningAvlTree new_tree;
+	CombiningRoot * tree = (CombiningRoot*) calloc(1, sizeof(CombiningRoot));
+
+	new_tree.insert = &insert;
+	new_tree.remove = &removeValue;
+	new_tree.search = &search;
+	new_tree.delete = &delete_tree;
+	new_tree.root = NULL;
+	if(tree == NULL){
+		return new_tree;
+	}
+	tree->tree = avltree_pool(0);
+	if(tree->tree.pool == NULL){
+		free(tree);
+		return new_tree;
+	}
+	atomic_init(&tree->lock, 0);
+	atomic_init(&tree->slots, NULL);
+	new_tree.root = tree;
+	return new_tree;
+}
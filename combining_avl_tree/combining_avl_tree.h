@@ -0,0 +1,115 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+/**
+ * FLAT COMBINING AVL TREE STRUCTURES, TYPES.
+ *
+ * An AvlTree shared by many threads through flat combining (Hendler,
+ * Incze, Shavit and Tzafrir, SPAA 2010). Instead of each thread taking a
+ * lock and walking the tree itself, it writes its request into its own
+ * slot and waits. Whichever thread finds the combiner lock free becomes
+ * the combiner: it collects every pending request, sorts them by value
+ * and applies them one after another, then hands each result back
+ * through its slot. The tree and the lock stay in the combiner's cache
+ * instead of moving from core to core with every operation, and waiting
+ * threads only read their own slot.
+ *
+ */
+#ifndef COMBINING_AVL_TREE_H
+#define COMBINING_AVL_TREE_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+
+#include "../avl_tree/avl_tree.h"
+
+#define public
+#define private static
+
+/**
+ * Passes over the slots a combiner makes before giving the lock up, more
+ * requests arrive while it applies a batch.
+ */
+#define COMBINING_PASSES 3
+
+/**
+ * Times a waiting thread checks its slot before yielding the processor.
+ */
+#define COMBINING_SPIN 128
+
+/**
+ * Requests a slot may hold.
+ */
+typedef enum {COMBINING_NONE, COMBINING_INSERT, COMBINING_REMOVE, COMBINING_SEARCH} CombiningRequest;
+
+/**
+ * Slot of a thread working on a tree, see combiningavltree_thread.
+ */
+typedef struct combiningslot {
+   _Atomic int request;             /* a CombiningRequest, NONE once served */
+   itemtype value;
+   bool result;
+   _Atomic int taken;               /* 1 while owned by a thread */
+   struct combiningroot * tree;
+   struct combiningslot * next;     /* every slot of the tree */
+}__attribute__((aligned(64))) CombiningSlot;
+
+typedef struct combiningroot {
+   atomic_int lock;                 /* 1 while a thread combines */
+   AvlTree tree;                    /* only touched by the combiner */
+   _Atomic(CombiningSlot *) slots;
+   CombiningSlot ** batch;          /* requests of one pass */
+   itemtype * values;               /* values searched in one pass */
+   Node ** found;
+   size_t capacity;                 /* length of batch, values and found */
+   size_t batches;                  /* passes that served at least one request */
+   size_t served;                   /* requests served */
+}CombiningRoot;
+
+typedef struct combiningavltree {
+   bool (*insert)(CombiningSlot * self, itemtype value);
+   bool (*remove)(CombiningSlot * self, itemtype value);
+   bool (*search)(CombiningSlot * self, itemtype value);
+   void (*delete)(CombiningRoot * tree);
+   CombiningRoot * root;
+}CombiningAvlTree;
+
+/**
+ * method constructor
+ *
+ * @returns a new CombiningAvlTree type, root NULL if out of memory
+ */
+public CombiningAvlTree combiningavltree();
+
+/**
+ * slot for the calling thread, passed to every operation it makes on the
+ * tree. A slot is used by one thread at a time.
+ *
+ * @param CombiningRoot * tree, the tree.
+ *
+ * @returns the slot, NULL if out of memory
+ */
+public CombiningSlot * combiningavltree_thread(CombiningRoot * tree);
+
+/**
+ * give back a slot, another thread may take it afterwards.
+ *
+ * @param CombiningSlot * self, the slot.
+ */
+public void combiningavltree_thread_release(CombiningSlot * self);
+
+#endif
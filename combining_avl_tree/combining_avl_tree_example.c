@@ -0,0 +1,72 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include "combining_avl_tree.h"
+#include <stdio.h>
+#include <pthread.h>
+
+static CombiningAvlTree tree;
+
+/**
+ * insert the values of one residue modulo 4, from a thread of its own.
+ *
+ * @param void * arg, the residue.
+ */
+private void * fill(void * arg){
+	long residue = (long) arg;
+	CombiningSlot * self = combiningavltree_thread(tree.root);
+	int value;
+	for(value = (int) residue; value < 1000; value += 4){
+		tree.insert(self, value);
+	}
+	combiningavltree_thread_release(self);
+	return NULL;
+}
+
+/**
+ * Main program
+ * Example of how to use the functions of the flat combining tree
+ *
+ */
+int main(){
+	pthread_t threads[4];
+	CombiningSlot * self;
+	long i;
+	int found = 0, value;
+
+	tree = combiningavltree();
+	for(i = 0; i < 4; i++){
+		pthread_create(&threads[i], NULL, fill, (void*) i);
+	}
+	for(i = 0; i < 4; i++){
+		pthread_join(threads[i], NULL);
+	}
+
+	self = combiningavltree_thread(tree.root);
+	for(value = 0; value < 1000; value++){
+		found += tree.search(self, value);
+	}
+	printf("found %d of 1000\n", found);
+	if(tree.remove(self, 500) && !tree.search(self, 500)){
+		printf("removed 500\n");
+	}
+	printf("%zu requests served in %zu passes\n", tree.root->served, tree.root->batches);
+	combiningavltree_thread_release(self);
+
+	tree.delete(tree.root);
+	return 0;
+}
@@ -0,0 +1,718 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "compact_avl_tree.h"
+
+/**
+ * top bit of a child link, set when that side is the taller one.
+ */
+#define TALL 0x80000000u
+
+/**
+ * the child index part of a link, indices are at most 2^31 - 1.
+ */
+#define INDEX 0x7fffffffu
+
+#ifdef TREE_STATS
+unsigned long compactavltree_rotations = 0;
+#endif
+
+/**
+ * child of a node.
+ *
+ * @param CompactNode * nodes, the node array.
+ * @param uint32_t node, index of the node.
+ * @param int dir, 0 for the left child, 1 for the right child.
+ *
+ * @returns the index of the child, COMPACT_NIL if none
+ */
+private inline uint32_t childOf(CompactNode * nodes, uint32_t node, int dir){
+	return (dir ? nodes[node].right : nodes[node].left) & INDEX;
+}
+
+/**
+ * replace a child of a node, keeping its balance bits.
+ *
+ * @param CompactNode * nodes, the node array.
+ * @param uint32_t node, index of the node.
+ * @param int dir, 0 for the left child, 1 for the right child.
+ * @param uint32_t child, index of the new child.
+ */
+private inline void setChild(CompactNode * nodes, uint32_t node, int dir, uint32_t child){
+	uint32_t * link = dir ? &nodes[node].right : &nodes[node].left;
+	*link = (*link & TALL) | child;
+}
+
+/**
+ * balance factor of a node, height of the right side minus height of the left.
+ *
+ * @param CompactNode * nodes, the node array.
+ * @param uint32_t node, index of the node.
+ *
+ * @returns -1, 0 or 1
+ */
+private inline int balanceOf(CompactNode * nodes, uint32_t node){
+	return (int) (nodes[node].right >> 31) - (int) (nodes[node].left >> 31);
+}
+
+/**
+ * store the balance factor of a node in the top bits of its links.
+ *
+ * @param CompactNode * nodes, the node array.
+ * @param uint32_t node, index of the node.
+ * @param int balance, -1, 0 or 1.
+ */
+private inline void setBalance(CompactNode * nodes, uint32_t node, int balance){
+	nodes[node].left = (nodes[node].left & INDEX) | ((balance < 0) ? TALL : 0);
+	nodes[node].right = (nodes[node].right & INDEX) | ((balance > 0) ? TALL : 0);
+}
+
+/**
+ * take one slot of the node array: a removed node if any, otherwise the
+ * next unused slot, doubling the array when it is full.
+ *
+ * @param CompactRoot * tree, the tree, its node array may move.
+ * @param itemtype value, value of the new node.
+ *
+ * @returns index of a new balanced leaf, COMPACT_NIL if out of memory
+ */
+private uint32_t allocNode(CompactRoot * tree, itemtype value){
+	CompactNode * grown;
+	uint32_t index, capacity;
+
+	if(tree->free_list != COMPACT_NIL){
+		index = tree->free_list;
+		tree->free_list = tree->nodes[index].left;
+	}
+	else{
+		if(tree->used == 0){
+			tree->used = 1;
+		}
+		if(tree->used >= tree->capacity){
+			if(tree->capacity > INDEX){
+				return COMPACT_NIL;
+			}
+			capacity = (tree->capacity == 0) ? 1024 : tree->capacity;
+			capacity = (capacity > INDEX / 2) ? INDEX + 1u : 2 * capacity;
+			grown = (CompactNode*) realloc(tree->nodes, (size_t) capacity * sizeof(CompactNode));
+			if(grown == NULL){
+				return COMPACT_NIL;
+			}
+			if(tree->capacity == 0){
+				grown[COMPACT_NIL].value = 0;
+				grown[COMPACT_NIL].left = COMPACT_NIL;
+				grown[COMPACT_NIL].right = COMPACT_NIL;
+			}
+			tree->nodes = grown;
+			tree->capacity = capacity;
+		}
+		index = tree->used++;
+	}
+	tree->nodes[index].value = value;
+	tree->nodes[index].left = COMPACT_NIL;
+	tree->nodes[index].right = COMPACT_NIL;
+	return index;
+}
+
+/**
+ * give a slot back to the free list of the tree.
+ *
+ * @param CompactRoot * tree, the tree owning the node.
+ * @param uint32_t node, index of the node.
+ */
+private void freeNode(CompactRoot * tree, uint32_t node){
+	tree->nodes[node].left = tree->free_list;
+	tree->nodes[node].right = COMPACT_NIL;
+	tree->free_list = node;
+}
+
+/**
+ * Left Rotate, balance bits are left for the caller to fix.
+ *
+ * @param CompactNode * nodes, the node array.
+ * @param uint32_t node, index of the root of the subtree.
+ *
+ * @returns the index of the new root of the subtree
+ */
+private uint32_t leftRotate(CompactNode * nodes, uint32_t node){
+	uint32_t up = childOf(nodes, node, 1);
+	setChild(nodes, node, 1, childOf(nodes, up, 0));
+	setChild(nodes, up, 0, node);
+#ifdef TREE_STATS
+	compactavltree_rotations++;
+#endif
+	return up;
+}
+
+/**
+ * Right Rotate, balance bits are left for the caller to fix.
+ *
+ * @param CompactNode * nodes, the node array.
+ * @param uint32_t node, index of the root of the subtree.
+ *
+ * @returns the index of the new root of the subtree
+ */
+private uint32_t rightRotate(CompactNode * nodes, uint32_t node){
+	uint32_t up = childOf(nodes, node, 0);
+	setChild(nodes, node, 0, childOf(nodes, up, 1));
+	setChild(nodes, up, 1, node);
+#ifdef TREE_STATS
+	compactavltree_rotations++;
+#endif
+	return up;
+}
+
+/**
+ * rotate a node whose balance reached -2 or 2 back into balance.
+ *
+ * @param CompactNode * nodes, the node array.
+ * @param uint32_t node, index of the unbalanced node.
+ * @param int balance, its balance factor, -2 or 2.
+ * @param bool * shorter, set to true if the subtree lost height.
+ *
+ * @returns the index of the new root of the subtree
+ */
+private uint32_t rebalance(CompactNode * nodes, uint32_t node, int balance, bool * shorter){
+	int dir = balance > 0;
+	int sign = dir ? 1 : -1;
+	uint32_t child = childOf(nodes, node, dir);
+	uint32_t up;
+	int inner;
+
+	if(balanceOf(nodes, child) == -sign){
+		up = childOf(nodes, child, !dir);
+		inner = balanceOf(nodes, up);
+		setChild(nodes, node, dir, dir ? rightRotate(nodes, child) : leftRotate(nodes, child));
+		dir ? leftRotate(nodes, node) : rightRotate(nodes, node);
+		setBalance(nodes, child, (inner == -sign) ? sign : 0);
+		setBalance(nodes, node, (inner == sign) ? -sign : 0);
+		setBalance(nodes, up, 0);
+		*shorter = true;
+		return up;
+	}
+	up = dir ? leftRotate(nodes, node) : rightRotate(nodes, node);
+	if(balanceOf(nodes, up) == 0){
+		setBalance(nodes, up, -sign);
+		setBalance(nodes, node, sign);
+		*shorter = false;
+	}
+	else{
+		setBalance(nodes, up, 0);
+		setBalance(nodes, node, 0);
+		*shorter = true;
+	}
+	return up;
+}
+
+/**
+ * hang a subtree where the last node of a recorded path hung.
+ *
+ * @param CompactRoot * tree, the tree.
+ * @param uint32_t path[], the nodes walked from the root.
+ * @param unsigned char dirs[], the direction taken at each node of path.
+ * @param int top, number of nodes of the path above the subtree.
+ * @param uint32_t node, index of the subtree.
+ */
+private void relink(CompactRoot * tree, uint32_t path[], unsigned char dirs[], int top, uint32_t node){
+	if(top == 0){
+		tree->top = node;
+	}
+	else{
+		setChild(tree->nodes, path[top - 1], dirs[top - 1], node);
+	}
+}
+
+/**
+ * Insert elements in compact avl tree.
+ * Only the nodes below the deepest unbalanced node of the path change
+ * balance, so the descent remembers that node and at most one single or
+ * double rotation happens there.
+ *
+ * @param CompactRoot * tree, the tree.
+ * @param itemtype value, value to insert.
+ *
+ * @returns true if inserted, false if present or out of memory
+ */
+private bool insert(CompactRoot * tree, itemtype value){
+	unsigned char dirs[COMPACT_MAX_HEIGHT];
+	CompactNode * nodes = tree->nodes;
+	uint32_t top_parent = COMPACT_NIL, top = tree->top, parent = COMPACT_NIL;
+	uint32_t node, created, up;
+	int k = 0, dir = 0, balance;
+	bool shorter;
+
+	for(node = tree->top; node != COMPACT_NIL; parent = node, node = childOf(nodes, node, dir)){
+		if(value == nodes[node].value){
+			return false;
+		}
+		if(balanceOf(nodes, node) != 0){
+			top_parent = parent;
+			top = node;
+			k = 0;
+		}
+		dir = value > nodes[node].value;
+		dirs[k++] = dir;
+	}
+	created = allocNode(tree, value);
+	if(created == COMPACT_NIL){
+		return false;
+	}
+	nodes = tree->nodes;
+	if(parent == COMPACT_NIL){
+		tree->top = created;
+		return true;
+	}
+	setChild(nodes, parent, dir, created);
+
+	for(node = childOf(nodes, top, dirs[0]), k = 1; node != created; node = childOf(nodes, node, dirs[k]), k++){
+		setBalance(nodes, node, dirs[k] ? 1 : -1);
+	}
+	balance = balanceOf(nodes, top) + (dirs[0] ? 1 : -1);
+	if(balance >= -1 && balance <= 1){
+		setBalance(nodes, top, balance);
+		return true;
+	}
+	up = rebalance(nodes, top, balance, &shorter);
+	if(top_parent == COMPACT_NIL){
+		tree->top = up;
+	}
+	else{
+		setChild(nodes, top_parent, childOf(nodes, top_parent, 0) != top, up);
+	}
+	return true;
+}
+
+/**
+ * remove elements in compact avl tree.
+ * A node with two children is replaced by its successor, found in the same
+ * descent, then the path is walked back up while the subtree got shorter.
+ *
+ * @param CompactRoot * tree, the tree.
+ * @param itemtype value, value to remove.
+ *
+ * @returns true if element removed or false if element not remove.
+ */
+private bool removeValue(CompactRoot * tree, itemtype value){
+	uint32_t path[COMPACT_MAX_HEIGHT];
+	unsigned char dirs[COMPACT_MAX_HEIGHT];
+	CompactNode * nodes = tree->nodes;
+	uint32_t node = tree->top, next, successor, up;
+	int top = 0, slot, dir, balance;
+	bool shorter;
+
+	while(node != COMPACT_NIL && value != nodes[node].value){
+		dir = value > nodes[node].value;
+		path[top] = node;
+		dirs[top++] = dir;
+		node = childOf(nodes, node, dir);
+	}
+	if(node == COMPACT_NIL){
+		return false;
+	}
+	next = childOf(nodes, node, 1);
+	if(next == COMPACT_NIL){
+		relink(tree, path, dirs, top, childOf(nodes, node, 0));
+	}
+	else if(childOf(nodes, next, 0) == COMPACT_NIL){
+		setChild(nodes, next, 0, childOf(nodes, node, 0));
+		setBalance(nodes, next, balanceOf(nodes, node));
+		relink(tree, path, dirs, top, next);
+		path[top] = next;
+		dirs[top++] = 1;
+	}
+	else{
+		slot = top++;
+		for(;;){
+			path[top] = next;
+			dirs[top++] = 0;
+			successor = childOf(nodes, next, 0);
+			if(childOf(nodes, successor, 0) == COMPACT_NIL){
+				break;
+			}
+			next = successor;
+		}
+		setChild(nodes, next, 0, childOf(nodes, successor, 1));
+		setChild(nodes, successor, 0, childOf(nodes, node, 0));
+		setChild(nodes, successor, 1, childOf(nodes, node, 1));
+		setBalance(nodes, successor, balanceOf(nodes, node));
+		relink(tree, path, dirs, slot, successor);
+		path[slot] = successor;
+		dirs[slot] = 1;
+	}
+	freeNode(tree, node);
+
+	while(top > 0){
+		node = path[--top];
+		balance = balanceOf(nodes, node) + (dirs[top] ? -1 : 1);
+		if(balance == 1 || balance == -1){
+			setBalance(nodes, node, balance);
+			break;
+		}
+		if(balance == 0){
+			setBalance(nodes, node, 0);
+			continue;
+		}
+		up = rebalance(nodes, node, balance, &shorter);
+		relink(tree, path, dirs, top, up);
+		if(!shorter){
+			break;
+		}
+	}
+	return true;
+}
+
+/**
+ * Search elements in compact avl tree.
+ *
+ * @param CompactRoot * tree, the tree.
+ * @param itemtype value, value to searched.
+ *
+ * @returns the node holding value, valid until the next insert, NULL if absent
+ */
+private CompactNode * search(CompactRoot * tree, itemtype value){
+	CompactNode * nodes = tree->nodes;
+	uint32_t node = tree->top;
+	while(node != COMPACT_NIL && value != nodes[node].value){
+		node = childOf(nodes, node, value > nodes[node].value);
+	}
+	return (node == COMPACT_NIL) ? NULL : &nodes[node];
+}
+
+/**
+ * get height of compact avl tree, following the taller side from the root.
+ *
+ * @param CompactRoot * tree, the tree.
+ *
+ * @returns a integer type, is the height of tree
+ */
+private int height(CompactRoot * tree){
+	CompactNode * nodes = tree->nodes;
+	uint32_t node = tree->top;
+	int result = 0;
+	while(node != COMPACT_NIL){
+		result++;
+		node = childOf(nodes, node, balanceOf(nodes, node) > 0);
+	}
+	return result;
+}
+
+/**
+ * Delete and free memory of compact avl tree, one free for the whole array.
+ *
+ * @param CompactRoot * tree, the tree, left empty and usable.
+ */
+private void delete_tree(CompactRoot * tree){
+	free(tree->nodes);
+	tree->nodes = NULL;
+	tree->top = COMPACT_NIL;
+	tree->used = 0;
+	tree->capacity = 0;
+	tree->free_list = COMPACT_NIL;
+}
+
+private void print_pre(CompactNode * nodes, uint32_t node){
+	if(node != COMPACT_NIL){
+		printf("%d ", nodes[node].value);
+		print_pre(nodes, childOf(nodes, node, 0));
+		print_pre(nodes, childOf(nodes, node, 1));
+	}
+}
+
+private void print_in(CompactNode * nodes, uint32_t node){
+	if(node != COMPACT_NIL){
+		print_in(nodes, childOf(nodes, node, 0));
+		printf("%d ", nodes[node].value);
+		print_in(nodes, childOf(nodes, node, 1));
+	}
+}
+
+private void print_pos(CompactNode * nodes, uint32_t node){
+	if(node != COMPACT_NIL){
+		print_pos(nodes, childOf(nodes, node, 0));
+		print_pos(nodes, childOf(nodes, node, 1));
+		printf("%d ", nodes[node].value);
+	}
+}
+
+/**
+ * Print compact avl tree in preorder form.
+ *
+ * @param CompactRoot * tree, the tree.
+ */
+private void print_pre_order(CompactRoot * tree){
+	print_pre(tree->nodes, tree->top);
+}
+
+/**
+ * Print compact avl tree in inorder form.
+ *
+ * @param CompactRoot * tree, the tree.
+ */
+private void print_in_order(CompactRoot * tree){
+	print_in(tree->nodes, tree->top);
+}
+
+/**
+ * Print compact avl tree in posorder form.
+ *
+ * @param CompactRoot * tree, the tree.
+ */
+private void print_pos_order(CompactRoot * tree){
+	print_pos(tree->nodes, tree->top);
+}
+
+/**
+ * qsort comparison of two itemtype values
+ */
+private int compareItems(const void * a, const void * b){
+	itemtype x = *(const itemtype*) a;
+	itemtype y = *(const itemtype*) b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * sort values in place and drop repeated ones.
+ *
+ * @param itemtype * values, the buffer to sort.
+ * @param size_t n, number of values.
+ *
+ * @returns the number of distinct values left at the front of the buffer
+ */
+private size_t sortUnique(itemtype * values, size_t n){
+	size_t i, unique = 0;
+	qsort(values, n, sizeof(itemtype), compareItems);
+	for(i = 0; i < n; i++){
+		if(unique == 0 || values[unique - 1] < values[i]){
+			values[unique++] = values[i];
+		}
+	}
+	return unique;
+}
+
+/**
+ * number of levels of a tree of count nodes built by buildBalanced.
+ */
+private int builtHeight(size_t count){
+	int result = 0;
+	while(count != 0){
+		result++;
+		count >>= 1;
+	}
+	return result;
+}
+
+/**
+ * build a balanced subtree from sorted values, the node of values[i] is
+ * stored at index i + 1 so the array ends up in order.
+ *
+ * @param CompactNode * nodes, the node array.
+ * @param const itemtype * values, every value of the tree, ascending.
+ * @param size_t first, position of the first value of the subtree.
+ * @param size_t count, number of values of the subtree.
+ *
+ * @returns the index of the root of the subtree
+ */
+private uint32_t buildBalanced(CompactNode * nodes, const itemtype * values, size_t first, size_t count){
+	size_t left = count / 2;
+	size_t right = count - 1 - left;
+	uint32_t node;
+	if(count == 0){
+		return COMPACT_NIL;
+	}
+	node = (uint32_t) (first + left + 1);
+	nodes[node].value = values[first + left];
+	nodes[node].left = buildBalanced(nodes, values, first, left);
+	nodes[node].right = buildBalanced(nodes, values, first + left + 1, right);
+	setBalance(nodes, node, builtHeight(right) - builtHeight(left));
+	return node;
+}
+
+/**
+ * replace the content of a tree by a balanced tree of sorted values. The
+ * new array is built first, so on failure the tree is left as it was.
+ *
+ * @param CompactRoot * tree, the tree.
+ * @param const itemtype * values, the values in strictly ascending order.
+ * @param size_t n, number of values.
+ *
+ * @returns false if out of memory or above 2^31 - 1 values, the tree is then unchanged
+ */
+private bool buildTree(CompactRoot * tree, const itemtype * values, size_t n){
+	CompactNode * nodes;
+	if(n == 0){
+		delete_tree(tree);
+		return true;
+	}
+	if(n > INDEX - 1){
+		return false;
+	}
+	nodes = (CompactNode*) malloc((n + 1) * sizeof(CompactNode));
+	if(nodes == NULL){
+		return false;
+	}
+	nodes[COMPACT_NIL].value = 0;
+	nodes[COMPACT_NIL].left = COMPACT_NIL;
+	nodes[COMPACT_NIL].right = COMPACT_NIL;
+	delete_tree(tree);
+	tree->nodes = nodes;
+	tree->used = (uint32_t) (n + 1);
+	tree->capacity = tree->used;
+	tree->top = buildBalanced(nodes, values, 0, n);
+	return true;
+}
+
+/**
+ * Insert a batch of values in compact avl tree.
+ * A batch small next to the tree is inserted one value at a time; a larger
+ * one is merged with the in order walk of the tree and the tree is rebuilt
+ * balanced in O(n + m), which also compacts away removed slots.
+ *
+ * @param CompactRoot * tree, the tree.
+ * @param itemtype * values, the values, sorted in place.
+ * @param size_t n, number of values.
+ *
+ * @returns by parameter the tree with the new elements.
+ */
+private void insert_batch(CompactRoot * tree, itemtype * values, size_t n){
+	uint32_t stack[COMPACT_MAX_HEIGHT];
+	itemtype * merged;
+	CompactNode * nodes;
+	size_t i = 0, size;
+	uint32_t node;
+	int top = 0;
+
+	n = sortUnique(values, n);
+	size = (tree->used == 0) ? 0 : tree->used - 1;
+	if(n * 8 < size){
+		for(i = 0; i < n; i++){
+			insert(tree, values[i]);
+		}
+		return;
+	}
+	merged = (itemtype*) malloc((size + n) * sizeof(itemtype));
+	if(merged == NULL){
+		for(i = 0; i < n; i++){
+			insert(tree, values[i]);
+		}
+		return;
+	}
+	nodes = tree->nodes;
+	node = tree->top;
+	size = 0;
+	while(node != COMPACT_NIL || top > 0){
+		while(node != COMPACT_NIL){
+			stack[top++] = node;
+			node = childOf(nodes, node, 0);
+		}
+		node = stack[--top];
+		while(i < n && values[i] < nodes[node].value){
+			merged[size++] = values[i++];
+		}
+		if(i < n && values[i] == nodes[node].value){
+			i++;
+		}
+		merged[size++] = nodes[node].value;
+		node = childOf(nodes, node, 1);
+	}
+	while(i < n){
+		merged[size++] = values[i++];
+	}
+	if(!buildTree(tree, merged, size)){
+		for(i = 0; i < n; i++){
+			insert(tree, values[i]);
+		}
+	}
+	free(merged);
+}
+
+/**
+ * method constructor
+ *
+ * @returns a new CompactAvlTree type and all functions
+ */
+public CompactAvlTree compactavltree(){
+	CompactAvlTree new_tree;
+	new_tree.insert = &insert;
+	new_tree.search = &search;
+	new_tree.height = &height;
+	new_tree.delete = &delete_tree;
+	new_tree.preOrder = &print_pre_order;
+	new_tree.posOrder = &print_pos_order;
+	new_tree.inOrder = &print_in_order;
+	new_tree.remove = &removeValue;
+	new_tree.insertBatch = &insert_batch;
+	new_tree.root.nodes = NULL;
+	new_tree.root.top = COMPACT_NIL;
+	new_tree.root.used = 0;
+	new_tree.root.capacity = 0;
+	new_tree.root.free_list = COMPACT_NIL;
+	return new_tree;
+}
+
+/**
+ * method constructor of a balanced tree holding sorted values, built in
+ * linear time. Unsorted input falls back to compactavltree_from_array.
+ *
+ * @param const itemtype * values, the values in strictly ascending order.
+ * @param size_t n, number of values.
+ *
+ * @returns a new CompactAvlTree type, empty if out of memory
+ */
+public CompactAvlTree compactavltree_from_sorted(const itemtype * values, size_t n){
+	CompactAvlTree new_tree = compactavltree();
+	size_t i;
+	for(i = 1; i < n; i++){
+		if(!(values[i - 1] < values[i])){
+			return compactavltree_from_array(values, n);
+		}
+	}
+	buildTree(&new_tree.root, values, n);
+	return new_tree;
+}
+
+/**
+ * method constructor of a balanced tree holding the values of an unsorted
+ * buffer, duplicates are kept once.
+ *
+ * @param const itemtype * values, the values in any order.
+ * @param size_t n, number of values.
+ *
+ * @returns a new CompactAvlTree type, empty if out of memory
+ */
+public CompactAvlTree compactavltree_from_array(const itemtype * values, size_t n){
+	CompactAvlTree new_tree = compactavltree();
+	itemtype * sorted;
+	size_t i, unique;
+	if(n == 0){
+		return new_tree;
+	}
+	sorted = (itemtype*) malloc(n * sizeof(itemtype));
+	if(sorted == NULL){
+		return new_tree;
+	}
+	for(i = 0; i < n; i++){
+		sorted[i] = values[i];
+	}
+	unique = sortUnique(sorted, n);
+	buildTree(&new_tree.root, sorted, unique);
+	free(sorted);
+	return new_tree;
+}
@@ -0,0 +1,114 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+/**
+ * COMPACT AVL TREE STRUCTURES, TYPES.
+ *
+ * The nodes of a tree live in one array and refer to their children by
+ * 32-bit index instead of by pointer. Index 0 is the nil node. The top bit
+ * of each child link is set when that side is the taller one, which is all
+ * the balance information an avl tree needs, so a node is 12 bytes instead
+ * of the 32 of avl_tree.c.
+ *
+ */
+#ifndef COMPACT_AVL_TREE_H
+#define COMPACT_AVL_TREE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define itemtype int
+#define public
+#define private static
+
+/**
+ * index of the nil node, an empty subtree.
+ */
+#define COMPACT_NIL 0
+
+/**
+ * Bound on the height of a tree of 2^31 nodes, sizes the path stacks.
+ */
+#define COMPACT_MAX_HEIGHT 64
+
+typedef struct compactnode {
+   itemtype value;
+   uint32_t left;    /* left child index, top bit set if the left side is taller */
+   uint32_t right;   /* right child index, top bit set if the right side is taller */
+}CompactNode;
+
+typedef struct compactroot {
+   CompactNode * nodes;  /* node array, nodes[COMPACT_NIL] is never used */
+   uint32_t top;         /* index of the root node, COMPACT_NIL when empty */
+   uint32_t used;        /* slots of nodes handed out so far, nil included */
+   uint32_t capacity;    /* slots allocated in nodes */
+   uint32_t free_list;   /* removed nodes, linked through their left index */
+}CompactRoot;
+
+typedef struct compactavltree {
+   bool (*insert)(CompactRoot * tree, itemtype value);
+   CompactNode * (*search)(CompactRoot * tree, itemtype value);
+   int (*height) (CompactRoot * tree);
+   void (*delete) (CompactRoot * tree);
+   void (*preOrder)(CompactRoot * tree);
+   void (*posOrder)(CompactRoot * tree);
+   void (*inOrder)(CompactRoot * tree);
+   bool (*remove) (CompactRoot * tree, itemtype value);
+   void (*insertBatch)(CompactRoot * tree, itemtype * values, size_t n);
+   CompactRoot root;
+}CompactAvlTree;
+
+#ifdef TREE_STATS
+/**
+ * Number of single rotations done by every tree, counted when compiled
+ * with -DTREE_STATS.
+ */
+extern unsigned long compactavltree_rotations;
+#endif
+
+/**
+ * method constructor
+ *
+ * @returns a new CompactAvlTree type and all functions
+ */
+public CompactAvlTree compactavltree();
+
+/**
+ * method constructor of a balanced tree holding sorted values, built in
+ * linear time into an array of exactly n nodes laid out in order.
+ *
+ * @param const itemtype * values, the values in strictly ascending order.
+ * @param size_t n, number of values.
+ *
+ * @returns a new CompactAvlTree type
+ */
+public CompactAvlTree compactavltree_from_sorted(const itemtype * values, size_t n);
+
+/**
+ * method constructor of a balanced tree holding the values of an unsorted
+ * buffer, duplicates are kept once.
+ *
+ * @param const itemtype * values, the values in any order.
+ * @param size_t n, number of values.
+ *
+ * @returns a new CompactAvlTree type
+ */
+public CompactAvlTree compactavltree_from_array(const itemtype * values, size_t n);
+
+#endif
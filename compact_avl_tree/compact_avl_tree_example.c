@@ -0,0 +1,73 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include "compact_avl_tree.h"
+
+/**
+ * Main program
+ * Example of how to use the functions of the compact avl tree
+ *
+ */
+int main(){
+	CompactNode * temp;
+	itemtype sorted[] = {5, 10, 20, 30, 40, 50};
+	itemtype batch[] = {35, 1, 45, 10};
+
+	CompactAvlTree tree = compactavltree();
+	CompactAvlTree bulk;
+	int h = 0;
+
+	tree.insert(&tree.root, 5);
+	tree.insert(&tree.root, 10);
+	tree.insert(&tree.root, 20);
+	tree.insert(&tree.root, 30);
+	tree.insert(&tree.root, 40);
+	tree.insert(&tree.root, 50);
+
+	printf("Pre Order\n");
+	tree.preOrder(&tree.root);
+	printf("\n\n");
+	printf("In Order\n");
+	tree.inOrder(&tree.root);
+	printf("\n\n");
+	printf("Pos Order\n");
+	tree.posOrder(&tree.root);
+	printf("\n\n");
+
+	temp = tree.search(&tree.root, 20);
+	if(temp != NULL) {
+		printf("Found element %d\n", temp->value);
+	}
+
+	h = tree.height(&tree.root);
+	printf("height: %d\n", h);
+
+	tree.remove(&tree.root, 10);
+
+	tree.inOrder(&tree.root);
+	printf("\n\n");
+	tree.delete(&tree.root);
+
+	bulk = compactavltree_from_sorted(sorted, 6);
+	bulk.insertBatch(&bulk.root, batch, 4);
+	printf("From sorted plus batch, %zu bytes per node\n", sizeof(CompactNode));
+	bulk.inOrder(&bulk.root);
+	printf("\n\n");
+	bulk.delete(&bulk.root);
+
+	return 0;
+}
@@ -0,0 +1,895 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "disk_btree.h"
+
+_Static_assert(sizeof(DiskPage) == DISK_PAGE, "a page fills its frame");
+_Static_assert(sizeof(DiskMeta) <= DISK_PAGE, "the meta data fits page 0");
+
+static const char diskMagic[8] = {'D', 'I', 'S', 'K', 'B', 'T', 'R', 'E'};
+
+/**
+ * What an insert or remove did to a page.
+ */
+typedef enum {
+   DISK_UNCHANGED,   /* the key was already there, or absent */
+   DISK_CHANGED,     /* the key was added or removed */
+   DISK_SPLIT,       /* the key was added and the page split in two */
+   DISK_FAILED       /* a page could not be read, written or allocated */
+}DiskChange;
+
+/**
+ * read or write one whole page of the file.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param void * buffer, the page.
+ * @param uint32_t page, its number.
+ * @param bool write, true to write, false to read.
+ *
+ * @returns true if done, false after setting tree->error
+ */
+private bool transfer(DiskRoot * tree, void * buffer, uint32_t page, bool write){
+	off_t offset = (off_t) page * DISK_PAGE;
+	ssize_t done;
+	do{
+		done = write ? pwrite(tree->fd, buffer, DISK_PAGE, offset) : pread(tree->fd, buffer, DISK_PAGE, offset);
+	}while(done < 0 && errno == EINTR);
+	if(done != DISK_PAGE){
+		tree->error = (done < 0)? errno : EIO;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * bucket of a page number in the frame table.
+ */
+private size_t bucketOf(DiskRoot * tree, uint32_t page){
+	return (size_t) (page * 2654435761u) & tree->mask;
+}
+
+/**
+ * frame holding a page.
+ *
+ * @returns the frame, -1 if the page is not in the pool
+ */
+private int32_t lookup(DiskRoot * tree, uint32_t page){
+	int32_t frame = tree->buckets[bucketOf(tree, page)];
+	while(frame >= 0 && tree->frames[frame].page != page){
+		frame = tree->frames[frame].chain;
+	}
+	return frame;
+}
+
+/**
+ * enter a frame into the bucket of its page.
+ */
+private void chain(DiskRoot * tree, int32_t frame){
+	size_t bucket = bucketOf(tree, tree->frames[frame].page);
+	tree->frames[frame].chain = tree->buckets[bucket];
+	tree->buckets[bucket] = frame;
+}
+
+/**
+ * take a frame out of the bucket of its page.
+ */
+private void unchain(DiskRoot * tree, int32_t frame){
+	int32_t * link = &tree->buckets[bucketOf(tree, tree->frames[frame].page)];
+	while(*link != frame){
+		link = &tree->frames[*link].chain;
+	}
+	*link = tree->frames[frame].chain;
+}
+
+/**
+ * write a frame back to its page if it changed.
+ *
+ * @returns true if the page is clean now
+ */
+private bool clean(DiskRoot * tree, int32_t frame){
+	if(!tree->frames[frame].dirty){
+		return true;
+	}
+	if(!transfer(tree, &tree->pages[frame], tree->frames[frame].page, true)){
+		return false;
+	}
+	tree->frames[frame].dirty = 0;
+	tree->stats.writes++;
+	return true;
+}
+
+/**
+ * a free frame, evicting a page with CLOCK: the hand passes over pinned
+ * frames, clears the reference bit of used ones and stops at the first
+ * unpinned frame whose bit is clear. Two turns always find one unless
+ * every frame is pinned.
+ *
+ * @returns the frame, -1 after setting tree->error
+ */
+private int32_t victim(DiskRoot * tree){
+	DiskFrame * candidate;
+	int32_t frame;
+	size_t steps;
+	for(steps = 0; steps < 2 * tree->n; steps++){
+		frame = (int32_t) tree->hand;
+		tree->hand = (tree->hand + 1 == tree->n)? 0 : tree->hand + 1;
+		candidate = &tree->frames[frame];
+		if(candidate->pins > 0){
+			continue;
+		}
+		if(candidate->referenced){
+			candidate->referenced = 0;
+			continue;
+		}
+		if(candidate->page != 0){
+			if(!clean(tree, frame)){
+				return -1;
+			}
+			unchain(tree, frame);
+			candidate->page = 0;
+			tree->stats.evictions++;
+		}
+		return frame;
+	}
+	tree->error = ENOBUFS;
+	return -1;
+}
+
+/**
+ * pin a page in the pool, reading it if it is not there. The page stays
+ * at the same address until unpinned.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param uint32_t page, the page number.
+ *
+ * @returns the page, NULL after an error
+ */
+private DiskPage * pin(DiskRoot * tree, uint32_t page){
+	int32_t frame;
+	if(tree->error != 0){
+		return NULL;
+	}
+	frame = lookup(tree, page);
+	if(frame >= 0){
+		tree->stats.hits++;
+	}
+	else{
+		frame = victim(tree);
+		if(frame < 0 || !transfer(tree, &tree->pages[frame], page, false)){
+			return NULL;
+		}
+		tree->stats.misses++;
+		tree->frames[frame].page = page;
+		tree->frames[frame].dirty = 0;
+		chain(tree, frame);
+	}
+	tree->frames[frame].pins++;
+	tree->frames[frame].referenced = 1;
+	return &tree->pages[frame];
+}
+
+/**
+ * release a pinned page.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param DiskPage * node, the page.
+ * @param bool dirty, true if it was changed.
+ */
+private void unpin(DiskRoot * tree, DiskPage * node, bool dirty){
+	DiskFrame * frame = &tree->frames[node - tree->pages];
+	frame->pins--;
+	frame->dirty |= dirty;
+}
+
+/**
+ * a new zeroed page, pinned and dirty, from the free list or else past
+ * the end of the file.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param uint32_t * page, receives its number.
+ *
+ * @returns the page, NULL after an error
+ */
+private DiskPage * allocPage(DiskRoot * tree, uint32_t * page){
+	DiskPage * node;
+	int32_t frame;
+	if(tree->meta.free_list != 0){
+		*page = tree->meta.free_list;
+		node = pin(tree, *page);
+		if(node == NULL){
+			return NULL;
+		}
+		tree->meta.free_list = node->next;
+	}
+	else{
+		if(tree->error != 0){
+			return NULL;
+		}
+		if(tree->meta.pages == UINT32_MAX){
+			tree->error = EFBIG;
+			return NULL;
+		}
+		frame = victim(tree);
+		if(frame < 0){
+			return NULL;
+		}
+		*page = tree->meta.pages++;
+		tree->frames[frame].page = *page;
+		tree->frames[frame].pins = 1;
+		tree->frames[frame].referenced = 1;
+		chain(tree, frame);
+		node = &tree->pages[frame];
+	}
+	memset(node, 0, sizeof(DiskPage));
+	tree->frames[node - tree->pages].dirty = 1;
+	return node;
+}
+
+/**
+ * put a pinned page on the free list and unpin it.
+ */
+private void freePage(DiskRoot * tree, DiskPage * node, uint32_t page){
+	node->leaf = 0;
+	node->count = 0;
+	node->next = tree->meta.free_list;
+	tree->meta.free_list = page;
+	unpin(tree, node, true);
+}
+
+/**
+ * position of the first key not lower than value.
+ */
+private uint32_t lowerBound(const itemtype * keys, uint32_t count, itemtype value){
+	uint32_t lo = 0, hi = count, mid;
+	while(lo < hi){
+		mid = (lo + hi) / 2;
+		if(keys[mid] < value){
+			lo = mid + 1;
+		}
+		else{
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/**
+ * child of an inner page to descend into for value, the number of keys
+ * not greater than value.
+ */
+private uint32_t childOf(const DiskPage * node, itemtype value){
+	uint32_t lo = 0, hi = node->count, mid;
+	while(lo < hi){
+		mid = (lo + hi) / 2;
+		if(node->inner.keys[mid] <= value){
+			lo = mid + 1;
+		}
+		else{
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/**
+ * fewest keys a page other than the root keeps.
+ */
+private uint32_t minimum(const DiskPage * node){
+	return node->leaf ? DISK_LEAF_KEYS / 2 : DISK_INNER_KEYS / 2;
+}
+
+/**
+ * add a key to a full leaf, moving the upper half to a new leaf. When the
+ * key goes past the end of the last leaf only the key moves, so keys
+ * inserted in ascending order leave full leaves behind.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param DiskPage * node, the leaf, pinned.
+ * @param uint32_t at, position of the key.
+ * @param itemtype value, the key.
+ * @param itemtype * separator, receives the lowest key of the new leaf.
+ * @param uint32_t * sibling, receives the new leaf.
+ *
+ * @returns DISK_SPLIT or DISK_FAILED
+ */
+private DiskChange splitLeaf(DiskRoot * tree, DiskPage * node, uint32_t at, itemtype value, itemtype * separator, uint32_t * sibling){
+	itemtype all[DISK_LEAF_KEYS + 1];
+	DiskPage * right = allocPage(tree, sibling);
+	uint32_t total = DISK_LEAF_KEYS + 1, half;
+	if(right == NULL){
+		return DISK_FAILED;
+	}
+	memcpy(all, node->keys, at * sizeof(itemtype));
+	all[at] = value;
+	memcpy(all + at + 1, node->keys + at, (node->count - at) * sizeof(itemtype));
+	half = (at == node->count && node->next == 0)? total - 1 : total / 2;
+	memcpy(node->keys, all, half * sizeof(itemtype));
+	node->count = half;
+	right->leaf = 1;
+	right->count = total - half;
+	memcpy(right->keys, all + half, right->count * sizeof(itemtype));
+	right->next = node->next;
+	node->next = *sibling;
+	*separator = right->keys[0];
+	unpin(tree, right, true);
+	return DISK_SPLIT;
+}
+
+/**
+ * add a separator and the page right of it to a full inner page, moving
+ * the keys above the middle one to a new page; the middle key goes up.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param DiskPage * node, the inner page, pinned.
+ * @param uint32_t at, position of the separator.
+ * @param itemtype key, the separator.
+ * @param uint32_t child, the page right of it.
+ * @param itemtype * separator, receives the key going up.
+ * @param uint32_t * sibling, receives the new page.
+ *
+ * @returns DISK_SPLIT or DISK_FAILED
+ */
+private DiskChange splitInner(DiskRoot * tree, DiskPage * node, uint32_t at, itemtype key, uint32_t child, itemtype * separator, uint32_t * sibling){
+	itemtype keys[DISK_INNER_KEYS + 1];
+	uint32_t children[DISK_INNER_KEYS + 2];
+	DiskPage * right = allocPage(tree, sibling);
+	uint32_t total = DISK_INNER_KEYS + 1, half = total / 2;
+	if(right == NULL){
+		return DISK_FAILED;
+	}
+	memcpy(keys, node->inner.keys, at * sizeof(itemtype));
+	keys[at] = key;
+	memcpy(keys + at + 1, node->inner.keys + at, (node->count - at) * sizeof(itemtype));
+	memcpy(children, node->inner.children, (at + 1) * sizeof(uint32_t));
+	children[at + 1] = child;
+	memcpy(children + at + 2, node->inner.children + at + 1, (node->count - at) * sizeof(uint32_t));
+	node->count = half;
+	memcpy(node->inner.keys, keys, half * sizeof(itemtype));
+	memcpy(node->inner.children, children, (half + 1) * sizeof(uint32_t));
+	*separator = keys[half];
+	right->count = total - half - 1;
+	memcpy(right->inner.keys, keys + half + 1, right->count * sizeof(itemtype));
+	memcpy(right->inner.children, children + half + 1, (right->count + 1) * sizeof(uint32_t));
+	unpin(tree, right, true);
+	return DISK_SPLIT;
+}
+
+/**
+ * add a key below a page, splitting the pages that overflow on the way
+ * back up.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param DiskPage * node, the page, pinned.
+ * @param itemtype value, the key.
+ * @param itemtype * separator, receives the lowest key right of a split.
+ * @param uint32_t * sibling, receives the page right of a split.
+ *
+ * @returns what changed
+ */
+private DiskChange insertInto(DiskRoot * tree, DiskPage * node, itemtype value, itemtype * separator, uint32_t * sibling){
+	DiskPage * child;
+	DiskChange change;
+	itemtype key;
+	uint32_t at, right;
+
+	if(node->leaf){
+		at = lowerBound(node->keys, node->count, value);
+		if(at < node->count && node->keys[at] == value){
+			return DISK_UNCHANGED;
+		}
+		if(node->count == DISK_LEAF_KEYS){
+			return splitLeaf(tree, node, at, value, separator, sibling);
+		}
+		memmove(node->keys + at + 1, node->keys + at, (node->count - at) * sizeof(itemtype));
+		node->keys[at] = value;
+		node->count++;
+		return DISK_CHANGED;
+	}
+	at = childOf(node, value);
+	child = pin(tree, node->inner.children[at]);
+	if(child == NULL){
+		return DISK_FAILED;
+	}
+	change = insertInto(tree, child, value, &key, &right);
+	unpin(tree, child, change == DISK_CHANGED || change == DISK_SPLIT);
+	if(change != DISK_SPLIT){
+		return change;
+	}
+	if(node->count == DISK_INNER_KEYS){
+		return splitInner(tree, node, at, key, right, separator, sibling);
+	}
+	memmove(node->inner.keys + at + 1, node->inner.keys + at, (node->count - at) * sizeof(itemtype));
+	memmove(node->inner.children + at + 2, node->inner.children + at + 1, (node->count - at) * sizeof(uint32_t));
+	node->inner.keys[at] = key;
+	node->inner.children[at + 1] = right;
+	node->count++;
+	return DISK_CHANGED;
+}
+
+/**
+ * Insert a key in the tree; a split of the root grows a new root above it.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param itemtype value, the key.
+ *
+ * @returns true if the key was added, false if it was there or after an error
+ */
+private bool insert(DiskRoot * tree, itemtype value){
+	DiskPage * node = pin(tree, tree->meta.root);
+	DiskChange change;
+	itemtype separator;
+	uint32_t sibling, page;
+
+	if(node == NULL){
+		return false;
+	}
+	change = insertInto(tree, node, value, &separator, &sibling);
+	unpin(tree, node, change == DISK_CHANGED || change == DISK_SPLIT);
+	if(change == DISK_SPLIT){
+		node = allocPage(tree, &page);
+		if(node == NULL){
+			return false;
+		}
+		node->count = 1;
+		node->inner.keys[0] = separator;
+		node->inner.children[0] = tree->meta.root;
+		node->inner.children[1] = sibling;
+		unpin(tree, node, true);
+		tree->meta.root = page;
+		tree->meta.height++;
+	}
+	if(change != DISK_CHANGED && change != DISK_SPLIT){
+		return false;
+	}
+	tree->meta.count++;
+	return true;
+}
+
+/**
+ * move the highest key of the left sibling of a page into it.
+ *
+ * @param DiskPage * parent, the parent.
+ * @param uint32_t at, position of the page in the parent.
+ * @param DiskPage * left, the sibling, children[at - 1].
+ * @param DiskPage * node, the page, children[at].
+ */
+private void borrowLeft(DiskPage * parent, uint32_t at, DiskPage * left, DiskPage * node){
+	if(node->leaf){
+		memmove(node->keys + 1, node->keys, node->count * sizeof(itemtype));
+		node->keys[0] = left->keys[--left->count];
+		parent->inner.keys[at - 1] = node->keys[0];
+	}
+	else{
+		memmove(node->inner.keys + 1, node->inner.keys, node->count * sizeof(itemtype));
+		memmove(node->inner.children + 1, node->inner.children, (node->count + 1) * sizeof(uint32_t));
+		node->inner.keys[0] = parent->inner.keys[at - 1];
+		node->inner.children[0] = left->inner.children[left->count];
+		parent->inner.keys[at - 1] = left->inner.keys[left->count - 1];
+		left->count--;
+	}
+	node->count++;
+}
+
+/**
+ * move the lowest key of the right sibling of a page into it.
+ *
+ * @param DiskPage * parent, the parent.
+ * @param uint32_t at, position of the page in the parent.
+ * @param DiskPage * node, the page, children[at].
+ * @param DiskPage * right, the sibling, children[at + 1].
+ */
+private void borrowRight(DiskPage * parent, uint32_t at, DiskPage * node, DiskPage * right){
+	if(node->leaf){
+		node->keys[node->count] = right->keys[0];
+		memmove(right->keys, right->keys + 1, (right->count - 1) * sizeof(itemtype));
+		right->count--;
+		parent->inner.keys[at] = right->keys[0];
+	}
+	else{
+		node->inner.keys[node->count] = parent->inner.keys[at];
+		node->inner.children[node->count + 1] = right->inner.children[0];
+		parent->inner.keys[at] = right->inner.keys[0];
+		memmove(right->inner.keys, right->inner.keys + 1, (right->count - 1) * sizeof(itemtype));
+		memmove(right->inner.children, right->inner.children + 1, right->count * sizeof(uint32_t));
+		right->count--;
+	}
+	node->count++;
+}
+
+/**
+ * append a page to its left sibling, drop their separator from the
+ * parent and free the page.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param DiskPage * parent, the parent.
+ * @param uint32_t at, position of the left page in the parent.
+ * @param DiskPage * left, children[at].
+ * @param DiskPage * right, children[at + 1], unpinned and freed.
+ */
+private void merge(DiskRoot * tree, DiskPage * parent, uint32_t at, DiskPage * left, DiskPage * right){
+	uint32_t page = parent->inner.children[at + 1];
+	if(left->leaf){
+		memcpy(left->keys + left->count, right->keys, right->count * sizeof(itemtype));
+		left->count += right->count;
+		left->next = right->next;
+	}
+	else{
+		left->inner.keys[left->count] = parent->inner.keys[at];
+		memcpy(left->inner.keys + left->count + 1, right->inner.keys, right->count * sizeof(itemtype));
+		memcpy(left->inner.children + left->count + 1, right->inner.children, (right->count + 1) * sizeof(uint32_t));
+		left->count += right->count + 1;
+	}
+	memmove(parent->inner.keys + at, parent->inner.keys + at + 1, (parent->count - at - 1) * sizeof(itemtype));
+	memmove(parent->inner.children + at + 1, parent->inner.children + at + 2, (parent->count - at - 1) * sizeof(uint32_t));
+	parent->count--;
+	freePage(tree, right, page);
+}
+
+/**
+ * bring a page that fell below its minimum back to it, borrowing a key
+ * from a sibling that has one to spare, else merging with the sibling.
+ * The page is unpinned.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param DiskPage * parent, the parent, pinned.
+ * @param uint32_t at, position of the page in the parent.
+ * @param DiskPage * node, the page, pinned.
+ *
+ * @returns false after an error
+ */
+private bool refill(DiskRoot * tree, DiskPage * parent, uint32_t at, DiskPage * node){
+	DiskPage * sibling;
+	if(at > 0){
+		sibling = pin(tree, parent->inner.children[at - 1]);
+		if(sibling == NULL){
+			unpin(tree, node, true);
+			return false;
+		}
+		if(sibling->count > minimum(sibling)){
+			borrowLeft(parent, at, sibling, node);
+			unpin(tree, node, true);
+		}
+		else{
+			merge(tree, parent, at - 1, sibling, node);
+		}
+		unpin(tree, sibling, true);
+		return true;
+	}
+	sibling = pin(tree, parent->inner.children[1]);
+	if(sibling == NULL){
+		unpin(tree, node, true);
+		return false;
+	}
+	if(sibling->count > minimum(sibling)){
+		borrowRight(parent, 0, node, sibling);
+		unpin(tree, sibling, true);
+	}
+	else{
+		merge(tree, parent, 0, node, sibling);
+	}
+	unpin(tree, node, true);
+	return true;
+}
+
+/**
+ * remove a key below a page, refilling the pages that fall below their
+ * minimum on the way back up.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param DiskPage * node, the page, pinned.
+ * @param itemtype value, the key.
+ *
+ * @returns what changed
+ */
+private DiskChange removeFrom(DiskRoot * tree, DiskPage * node, itemtype value){
+	DiskPage * child;
+	DiskChange change;
+	uint32_t at;
+
+	if(node->leaf){
+		at = lowerBound(node->keys, node->count, value);
+		if(at == node->count || node->keys[at] != value){
+			return DISK_UNCHANGED;
+		}
+		memmove(node->keys + at, node->keys + at + 1, (node->count - at - 1) * sizeof(itemtype));
+		node->count--;
+		return DISK_CHANGED;
+	}
+	at = childOf(node, value);
+	child = pin(tree, node->inner.children[at]);
+	if(child == NULL){
+		return DISK_FAILED;
+	}
+	change = removeFrom(tree, child, value);
+	if(change == DISK_CHANGED && child->count < minimum(child)){
+		return refill(tree, node, at, child) ? DISK_CHANGED : DISK_FAILED;
+	}
+	unpin(tree, child, change == DISK_CHANGED);
+	return change;
+}
+
+/**
+ * Remove a key from the tree; a root left with one child is replaced by it.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param itemtype value, the key.
+ *
+ * @returns true if the key was removed, false if it was absent or after an error
+ */
+private bool removeValue(DiskRoot * tree, itemtype value){
+	DiskPage * node = pin(tree, tree->meta.root);
+	uint32_t page = tree->meta.root;
+	DiskChange change;
+
+	if(node == NULL){
+		return false;
+	}
+	change = removeFrom(tree, node, value);
+	if(change != DISK_CHANGED){
+		unpin(tree, node, false);
+		return false;
+	}
+	tree->meta.count--;
+	if(!node->leaf && node->count == 0){
+		tree->meta.root = node->inner.children[0];
+		tree->meta.height--;
+		freePage(tree, node, page);
+	}
+	else{
+		unpin(tree, node, true);
+	}
+	return true;
+}
+
+/**
+ * Search a key in the tree, one page per level.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param itemtype value, the key.
+ *
+ * @returns true if the key is there
+ */
+private bool search(DiskRoot * tree, itemtype value){
+	DiskPage * node = pin(tree, tree->meta.root);
+	uint32_t at, next;
+	bool found;
+	while(node != NULL && !node->leaf){
+		next = node->inner.children[childOf(node, value)];
+		unpin(tree, node, false);
+		node = pin(tree, next);
+	}
+	if(node == NULL){
+		return false;
+	}
+	at = lowerBound(node->keys, node->count, value);
+	found = at < node->count && node->keys[at] == value;
+	unpin(tree, node, false);
+	return found;
+}
+
+/**
+ * visit the keys in [lo, hi) in ascending order, or every key: descend to
+ * the leaf of lo and follow the leaves to the right.
+ *
+ * @param DiskRoot * tree, the tree.
+ * @param bool bounded, false to visit every key.
+ * @param itemtype lo, lowest key visited.
+ * @param itemtype hi, keys from hi on are not visited.
+ * @param KeyVisitor visit, called once per key.
+ * @param void * context, passed to visit.
+ */
+private void scan(DiskRoot * tree, bool bounded, itemtype lo, itemtype hi, KeyVisitor visit, void * context){
+	DiskPage * node;
+	uint32_t at, next;
+	if(bounded && !(lo < hi)){
+		return;
+	}
+	node = pin(tree, tree->meta.root);
+	while(node != NULL && !node->leaf){
+		next = node->inner.children[bounded ? childOf(node, lo) : 0];
+		unpin(tree, node, false);
+		node = pin(tree, next);
+	}
+	at = (node != NULL && bounded)? lowerBound(node->keys, node->count, lo) : 0;
+	while(node != NULL){
+		for(; at < node->count; at++){
+			if(bounded && !(node->keys[at] < hi)){
+				unpin(tree, node, false);
+				return;
+			}
+			visit(node->keys[at], context);
+		}
+		next = node->next;
+		unpin(tree, node, false);
+		node = (next != 0)? pin(tree, next) : NULL;
+		at = 0;
+	}
+}
+
+/**
+ * Visit every key of the tree in ascending order.
+ */
+private void walk(DiskRoot * tree, KeyVisitor visit, void * context){
+	scan(tree, false, 0, 0, visit, context);
+}
+
+/**
+ * Visit the keys in [lo, hi) in ascending order.
+ */
+private void rangeScan(DiskRoot * tree, itemtype lo, itemtype hi, KeyVisitor visit, void * context){
+	scan(tree, true, lo, hi, visit, context);
+}
+
+/**
+ * Number of keys in the tree.
+ */
+private size_t count(DiskRoot * tree){
+	return (size_t) tree->meta.count;
+}
+
+/**
+ * Levels of pages, 1 while the root is a leaf.
+ */
+private int height(DiskRoot * tree){
+	return (int) tree->meta.height;
+}
+
+/**
+ * Write every changed page and page 0 to the file and sync it.
+ *
+ * @param DiskRoot * tree, the tree.
+ *
+ * @returns false if a write failed, now or before
+ */
+private bool flush(DiskRoot * tree){
+	DiskPage meta;
+	size_t frame;
+	for(frame = 0; frame < tree->n && tree->error == 0; frame++){
+		if(tree->frames[frame].page != 0){
+			clean(tree, (int32_t) frame);
+		}
+	}
+	if(tree->error != 0){
+		return false;
+	}
+	memset(&meta, 0, sizeof(meta));
+	memcpy(&meta, &tree->meta, sizeof(DiskMeta));
+	if(!transfer(tree, &meta, 0, true)){
+		return false;
+	}
+	if(fsync(tree->fd) != 0){
+		tree->error = errno;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * free the pool and close the file, without writing anything.
+ */
+private void release(DiskRoot * tree){
+	if(tree->fd >= 0){
+		close(tree->fd);
+	}
+	free(tree->pages);
+	free(tree->frames);
+	free(tree->buckets);
+	free(tree);
+}
+
+/**
+ * Flush the tree and close it.
+ */
+private void delete(DiskRoot * tree){
+	flush(tree);
+	release(tree);
+}
+
+/**
+ * read page 0 of an existing file, or start an empty tree of one leaf in
+ * a new one.
+ *
+ * @returns false if the file is not a tree of this version and itemtype
+ */
+private bool openFile(DiskRoot * tree){
+	DiskPage meta;
+	DiskPage * node;
+	ssize_t got = pread(tree->fd, &meta, DISK_PAGE, 0);
+	if(got == 0){
+		memcpy(tree->meta.magic, diskMagic, sizeof(diskMagic));
+		tree->meta.version = DISK_VERSION;
+		tree->meta.page_size = DISK_PAGE;
+		tree->meta.key_size = sizeof(itemtype);
+		tree->meta.pages = 1;
+		tree->meta.height = 1;
+		node = allocPage(tree, &tree->meta.root);
+		if(node == NULL){
+			return false;
+		}
+		node->leaf = 1;
+		unpin(tree, node, true);
+		return flush(tree);
+	}
+	if(got != DISK_PAGE){
+		return false;
+	}
+	memcpy(&tree->meta, &meta, sizeof(DiskMeta));
+	return memcmp(tree->meta.magic, diskMagic, sizeof(diskMagic)) == 0
+			&& tree->meta.version == DISK_VERSION
+			&& tree->meta.page_size == DISK_PAGE
+			&& tree->meta.key_size == sizeof(itemtype);
+}
+
+DiskBTree diskbtree(const char * path, size_t frames){
+	DiskBTree new_tree;
+	DiskRoot * tree;
+	size_t i, buckets = 1;
+
+	new_tree.insert = &insert;
+	new_tree.remove = &removeValue;
+	new_tree.search = &search;
+	new_tree.count = &count;
+	new_tree.height = &height;
+	new_tree.walk = &walk;
+	new_tree.rangeScan = &rangeScan;
+	new_tree.flush = &flush;
+	new_tree.delete = &delete;
+	new_tree.root = NULL;
+
+	if(frames < DISK_MIN_FRAMES){
+		frames = DISK_MIN_FRAMES;
+	}
+	while(buckets < 2 * frames){
+		buckets *= 2;
+	}
+	tree = (DiskRoot*) calloc(1, sizeof(DiskRoot));
+	if(tree == NULL){
+		return new_tree;
+	}
+	tree->fd = -1;
+	tree->n = frames;
+	tree->mask = buckets - 1;
+	tree->pages = (DiskPage*) aligned_alloc(DISK_PAGE, frames * DISK_PAGE);
+	tree->frames = (DiskFrame*) calloc(frames, sizeof(DiskFrame));
+	tree->buckets = (int32_t*) malloc(buckets * sizeof(int32_t));
+	if(tree->pages == NULL || tree->frames == NULL || tree->buckets == NULL){
+		release(tree);
+		return new_tree;
+	}
+	for(i = 0; i < frames; i++){
+		tree->frames[i].chain = -1;
+	}
+	for(i = 0; i < buckets; i++){
+		tree->buckets[i] = -1;
+	}
+	tree->fd = open(path, O_RDWR | O_CREAT, 0644);
+	if(tree->fd < 0 || !openFile(tree)){
+		release(tree);
+		return new_tree;
+	}
+	memset(&tree->stats, 0, sizeof(DiskStats));
+	new_tree.root = tree;
+	return new_tree;
+}
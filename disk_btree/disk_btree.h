@@ -0,0 +1,168 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+/**
+ * DISK B+TREE STRUCTURES, TYPES.
+ *
+ * An ordered set of keys kept in a file of DISK_PAGE byte pages, for key
+ * sets larger than memory. Leaves hold the keys, linked left to right for
+ * scans; inner pages hold separators and page numbers. Page 0 describes
+ * the tree, freed pages are chained for reuse.
+ *
+ * Pages are read into a buffer pool of a fixed number of frames and
+ * written back when evicted or flushed. A frame is pinned while an
+ * operation uses it; CLOCK picks the frame to evict: every use sets the
+ * frame's reference bit and the hand, sweeping the frames, clears set
+ * bits and takes the first unpinned frame found with its bit clear, an
+ * approximation of least recently used that costs nothing per hit.
+ *
+ * One thread at a time. Nothing is logged: the file is consistent after
+ * flush or delete, not if the process dies between them.
+ *
+ */
+#ifndef DISK_BTREE_H
+#define DISK_BTREE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define itemtype int
+#define public
+#define private static
+
+/**
+ * Bytes per page, on disk and in the pool.
+ */
+#define DISK_PAGE 4096
+
+/**
+ * Keys per leaf and per inner page, an inner page also holds one more
+ * page number than keys.
+ */
+#define DISK_LEAF_KEYS ((DISK_PAGE - 16) / sizeof(itemtype))
+#define DISK_INNER_KEYS ((DISK_PAGE - 16 - sizeof(uint32_t)) / (sizeof(itemtype) + sizeof(uint32_t)))
+
+/**
+ * Fewest frames of a pool: an insert or remove pins the path from the
+ * root and a sibling per level.
+ */
+#define DISK_MIN_FRAMES 16
+
+/**
+ * A page of the tree. children[i] of an inner page leads to the keys
+ * lower than keys[i] and not lower than keys[i - 1].
+ */
+typedef struct diskpage {
+   uint32_t leaf;                  /* 1 for a leaf */
+   uint32_t count;                 /* keys in the page */
+   uint32_t next;                  /* next leaf, or next free page, 0 for none */
+   uint32_t reserved;
+   union {
+      itemtype keys[DISK_LEAF_KEYS];
+      struct {
+         itemtype keys[DISK_INNER_KEYS];
+         uint32_t children[DISK_INNER_KEYS + 1];
+      }inner;
+   };
+}DiskPage;
+
+/**
+ * Page 0 of the file.
+ */
+typedef struct diskmeta {
+   char magic[8];                  /* "DISKBTRE" */
+   uint32_t version;               /* DISK_VERSION */
+   uint32_t page_size;             /* DISK_PAGE */
+   uint32_t key_size;              /* sizeof(itemtype) */
+   uint32_t root;                  /* page of the root */
+   uint32_t height;                /* levels of pages, 1 when the root is a leaf */
+   uint32_t pages;                 /* pages in the file, page 0 included */
+   uint32_t free_list;             /* first free page, 0 for none */
+   uint32_t reserved;
+   uint64_t count;                 /* keys in the tree */
+}DiskMeta;
+
+#define DISK_VERSION 1
+
+/**
+ * One frame of the buffer pool.
+ */
+typedef struct diskframe {
+   uint32_t page;                  /* page held, 0 for none */
+   uint32_t pins;                  /* operations using the frame */
+   int32_t chain;                  /* next frame of the same bucket, -1 for none */
+   uint8_t referenced;             /* used since the clock hand last passed */
+   uint8_t dirty;                  /* changed since read */
+}DiskFrame;
+
+/**
+ * What the buffer pool did since the tree was opened, or since the
+ * caller last cleared it.
+ */
+typedef struct diskstats {
+   size_t hits;                    /* pages found in the pool */
+   size_t misses;                  /* pages read from the file */
+   size_t writes;                  /* pages written to the file */
+   size_t evictions;               /* frames taken from another page */
+}DiskStats;
+
+typedef struct diskroot {
+   int fd;
+   DiskMeta meta;
+   DiskPage * pages;               /* the frames' pages, page aligned */
+   DiskFrame * frames;
+   size_t n;                       /* number of frames */
+   size_t hand;                    /* next frame the clock looks at */
+   int32_t * buckets;              /* first frame of each bucket, -1 for none */
+   size_t mask;                    /* buckets - 1, a power of two less one */
+   DiskStats stats;
+   int error;                      /* errno of the first failed read or write, then every operation fails */
+}DiskRoot;
+
+/**
+ * Callback of walk and rangeScan, called once per key in ascending
+ * order. It must not change the tree.
+ */
+typedef void (*KeyVisitor)(itemtype value, void * context);
+
+typedef struct diskbtree {
+   bool (*insert)(DiskRoot * tree, itemtype value);
+   bool (*remove)(DiskRoot * tree, itemtype value);
+   bool (*search)(DiskRoot * tree, itemtype value);
+   size_t (*count)(DiskRoot * tree);
+   int (*height)(DiskRoot * tree);
+   void (*walk)(DiskRoot * tree, KeyVisitor visit, void * context);
+   void (*rangeScan)(DiskRoot * tree, itemtype lo, itemtype hi, KeyVisitor visit, void * context);
+   bool (*flush)(DiskRoot * tree);
+   void (*delete)(DiskRoot * tree);
+   DiskRoot * root;
+}DiskBTree;
+
+/**
+ * method constructor, opening the tree of a file or creating an empty
+ * one. tree.delete flushes and closes it, the file stays.
+ *
+ * @param const char * path, the file.
+ * @param size_t frames, pages the buffer pool holds, at least DISK_MIN_FRAMES.
+ *
+ * @returns a new DiskBTree type, root NULL if out of memory, if the file
+ *          could not be opened or is not a tree of this version and itemtype
+ */
+public DiskBTree diskbtree(const char * path, size_t frames);
+
+#endif
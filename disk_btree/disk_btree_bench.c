@@ -0,0 +1,112 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "disk_btree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * monotonic clock in seconds
+ *
+ * @returns the current time in seconds
+ */
+private double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * next value of a xorshift generator.
+ */
+private unsigned long next(unsigned long * seed){
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 7;
+	*seed ^= *seed << 17;
+	return *seed;
+}
+
+/**
+ * hits over hits and misses of the pool, in percent.
+ */
+private double hitRate(const DiskStats * stats){
+	size_t uses = stats->hits + stats->misses;
+	return uses ? 100.0 * stats->hits / uses : 0;
+}
+
+/**
+ * Benchmark program
+ * usage: ./bench [keys] [frames] [file]
+ *
+ * Inserts random keys in [0, 2 keys) into a new tree kept by a pool of
+ * the frames given, then searches random keys of a shrinking part of the
+ * key range, so the pages searched go from many times the pool to a
+ * fraction of it, printing the hit rate and searches per second of each.
+ *
+ */
+int main(int argc, char ** argv){
+	static const double shares[] = {1, 0.5, 0.25, 0.125, 0.0625, 0.03125, 0.015625};
+	size_t n = (argc > 1)? strtoul(argv[1], NULL, 10) : 10000000;
+	size_t frames = (argc > 2)? strtoul(argv[2], NULL, 10) : 4096;
+	const char * path = (argc > 3)? argv[3] : "disk_btree_bench.db";
+	const size_t queries = 1000000;
+	unsigned long seed = 88172645463325252UL;
+	DiskBTree tree;
+	size_t i, s, range, found;
+	double t0, t1;
+
+	remove(path);
+	tree = diskbtree(path, frames);
+	if(tree.root == NULL){
+		perror(path);
+		return 1;
+	}
+	t0 = now();
+	for(i = 0; i < n; i++){
+		tree.insert(tree.root, (itemtype) (next(&seed) % (2 * n)));
+	}
+	tree.flush(tree.root);
+	t1 = now();
+	printf("%zu inserts, pool of %zu pages: %.0f ms, %.2f Mops/s, hit rate %.1f%%, %zu reads, %zu writes\n",
+			n, frames, (t1 - t0) * 1e3, n / (t1 - t0) / 1e6, hitRate(&tree.root->stats),
+			tree.root->stats.misses, tree.root->stats.writes);
+	printf("%zu keys in %u pages, height %d\n", tree.count(tree.root), tree.root->meta.pages, tree.height(tree.root));
+
+	for(s = 0; s < sizeof(shares) / sizeof(shares[0]); s++){
+		range = (size_t) (2 * n * shares[s]);
+		for(i = 0; i < queries / 4; i++){
+			tree.search(tree.root, (itemtype) (next(&seed) % range));
+		}
+		memset(&tree.root->stats, 0, sizeof(DiskStats));
+		found = 0;
+		t0 = now();
+		for(i = 0; i < queries; i++){
+			found += tree.search(tree.root, (itemtype) (next(&seed) % range));
+		}
+		t1 = now();
+		printf("searches over %6.2f%% of the keys, ~%6.0f pages: hit rate %5.1f%%, %.2f Mops/s (%zu found)\n",
+				100 * shares[s], shares[s] * tree.root->meta.pages, hitRate(&tree.root->stats),
+				queries / (t1 - t0) / 1e6, found);
+	}
+	tree.delete(tree.root);
+	remove(path);
+	return 0;
+}
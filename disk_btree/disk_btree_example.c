@@ -0,0 +1,67 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include "disk_btree.h"
+#include <stdio.h>
+
+/**
+ * visitor printing a key.
+ */
+private void printKey(itemtype value, void * context){
+	(void) context;
+	printf("%d ", value);
+}
+
+/**
+ * Main program
+ * Example of how to use the functions of the disk b+tree, on a file in
+ * the current directory kept by a pool of 16 pages
+ *
+ */
+int main(){
+	const char * path = "disk_btree_example.db";
+	DiskBTree tree;
+	int value, found = 0;
+
+	remove(path);
+	tree = diskbtree(path, 16);
+	if(tree.root == NULL){
+		perror(path);
+		return 1;
+	}
+	for(value = 0; value < 100000; value++){
+		tree.insert(tree.root, (value * 7919) % 100000);
+	}
+	for(value = 0; value < 100000; value += 2){
+		tree.remove(tree.root, value);
+	}
+	printf("%zu keys, height %d\n", tree.count(tree.root), tree.height(tree.root));
+	printf("keys in [990, 1010): ");
+	tree.rangeScan(tree.root, 990, 1010, printKey, NULL);
+	printf("\npool: %zu hits, %zu misses, %zu writes\n", tree.root->stats.hits,
+			tree.root->stats.misses, tree.root->stats.writes);
+	tree.delete(tree.root);
+
+	tree = diskbtree(path, 16);
+	for(value = 0; value < 100000; value++){
+		found += tree.search(tree.root, value);
+	}
+	printf("reopened: %zu keys, %d found\n", tree.count(tree.root), found);
+	tree.delete(tree.root);
+	remove(path);
+	return 0;
+}
@@ -0,0 +1,456 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include "disk_btree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * What a walk or a range scan handed to its visitor.
+ */
+typedef struct scancheck {
+   itemtype last;                  /* last key seen */
+   size_t count;                   /* keys seen */
+   long long sum;                  /* sum of the keys seen */
+   bool ordered;                   /* every key above the one before */
+}ScanCheck;
+
+/**
+ * What the pages of a file hold, gathered by checkPage.
+ */
+typedef struct filecheck {
+   FILE * file;
+   DiskMeta meta;
+   uint32_t pages;                 /* pages reached from the root */
+   uint32_t previous;              /* last leaf reached, 0 for none */
+   uint32_t expected;              /* page the last leaf links to */
+   size_t keys;                    /* keys in the leaves */
+   bool valid;
+}FileCheck;
+
+private int failures = 0;
+
+/**
+ * report a mismatch, counted so that the program exits with 1.
+ */
+private void fail(const char * what, long long value){
+	printf("FAILED: %s (%lld)\n", what, value);
+	failures++;
+}
+
+/**
+ * next value of a xorshift generator.
+ */
+private unsigned long next(unsigned long * seed){
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 7;
+	*seed ^= *seed << 17;
+	return *seed;
+}
+
+/**
+ * visitor of walk and rangeScan, counting and summing the keys and
+ * checking that they ascend.
+ */
+private void visitKey(itemtype value, void * context){
+	ScanCheck * check = (ScanCheck*) context;
+	if(check->count > 0 && value <= check->last){
+		check->ordered = false;
+	}
+	check->last = value;
+	check->count++;
+	check->sum += value;
+}
+
+/**
+ * compare a walk or a range scan of [lo, hi) with the model.
+ *
+ * @param DiskBTree * tree, the tree.
+ * @param const unsigned char * model, model[key] is 1 for the keys in the tree.
+ * @param itemtype range, keys of the model, [0, range).
+ * @param bool whole, walk the tree instead of scanning [lo, hi).
+ * @param itemtype lo, lowest key of the scan, may be negative.
+ * @param itemtype hi, key above the scan, may be past range.
+ */
+private void checkScan(DiskBTree * tree, const unsigned char * model, itemtype range, bool whole, itemtype lo, itemtype hi){
+	ScanCheck check = {0, 0, 0, true};
+	size_t count = 0;
+	long long sum = 0;
+	itemtype key;
+
+	if(whole){
+		lo = 0;
+		hi = range;
+		tree->walk(tree->root, visitKey, &check);
+	}
+	else{
+		tree->rangeScan(tree->root, lo, hi, visitKey, &check);
+	}
+	for(key = (lo < 0)? 0 : lo; key < hi && key < range; key++){
+		if(model[key]){
+			count++;
+			sum += key;
+		}
+	}
+	if(!check.ordered){
+		fail(whole ? "walk out of order" : "rangeScan out of order", lo);
+	}
+	if(check.count != count || check.sum != sum){
+		fail(whole ? "walk keys differ from the model" : "rangeScan keys differ from the model", lo);
+	}
+}
+
+/**
+ * read a page of the file.
+ */
+private bool readPage(FileCheck * check, uint32_t page, DiskPage * node){
+	return fseek(check->file, (long) page * DISK_PAGE, SEEK_SET) == 0 && fread(node, DISK_PAGE, 1, check->file) == 1;
+}
+
+/**
+ * check a page of the file and the pages below it: keys in order and
+ * within the separators above them, every leaf at the height of page 0,
+ * leaves linked left to right, and pages at least half full except the
+ * root and the leaves on the right edge, which an append leaves short.
+ *
+ * @param FileCheck * check, the file and what was found so far.
+ * @param uint32_t page, the page.
+ * @param uint32_t depth, level of the page, 1 for the root.
+ * @param long long lo, lowest key allowed.
+ * @param long long hi, key above those allowed.
+ * @param bool edge, the page is on the right edge of the tree.
+ */
+private void checkPage(FileCheck * check, uint32_t page, uint32_t depth, long long lo, long long hi, bool edge){
+	DiskPage * node;
+	uint32_t i;
+
+	node = (DiskPage*) malloc(sizeof(DiskPage));
+	if(node == NULL || page == 0 || page >= check->meta.pages || !readPage(check, page, node)){
+		fail("page missing", page);
+		check->valid = false;
+		free(node);
+		return;
+	}
+	check->pages++;
+	if(node->leaf){
+		if(depth != check->meta.height){
+			fail("leaf not at the height of the tree", page);
+		}
+		if(depth > 1 && !edge && node->count < DISK_LEAF_KEYS / 2){
+			fail("leaf below half full", node->count);
+		}
+		if(check->previous != 0 && check->expected != page){
+			fail("leaf chain broken", page);
+		}
+		for(i = 0; i < node->count; i++){
+			if(node->keys[i] < lo || node->keys[i] >= hi || (i > 0 && node->keys[i] <= node->keys[i - 1])){
+				fail("leaf keys out of order", page);
+				break;
+			}
+		}
+		check->previous = page;
+		check->expected = node->next;
+		check->keys += node->count;
+		free(node);
+		return;
+	}
+	if(node->count == 0 || node->count > DISK_INNER_KEYS || depth >= check->meta.height){
+		fail("inner page malformed", page);
+		check->valid = false;
+		free(node);
+		return;
+	}
+	if(depth > 1 && node->count < DISK_INNER_KEYS / 2){
+		fail("inner page below half full", node->count);
+	}
+	for(i = 0; i <= node->count && check->valid; i++){
+		if(i < node->count && (node->inner.keys[i] < lo || node->inner.keys[i] >= hi || (i > 0 && node->inner.keys[i] <= node->inner.keys[i - 1]))){
+			fail("separators out of order", page);
+		}
+		checkPage(check, node->inner.children[i], depth + 1,
+				(i > 0)? node->inner.keys[i - 1] : lo,
+				(i < node->count)? node->inner.keys[i] : hi,
+				edge && i == node->count);
+	}
+	free(node);
+}
+
+/**
+ * check the file of a flushed or closed tree: the pages reached from the root and
+ * the free chain account for every page, and the leaves hold the keys of
+ * the model.
+ *
+ * @param const char * path, the file.
+ * @param size_t keys, keys in the model.
+ */
+private void checkFile(const char * path, size_t keys){
+	FileCheck check;
+	DiskPage * node;
+	uint32_t page, free_pages = 0;
+
+	memset(&check, 0, sizeof(FileCheck));
+	check.valid = true;
+	check.file = fopen(path, "rb");
+	node = (DiskPage*) malloc(sizeof(DiskPage));
+	if(check.file == NULL || node == NULL || fread(&check.meta, sizeof(DiskMeta), 1, check.file) != 1){
+		fail("file unreadable", 0);
+		if(check.file != NULL){
+			fclose(check.file);
+		}
+		free(node);
+		return;
+	}
+	checkPage(&check, check.meta.root, 1, -(1LL << 40), 1LL << 40, true);
+	if(check.valid && check.expected != 0){
+		fail("last leaf links on", check.expected);
+	}
+	for(page = check.meta.free_list; page != 0 && free_pages <= check.meta.pages; page = node->next){
+		if(!readPage(&check, page, node)){
+			fail("free page missing", page);
+			break;
+		}
+		free_pages++;
+	}
+	if(check.keys != keys || check.meta.count != keys){
+		fail("file keys differ from the model", (long long) check.keys);
+	}
+	if(check.pages + free_pages + 1 != check.meta.pages){
+		fail("pages lost or shared", (long long) check.meta.pages);
+	}
+	free(node);
+	fclose(check.file);
+}
+
+/**
+ * compare the whole tree with the model: count, walk, range scans over
+ * one or more leaves and searches of random keys, then flush it and check
+ * its file.
+ *
+ * @param DiskBTree * tree, the tree.
+ * @param const char * path, the file of the tree.
+ * @param const unsigned char * model, model[key] is 1 for the keys in the tree.
+ * @param itemtype range, keys of the model, [0, range).
+ * @param size_t keys, keys in the model.
+ * @param unsigned long * seed, the generator.
+ */
+private void checkTree(DiskBTree * tree, const char * path, const unsigned char * model, itemtype range, size_t keys, unsigned long * seed){
+	itemtype lo, key;
+	int i;
+	if(tree->root->error != 0){
+		fail("i/o error", tree->root->error);
+	}
+	if(tree->count(tree->root) != keys){
+		fail("count differs from the model", (long long) tree->count(tree->root));
+	}
+	checkScan(tree, model, range, true, 0, 0);
+	for(i = 0; i < 200; i++){
+		lo = (itemtype) (next(seed) % (range + 20)) - 10;
+		checkScan(tree, model, range, false, lo, lo + (itemtype) (next(seed) % (4 * DISK_LEAF_KEYS)));
+	}
+	for(i = 0; i < 10000; i++){
+		key = (itemtype) (next(seed) % range);
+		if(tree->search(tree->root, key) != (model[key] != 0)){
+			fail("search differs from the model", key);
+		}
+	}
+	if(tree->flush(tree->root)){
+		checkFile(path, keys);
+	}
+	else{
+		fail("flush", tree->root->error);
+	}
+}
+
+/**
+ * close the tree, check its file and open it again with the smallest pool.
+ *
+ * @returns false if the file could not be opened again
+ */
+private bool reopen(DiskBTree * tree, const char * path, size_t keys){
+	tree->delete(tree->root);
+	checkFile(path, keys);
+	*tree = diskbtree(path, DISK_MIN_FRAMES);
+	if(tree->root == NULL){
+		fail("reopen", 0);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * random inserts, removes and searches, each checked against the model.
+ *
+ * @param int inserts, out of ten operations, the rest but one are removes.
+ */
+private void mix(DiskBTree * tree, unsigned char * model, itemtype range, size_t * keys, size_t ops, int inserts, unsigned long * seed){
+	itemtype key;
+	size_t i;
+	int op;
+	for(i = 0; i < ops; i++){
+		key = (itemtype) (next(seed) % range);
+		op = (int) (next(seed) % 10);
+		if(op < inserts){
+			if(tree->insert(tree->root, key) != !model[key]){
+				fail("insert differs from the model", key);
+			}
+			else if(!model[key]){
+				model[key] = 1;
+				(*keys)++;
+			}
+		}
+		else if(op < 9){
+			if(tree->remove(tree->root, key) != (model[key] != 0)){
+				fail("remove differs from the model", key);
+			}
+			else if(model[key]){
+				model[key] = 0;
+				(*keys)--;
+			}
+		}
+		else if(tree->search(tree->root, key) != (model[key] != 0)){
+			fail("search differs from the model", key);
+		}
+	}
+}
+
+/**
+ * remove every key in random order, so pages merge while keys around
+ * their separators are still there, comparing the tree with the model
+ * 64 times on the way.
+ *
+ * @returns false if out of memory
+ */
+private bool drain(DiskBTree * tree, const char * path, unsigned char * model, itemtype range, size_t * keys, unsigned long * seed){
+	itemtype * order = (itemtype*) malloc((*keys + 1) * sizeof(itemtype));
+	size_t i, j, n = 0, step;
+	itemtype key;
+	if(order == NULL){
+		return false;
+	}
+	for(key = 0; key < range; key++){
+		if(model[key]){
+			order[n++] = key;
+		}
+	}
+	for(i = n; i > 1; i--){
+		j = next(seed) % i;
+		key = order[i - 1];
+		order[i - 1] = order[j];
+		order[j] = key;
+	}
+	step = n / 64 + 1;
+	for(i = 0; i < n; i++){
+		if(!tree->remove(tree->root, order[i])){
+			fail("remove of a key in the model", order[i]);
+		}
+		model[order[i]] = 0;
+		(*keys)--;
+		if((i + 1) % step == 0){
+			checkTree(tree, path, model, range, *keys, seed);
+		}
+	}
+	free(order);
+	return true;
+}
+
+/**
+ * Test program
+ * usage: ./check [keys] [file]
+ *
+ * Runs random inserts, removes and searches over keys in [0, keys) on a
+ * tree kept by a pool of DISK_MIN_FRAMES pages, checking every result
+ * against an in-memory model. An insert-heavy phase grows the tree to
+ * three levels, so leaves and inner pages split; a remove-heavy phase,
+ * then removing every key in random order, make pages borrow and merge
+ * until the tree is empty, and a last insert-heavy phase takes its pages
+ * back from the free chain. After each phase the tree is compared with
+ * the model by count, walk, rangeScan and search, closed, its file
+ * checked page by page, and opened again. Exits with 1 on any mismatch.
+ *
+ */
+int main(int argc, char ** argv){
+	itemtype range = (argc > 1)? (itemtype) atoi(argv[1]) : 3000000;
+	const char * path = (argc > 2)? argv[2] : "disk_btree_test.db";
+	unsigned long seed = 88172645463325252UL;
+	unsigned char * model;
+	size_t keys = 0;
+	uint32_t pages;
+	DiskBTree tree;
+
+	if(range <= 0){
+		printf("usage: %s [keys] [file]\n", argv[0]);
+		return 1;
+	}
+	model = (unsigned char*) calloc((size_t) range, 1);
+	remove(path);
+	tree = diskbtree(path, DISK_MIN_FRAMES);
+	if(model == NULL || tree.root == NULL){
+		perror(path);
+		free(model);
+		return 1;
+	}
+
+	mix(&tree, model, range, &keys, (size_t) range, 8, &seed);
+	printf("grow:   %zu keys, height %d\n", keys, tree.height(tree.root));
+	if(tree.height(tree.root) < 3){
+		fail("height below 3, give more keys", tree.height(tree.root));
+	}
+	checkTree(&tree, path, model, range, keys, &seed);
+	if(!reopen(&tree, path, keys)){
+		free(model);
+		return 1;
+	}
+	checkTree(&tree, path, model, range, keys, &seed);
+
+	mix(&tree, model, range, &keys, (size_t) range, 3, &seed);
+	printf("shrink: %zu keys, height %d\n", keys, tree.height(tree.root));
+	checkTree(&tree, path, model, range, keys, &seed);
+	if(!reopen(&tree, path, keys)){
+		free(model);
+		return 1;
+	}
+
+	pages = tree.root->meta.pages;
+	if(!drain(&tree, path, model, range, &keys, &seed)){
+		fail("out of memory", 0);
+	}
+	printf("drain:  %zu keys, height %d\n", tree.count(tree.root), tree.height(tree.root));
+	if(tree.height(tree.root) != 1){
+		fail("empty tree above one level", tree.height(tree.root));
+	}
+	checkTree(&tree, path, model, range, keys, &seed);
+	if(!reopen(&tree, path, keys)){
+		free(model);
+		return 1;
+	}
+	checkTree(&tree, path, model, range, keys, &seed);
+
+	mix(&tree, model, range, &keys, (size_t) range, 8, &seed);
+	printf("refill: %zu keys, height %d\n", keys, tree.height(tree.root));
+	if(tree.root->meta.pages > pages && tree.root->meta.free_list != 0){
+		fail("file grown with free pages left", tree.root->meta.pages);
+	}
+	checkTree(&tree, path, model, range, keys, &seed);
+	tree.delete(tree.root);
+	checkFile(path, keys);
+
+	remove(path);
+	free(model);
+	printf("%s\n", failures ? "FAILED" : "OK");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,189 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include <stdlib.h>
+#include <sched.h>
+
+#include "fork_join.h"
+
+/**
+ * push a task on the stack, the lock held.
+ *
+ * @param ForkJoinPool * pool, the pool.
+ * @param ForkJoinJob * job, the task.
+ */
+private void push(ForkJoinPool * pool, ForkJoinJob * job){
+	job->below = pool->top;
+	job->above = NULL;
+	if(pool->top != NULL){
+		pool->top->above = job;
+	}
+	pool->top = job;
+}
+
+/**
+ * take a task off the stack wherever it is, the lock held.
+ *
+ * @param ForkJoinPool * pool, the pool.
+ * @param ForkJoinJob * job, a task on the stack.
+ */
+private void unlink_job(ForkJoinPool * pool, ForkJoinJob * job){
+	if(job->above != NULL){
+		job->above->below = job->below;
+	}
+	else{
+		pool->top = job->below;
+	}
+	if(job->below != NULL){
+		job->below->above = job->above;
+	}
+}
+
+/**
+ * take the newest task off the stack, the lock held.
+ *
+ * @param ForkJoinPool * pool, the pool.
+ *
+ * @returns the task, NULL if there is none
+ */
+private ForkJoinJob * pop(ForkJoinPool * pool){
+	ForkJoinJob * job = pool->top;
+	if(job != NULL){
+		unlink_job(pool, job);
+		atomic_store_explicit(&job->state, FORKJOIN_RUNNING, memory_order_relaxed);
+	}
+	return job;
+}
+
+/**
+ * run a task taken off the stack and mark it done.
+ *
+ * @param ForkJoinJob * job, the task.
+ */
+private void execute(ForkJoinJob * job){
+	job->run(job->argument);
+	atomic_store_explicit(&job->state, FORKJOIN_DONE, memory_order_release);
+}
+
+/**
+ * body of a worker thread: run tasks until the pool stops.
+ *
+ * @param void * argument, the pool.
+ */
+private void * worker(void * argument){
+	ForkJoinPool * pool = (ForkJoinPool*) argument;
+	ForkJoinJob * job;
+	for(;;){
+		pthread_mutex_lock(&pool->lock);
+		while(pool->top == NULL && !pool->stop){
+			pthread_cond_wait(&pool->wake, &pool->lock);
+		}
+		if(pool->top == NULL){
+			pthread_mutex_unlock(&pool->lock);
+			return NULL;
+		}
+		job = pop(pool);
+		pthread_mutex_unlock(&pool->lock);
+		execute(job);
+	}
+}
+
+public ForkJoinPool * forkjoin_create(size_t workers){
+	ForkJoinPool * pool = (ForkJoinPool*) calloc(1, sizeof(ForkJoinPool));
+	size_t i;
+	if(pool == NULL){
+		return NULL;
+	}
+	pool->threads = (pthread_t*) malloc((workers > 0 ? workers : 1) * sizeof(pthread_t));
+	if(pool->threads == NULL){
+		free(pool);
+		return NULL;
+	}
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->wake, NULL);
+	for(i = 0; i < workers; i++){
+		if(pthread_create(&pool->threads[i], NULL, worker, pool) != 0){
+			break;
+		}
+		pool->workers++;
+	}
+	if(pool->workers < workers){
+		forkjoin_destroy(pool);
+		return NULL;
+	}
+	return pool;
+}
+
+public void forkjoin_fork(ForkJoinPool * pool, ForkJoinJob * job, ForkJoinTask run, void * argument){
+	job->run = run;
+	job->argument = argument;
+	if(pool == NULL || pool->workers == 0){
+		atomic_init(&job->state, FORKJOIN_RUNNING);
+		execute(job);
+		return;
+	}
+	atomic_init(&job->state, FORKJOIN_QUEUED);
+	pthread_mutex_lock(&pool->lock);
+	push(pool, job);
+	pthread_mutex_unlock(&pool->lock);
+	pthread_cond_signal(&pool->wake);
+}
+
+public void forkjoin_join(ForkJoinPool * pool, ForkJoinJob * job){
+	ForkJoinJob * other;
+	if(atomic_load_explicit(&job->state, memory_order_acquire) == FORKJOIN_DONE){
+		return;
+	}
+	pthread_mutex_lock(&pool->lock);
+	if(atomic_load_explicit(&job->state, memory_order_relaxed) == FORKJOIN_QUEUED){
+		unlink_job(pool, job);
+		atomic_store_explicit(&job->state, FORKJOIN_RUNNING, memory_order_relaxed);
+		pthread_mutex_unlock(&pool->lock);
+		execute(job);
+		return;
+	}
+	pthread_mutex_unlock(&pool->lock);
+	while(atomic_load_explicit(&job->state, memory_order_acquire) != FORKJOIN_DONE){
+		pthread_mutex_lock(&pool->lock);
+		other = pop(pool);
+		pthread_mutex_unlock(&pool->lock);
+		if(other != NULL){
+			execute(other);
+		}
+		else{
+			sched_yield();
+		}
+	}
+}
+
+public void forkjoin_destroy(ForkJoinPool * pool){
+	size_t i;
+	if(pool == NULL){
+		return;
+	}
+	pthread_mutex_lock(&pool->lock);
+	pool->stop = 1;
+	pthread_mutex_unlock(&pool->lock);
+	pthread_cond_broadcast(&pool->wake);
+	for(i = 0; i < pool->workers; i++){
+		pthread_join(pool->threads[i], NULL);
+	}
+	pthread_cond_destroy(&pool->wake);
+	pthread_mutex_destroy(&pool->lock);
+	free(pool->threads);
+	free(pool);
+}
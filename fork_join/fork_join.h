@@ -0,0 +1,106 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+/**
+ * FORK-JOIN POOL STRUCTURES, TYPES.
+ *
+ * A fixed set of worker threads running tasks forked by recursive
+ * divide and conquer code. forkjoin_fork makes a task available to the
+ * workers; forkjoin_join waits for it and, while it waits, runs other
+ * forked tasks instead of sleeping, or takes its own task back and runs
+ * it if no worker started it yet. Joining therefore never blocks a thread
+ * that could do useful work, and recursion of any depth cannot run out
+ * of workers.
+ *
+ * Tasks wait on one shared stack behind a mutex, newest on top, so tasks
+ * should be coarse: fork only while the work left is large.
+ *
+ */
+#ifndef FORK_JOIN_H
+#define FORK_JOIN_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define public
+#define private static
+
+/**
+ * Body of a task.
+ */
+typedef void (*ForkJoinTask)(void * argument);
+
+/**
+ * A forked task, owned by the code that forks and joins it, usually on
+ * its stack.
+ */
+typedef struct forkjoinjob {
+   ForkJoinTask run;
+   void * argument;
+   _Atomic int state;             /* FORKJOIN_QUEUED, RUNNING or DONE */
+   struct forkjoinjob * below;    /* next task of the stack */
+   struct forkjoinjob * above;
+}ForkJoinJob;
+
+typedef enum {FORKJOIN_QUEUED, FORKJOIN_RUNNING, FORKJOIN_DONE} ForkJoinState;
+
+typedef struct forkjoinpool {
+   pthread_mutex_t lock;
+   pthread_cond_t wake;           /* signalled when a task is forked or at shutdown */
+   ForkJoinJob * top;             /* tasks forked and not started yet */
+   pthread_t * threads;
+   size_t workers;
+   int stop;
+}ForkJoinPool;
+
+/**
+ * start a pool.
+ *
+ * @param size_t workers, worker threads besides the callers, 0 to run every task where it is forked.
+ *
+ * @returns the pool, NULL if out of memory or a thread could not start
+ */
+public ForkJoinPool * forkjoin_create(size_t workers);
+
+/**
+ * make a task available to the workers, run at once if the pool is NULL
+ * or has no workers.
+ *
+ * @param ForkJoinPool * pool, the pool.
+ * @param ForkJoinJob * job, the task, must stay alive until joined.
+ * @param ForkJoinTask run, body of the task.
+ * @param void * argument, passed to run.
+ */
+public void forkjoin_fork(ForkJoinPool * pool, ForkJoinJob * job, ForkJoinTask run, void * argument);
+
+/**
+ * wait until a forked task has run, running it or other tasks meanwhile.
+ *
+ * @param ForkJoinPool * pool, the pool.
+ * @param ForkJoinJob * job, the task.
+ */
+public void forkjoin_join(ForkJoinPool * pool, ForkJoinJob * job);
+
+/**
+ * stop the workers and free the pool. Every forked task must be joined.
+ *
+ * @param ForkJoinPool * pool, the pool.
+ */
+public void forkjoin_destroy(ForkJoinPool * pool);
+
+#endif
@@ -0,0 +1,79 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include "fork_join.h"
+#include <stdio.h>
+
+/**
+ * a range of an array to sum.
+ */
+typedef struct {
+	ForkJoinPool * pool;
+	const long * values;
+	size_t n;
+	long sum;
+}Range;
+
+/**
+ * sum a range, forking its first half while it is large.
+ *
+ * @param void * argument, the Range.
+ */
+private void sum(void * argument){
+	Range * range = (Range*) argument;
+	Range half;
+	ForkJoinJob job;
+	size_t i;
+	if(range->n < 4096){
+		range->sum = 0;
+		for(i = 0; i < range->n; i++){
+			range->sum += range->values[i];
+		}
+		return;
+	}
+	half.pool = range->pool;
+	half.values = range->values;
+	half.n = range->n / 2;
+	forkjoin_fork(range->pool, &job, sum, &half);
+	range->values += half.n;
+	range->n -= half.n;
+	sum(range);
+	forkjoin_join(range->pool, &job);
+	range->sum += half.sum;
+}
+
+/**
+ * Main program
+ * Example of how to use the fork-join pool
+ *
+ */
+int main(){
+	static long values[1000000];
+	Range range;
+	size_t i;
+
+	for(i = 0; i < 1000000; i++){
+		values[i] = (long) i;
+	}
+	range.pool = forkjoin_create(4);
+	range.values = values;
+	range.n = 1000000;
+	sum(&range);
+	printf("sum of 0 .. 999999 = %ld\n", range.sum);
+	forkjoin_destroy(range.pool);
+	return 0;
+}
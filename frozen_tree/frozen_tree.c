@@ -0,0 +1,314 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "frozen_tree.h"
+
+_Static_assert(sizeof(FrozenHeader) == 64, "keys must start 64-byte aligned in a saved file");
+
+static const char frozenMagic[8] = {'F', 'R', 'O', 'Z', 'T', 'R', 'E', 'E'};
+
+/**
+ * next value of a sorted array, the context of frozentree_from_sorted
+ */
+typedef struct {
+	const itemtype * values;
+	size_t next;
+}SortedValues;
+
+static itemtype nextSorted(void * context){
+	SortedValues * sorted = (SortedValues*) context;
+	return sorted->values[sorted->next++];
+}
+
+FrozenTree frozentree_from_sorted(const itemtype * values, size_t n){
+	SortedValues sorted;
+	sorted.values = values;
+	sorted.next = 0;
+	return frozentree_build(n, nextSorted, &sorted);
+}
+
+/**
+ * Eytzinger index of the lowest key, the leftmost index.
+ *
+ * @param size_t n, number of keys, at least 1.
+ *
+ * @returns the index
+ */
+static size_t firstIndex(size_t n){
+	size_t k = 1;
+	while (2 * k <= n){
+		k = 2 * k;
+	}
+	return k;
+}
+
+/**
+ * Eytzinger index of the next key in ascending order: the leftmost index
+ * of the right subtree of k, or else the parent of the first ancestor
+ * reached from a left child.
+ *
+ * @param size_t k, index of a key.
+ * @param size_t n, number of keys.
+ *
+ * @returns the index, 0 past the highest key
+ */
+static size_t nextIndex(size_t k, size_t n){
+	if (2 * k + 1 <= n){
+		k = 2 * k + 1;
+		while (2 * k <= n){
+			k = 2 * k;
+		}
+		return k;
+	}
+	while (k & 1){
+		k >>= 1;
+	}
+	return k >> 1;
+}
+
+FrozenTree frozentree_build(size_t n, itemtype (*next)(void * context), void * context){
+	FrozenTree tree;
+	size_t bytes, i, k;
+
+	tree.keys = NULL;
+	tree.n = 0;
+	tree.map = NULL;
+	tree.map_bytes = 0;
+	if (n == 0){
+		return tree;
+	}
+	bytes = ((n + 1) * sizeof(itemtype) + 63) / 64 * 64;
+	tree.keys = (itemtype*) aligned_alloc(64, bytes);
+	if (tree.keys == NULL){
+		return tree;
+	}
+	tree.n = n;
+	tree.keys[0] = 0;
+
+	k = firstIndex(n);
+	for (i = 0; i < n; i++){
+		tree.keys[k] = next(context);
+		k = nextIndex(k, n);
+	}
+	return tree;
+}
+
+void frozentree_to_sorted(const FrozenTree * tree, itemtype * values){
+	size_t i, k;
+	if (tree->n == 0){
+		return;
+	}
+	k = firstIndex(tree->n);
+	for (i = 0; i < tree->n; i++){
+		values[i] = tree->keys[k];
+		k = nextIndex(k, tree->n);
+	}
+}
+
+void frozentree_free(FrozenTree * tree){
+	if (tree->map != NULL){
+		munmap(tree->map, tree->map_bytes);
+	}
+	else{
+		free(tree->keys);
+	}
+	tree->keys = NULL;
+	tree->n = 0;
+	tree->map = NULL;
+	tree->map_bytes = 0;
+}
+
+/**
+ * one step of the checksum, a multiply and rotate as in xxHash.
+ */
+static uint64_t checksumRound(uint64_t h, uint64_t word){
+	h ^= word * 0xc2b2ae3d27d4eb4fULL;
+	h = (h << 31) | (h >> 33);
+	return h * 0x9e3779b185ebca87ULL;
+}
+
+/**
+ * 64 bit checksum of a buffer. Four independent lanes take 32 bytes per
+ * step so their multiplies overlap, the rest goes through the first lane.
+ *
+ * @param const unsigned char * bytes, the buffer.
+ * @param size_t length, its length.
+ *
+ * @returns the checksum
+ */
+static uint64_t checksumBytes(const unsigned char * bytes, size_t length){
+	uint64_t lane[4] = {1, 2, 3, 4};
+	uint64_t word, h;
+	size_t i = 0;
+	int j;
+
+	for (; i + 32 <= length; i += 32){
+		for (j = 0; j < 4; j++){
+			memcpy(&word, bytes + i + 8 * j, 8);
+			lane[j] = checksumRound(lane[j], word);
+		}
+	}
+	for (; i < length; i += 8){
+		word = 0;
+		memcpy(&word, bytes + i, (length - i < 8)? length - i : 8);
+		lane[0] = checksumRound(lane[0], word);
+	}
+	h = lane[0] ^ ((lane[1] << 7) | (lane[1] >> 57)) ^ ((lane[2] << 12) | (lane[2] >> 52)) ^ ((lane[3] << 18) | (lane[3] >> 46));
+	h ^= length;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return h;
+}
+
+uint64_t frozentree_checksum(const FrozenTree * tree){
+	itemtype none = 0;
+	if (tree->keys == NULL){
+		return checksumBytes((const unsigned char*) &none, sizeof(itemtype));
+	}
+	return checksumBytes((const unsigned char*) tree->keys, (tree->n + 1) * sizeof(itemtype));
+}
+
+FrozenStatus frozentree_save(const FrozenTree * tree, const char * path){
+	FrozenHeader header;
+	itemtype none = 0;
+	const itemtype * keys = (tree->keys != NULL)? tree->keys : &none;
+	size_t length = strlen(path);
+	char * temporary = (char*) malloc(length + 5);
+	FILE * file;
+	int ok;
+
+	if (temporary == NULL){
+		return FROZEN_ENOMEM;
+	}
+	memcpy(temporary, path, length);
+	memcpy(temporary + length, ".tmp", 5);
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, frozenMagic, sizeof(frozenMagic));
+	header.version = FROZEN_VERSION;
+	header.key_size = sizeof(itemtype);
+	header.n = tree->n;
+	header.checksum = frozentree_checksum(tree);
+	header.byte_order = FROZEN_BYTE_ORDER;
+
+	file = fopen(temporary, "wb");
+	if (file == NULL){
+		free(temporary);
+		return FROZEN_EIO;
+	}
+	ok = fwrite(&header, sizeof(header), 1, file) == 1
+			&& fwrite(keys, sizeof(itemtype), tree->n + 1, file) == tree->n + 1
+			&& fflush(file) == 0
+			&& fsync(fileno(file)) == 0;
+	ok = (fclose(file) == 0) && ok;
+	ok = ok && rename(temporary, path) == 0;
+	if (!ok){
+		remove(temporary);
+	}
+	free(temporary);
+	return ok ? FROZEN_OK : FROZEN_EIO;
+}
+
+/**
+ * check the header of a mapped file.
+ *
+ * @param const FrozenHeader * header, the start of the mapping.
+ * @param size_t bytes, the length of the file, at least a header.
+ *
+ * @returns FROZEN_OK, FROZEN_EFORMAT or FROZEN_EVERSION
+ */
+static FrozenStatus checkHeader(const FrozenHeader * header, size_t bytes){
+	size_t keys = (bytes - sizeof(FrozenHeader)) / sizeof(itemtype);
+	if (memcmp(header->magic, frozenMagic, sizeof(frozenMagic)) != 0
+			|| header->byte_order != FROZEN_BYTE_ORDER){
+		return FROZEN_EFORMAT;
+	}
+	if (header->version != FROZEN_VERSION){
+		return FROZEN_EVERSION;
+	}
+	if (header->key_size != sizeof(itemtype)
+			|| keys == 0 || header->n != keys - 1
+			|| (bytes - sizeof(FrozenHeader)) % sizeof(itemtype) != 0){
+		return FROZEN_EFORMAT;
+	}
+	return FROZEN_OK;
+}
+
+/**
+ * The file is mapped private and read only, so lookups fault in only
+ * the pages they reach; readahead is turned off for the same reason,
+ * except while verifying, which reads every key in order.
+ */
+FrozenStatus frozentree_load(const char * path, int verify, FrozenTree * tree){
+	const FrozenHeader * header;
+	struct stat status;
+	FrozenStatus result;
+	void * map;
+	int fd;
+
+	tree->keys = NULL;
+	tree->n = 0;
+	tree->map = NULL;
+	tree->map_bytes = 0;
+	fd = open(path, O_RDONLY);
+	if (fd < 0){
+		return FROZEN_EIO;
+	}
+	if (fstat(fd, &status) != 0){
+		close(fd);
+		return FROZEN_EIO;
+	}
+	if ((size_t) status.st_size < sizeof(FrozenHeader)){
+		close(fd);
+		return FROZEN_EFORMAT;
+	}
+	map = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED){
+		return FROZEN_EIO;
+	}
+	header = (const FrozenHeader*) map;
+	result = checkHeader(header, (size_t) status.st_size);
+	if (result != FROZEN_OK){
+		munmap(map, (size_t) status.st_size);
+		return result;
+	}
+	tree->keys = (itemtype*) ((char*) map + sizeof(FrozenHeader));
+	tree->n = (size_t) header->n;
+	tree->map = map;
+	tree->map_bytes = (size_t) status.st_size;
+	if (verify){
+		posix_madvise(map, tree->map_bytes, POSIX_MADV_SEQUENTIAL);
+		if (frozentree_checksum(tree) != header->checksum){
+			frozentree_free(tree);
+			return FROZEN_ECHECKSUM;
+		}
+	}
+	posix_madvise(map, tree->map_bytes, POSIX_MADV_RANDOM);
+	return FROZEN_OK;
+}
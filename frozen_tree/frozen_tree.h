@@ -0,0 +1,207 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+/**
+ * FROZEN TREE STRUCTURES, TYPES.
+ *
+ * A read-only snapshot of a search tree stored as one array in Eytzinger
+ * order: the root at keys[1] and the children of keys[k] at keys[2k] and
+ * keys[2k + 1], the layout of a binary heap. Lookups compute the next index
+ * instead of loading a pointer, which lets them run without branches and
+ * prefetch the line holding the 16 descendants four levels down.
+ *
+ * avltree_freeze and binarytree_freeze build one from a live tree.
+ *
+ * frozentree_save writes the array to a file behind a FrozenHeader and
+ * frozentree_load maps that file back: keys then point into the mapping,
+ * nothing is copied or allocated per key, and only the pages lookups
+ * reach are ever read.
+ *
+ */
+#ifndef FROZEN_TREE_H
+#define FROZEN_TREE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define itemtype int
+
+typedef struct frozentree {
+   itemtype * keys;  /* keys[1 .. n] in Eytzinger order, 64-byte aligned, keys[0] unused */
+   size_t n;         /* number of keys */
+   void * map;       /* the file mapped by frozentree_load, NULL if keys came from malloc */
+   size_t map_bytes; /* length of the mapping */
+}FrozenTree;
+
+/**
+ * Version written by frozentree_save, the only one frozentree_load reads.
+ */
+#define FROZEN_VERSION 1
+
+/**
+ * Byte order mark, read back as something else on a host of the other
+ * byte order.
+ */
+#define FROZEN_BYTE_ORDER 0x01020304u
+
+/**
+ * First 64 bytes of a saved frozen tree. keys[0 .. n] follow as they are
+ * in memory, so they start 64-byte aligned in a mapping of the file and
+ * the file is 64 + (n + 1) * key_size bytes long.
+ */
+typedef struct frozenheader {
+   char magic[8];        /* "FROZTREE" */
+   uint32_t version;     /* FROZEN_VERSION */
+   uint32_t key_size;    /* sizeof(itemtype) */
+   uint64_t n;           /* number of keys */
+   uint64_t checksum;    /* frozentree_checksum of keys[0 .. n] */
+   uint32_t byte_order;  /* FROZEN_BYTE_ORDER */
+   uint32_t reserved[7]; /* zero */
+}FrozenHeader;
+
+/**
+ * Results of saving and loading.
+ */
+typedef enum {
+   FROZEN_OK,
+   FROZEN_EIO,        /* the file could not be opened, read, mapped or written, see errno */
+   FROZEN_ENOMEM,     /* out of memory */
+   FROZEN_EFORMAT,    /* not a frozen tree of this itemtype and byte order, or truncated */
+   FROZEN_EVERSION,   /* a frozen tree of another version */
+   FROZEN_ECHECKSUM   /* the keys do not match the checksum */
+}FrozenStatus;
+
+/**
+ * build a frozen tree of sorted values.
+ *
+ * @param const itemtype * values, the values in ascending order.
+ * @param size_t n, number of values.
+ *
+ * @returns a new FrozenTree, with no keys if out of memory
+ */
+FrozenTree frozentree_from_sorted(const itemtype * values, size_t n);
+
+/**
+ * build a frozen tree of n values pulled in ascending order from a
+ * callback, so a live tree can be frozen without a sorted copy.
+ *
+ * @param size_t n, number of values.
+ * @param itemtype (*next)(void * context), returns the next value.
+ * @param void * context, passed to next.
+ *
+ * @returns a new FrozenTree, with no keys if out of memory
+ */
+FrozenTree frozentree_build(size_t n, itemtype (*next)(void * context), void * context);
+
+/**
+ * release the keys of a frozen tree, or unmap its file.
+ *
+ * @param FrozenTree * tree, the tree, left empty.
+ */
+void frozentree_free(FrozenTree * tree);
+
+/**
+ * write a frozen tree to a file, through a temporary file renamed over
+ * path once synced, so a crash never leaves path half written.
+ *
+ * @param const FrozenTree * tree, the tree.
+ * @param const char * path, the file.
+ *
+ * @returns FROZEN_OK, FROZEN_ENOMEM or FROZEN_EIO
+ */
+FrozenStatus frozentree_save(const FrozenTree * tree, const char * path);
+
+/**
+ * map a file written by frozentree_save, read only. The header is
+ * checked; the keys are read by the lookups that reach them, or all at
+ * once here when verify is set, to compare them with the checksum.
+ * frozentree_free unmaps the file.
+ *
+ * @param const char * path, the file.
+ * @param int verify, non zero to check the checksum.
+ * @param FrozenTree * tree, receives the tree, with no keys on failure.
+ *
+ * @returns FROZEN_OK or the reason the file was refused
+ */
+FrozenStatus frozentree_load(const char * path, int verify, FrozenTree * tree);
+
+/**
+ * checksum of a frozen tree as kept in its FrozenHeader, over keys[0 .. n].
+ *
+ * @param const FrozenTree * tree, the tree.
+ *
+ * @returns the checksum
+ */
+uint64_t frozentree_checksum(const FrozenTree * tree);
+
+/**
+ * copy the keys of a frozen tree in ascending order, to rebuild a live
+ * tree with avltree_from_sorted or binarytree_from_sorted.
+ *
+ * @param const FrozenTree * tree, the tree.
+ * @param itemtype * values, receives the n keys.
+ */
+void frozentree_to_sorted(const FrozenTree * tree, itemtype * values);
+
+/**
+ * Eytzinger index of the lowest key not lower than value. The descent is
+ * a fixed number of steps with no data dependent branch; the trailing
+ * right turns are undone at the end.
+ *
+ * @param const FrozenTree * tree, the tree.
+ * @param itemtype value, value searched.
+ *
+ * @returns the index of the key, 0 if every key is lower than value
+ */
+static inline size_t frozen_lower_bound_index(const FrozenTree * tree, itemtype value){
+   const itemtype * keys = tree->keys;
+   size_t k = 1;
+   while (k <= tree->n){
+      __builtin_prefetch(keys + 16 * k);
+      k = 2 * k + (keys[k] < value);
+   }
+   k >>= __builtin_ffsll(~(long long) k);
+   return k;
+}
+
+/**
+ * lowest key not lower than value.
+ *
+ * @param const FrozenTree * tree, the tree.
+ * @param itemtype value, value searched.
+ *
+ * @returns a pointer to the key, NULL if every key is lower than value
+ */
+static inline const itemtype * frozen_lower_bound(const FrozenTree * tree, itemtype value){
+   size_t k = frozen_lower_bound_index(tree, value);
+   return (k == 0)? NULL : &tree->keys[k];
+}
+
+/**
+ * Search elements in frozen tree.
+ *
+ * @param const FrozenTree * tree, the tree.
+ * @param itemtype value, value searched.
+ *
+ * @returns a pointer to the key, NULL if absent
+ */
+static inline const itemtype * frozen_search(const FrozenTree * tree, itemtype value){
+   size_t k = frozen_lower_bound_index(tree, value);
+   return (k != 0 && tree->keys[k] == value)? &tree->keys[k] : NULL;
+}
+
+#endif
@@ -0,0 +1,489 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "lockfree_bst.h"
+
+/**
+ * low bits of an edge: FLAG marks the edge to a leaf being removed, TAG an
+ * edge that must not change any more because its node is being removed.
+ */
+#define FLAG ((uintptr_t) 1)
+#define TAG ((uintptr_t) 2)
+
+/**
+ * the node an edge points to.
+ */
+#define ADDRESS(edge) ((LockFreeNode*) ((edge) & ~(FLAG | TAG)))
+
+/**
+ * nodes found by seek: the leaf where the value is or would be, its
+ * parent, and the last untagged edge above them, from ancestor to
+ * successor. A remove swings that edge.
+ */
+typedef struct {
+	LockFreeNode * ancestor;
+	LockFreeNode * successor;
+	LockFreeNode * parent;
+	LockFreeNode * leaf;
+}SeekRecord;
+
+/**
+ * create a node.
+ *
+ * @param itemtype key, key of the node.
+ * @param LockFreeNode * left, left child, NULL for a leaf.
+ * @param LockFreeNode * right, right child, NULL for a leaf.
+ *
+ * @returns the new node, NULL if out of memory
+ */
+private LockFreeNode * createNode(itemtype key, LockFreeNode * left, LockFreeNode * right){
+	LockFreeNode * node = (LockFreeNode*) malloc(sizeof(LockFreeNode));
+	if(node == NULL){
+		return NULL;
+	}
+	node->key = key;
+	atomic_init(&node->left, (uintptr_t) left);
+	atomic_init(&node->right, (uintptr_t) right);
+	node->retired = NULL;
+	return node;
+}
+
+/**
+ * free a limbo list.
+ *
+ * @param LockFreeNode * node, the first node of the list.
+ */
+private void freeList(LockFreeNode * node){
+	LockFreeNode * next;
+	while(node != NULL){
+		next = node->retired;
+		free(node);
+		node = next;
+	}
+}
+
+/**
+ * move the global epoch on if every thread inside an operation announced
+ * the current one.
+ *
+ * @param LockFreeRoot * tree, the tree.
+ * @param unsigned long epoch, the epoch the caller announced.
+ */
+private void tryAdvance(LockFreeRoot * tree, unsigned long epoch){
+	LockFreeThread * thread;
+	unsigned long announced;
+	for(thread = atomic_load(&tree->threads); thread != NULL; thread = thread->next){
+		announced = atomic_load(&thread->announced);
+		if((announced & 1) && (announced >> 1) != epoch){
+			return;
+		}
+	}
+	atomic_compare_exchange_strong(&tree->epoch, &epoch, epoch + 1);
+}
+
+/**
+ * start an operation: announce the global epoch, free the limbo lists at
+ * least two epochs old and now and then try to move the epoch on.
+ *
+ * @param LockFreeThread * self, the record of the calling thread.
+ */
+private void enter(LockFreeThread * self){
+	unsigned long epoch = atomic_load(&self->tree->epoch);
+	int i;
+
+	atomic_store(&self->announced, (epoch << 1) | 1);
+	atomic_thread_fence(memory_order_seq_cst);
+	for(i = 0; i < 3; i++){
+		if(self->limbo[i] != NULL && self->limbo_epoch[i] + 2 <= epoch){
+			freeList(self->limbo[i]);
+			self->limbo[i] = NULL;
+		}
+	}
+	if(self->retired >= LOCKFREE_RETIRE_BATCH){
+		self->retired = 0;
+		tryAdvance(self->tree, epoch);
+	}
+}
+
+/**
+ * end an operation, nodes read since enter may be freed from now on.
+ *
+ * @param LockFreeThread * self, the record of the calling thread.
+ */
+private void leave(LockFreeThread * self){
+	atomic_store_explicit(&self->announced, atomic_load_explicit(&self->announced, memory_order_relaxed) & ~1UL,
+			memory_order_release);
+}
+
+/**
+ * hand a node unlinked from the tree to the limbo list of the current
+ * epoch; a list left from three epochs ago is freed to make room.
+ *
+ * @param LockFreeThread * self, the record of the calling thread.
+ * @param LockFreeNode * node, the node.
+ */
+private void retire(LockFreeThread * self, LockFreeNode * node){
+	unsigned long epoch = atomic_load(&self->tree->epoch);
+	int slot = epoch % 3;
+	if(self->limbo_epoch[slot] != epoch){
+		freeList(self->limbo[slot]);
+		self->limbo[slot] = NULL;
+		self->limbo_epoch[slot] = epoch;
+	}
+	node->retired = self->limbo[slot];
+	self->limbo[slot] = node;
+	self->retired++;
+}
+
+/**
+ * follow value down to a leaf.
+ *
+ * @param LockFreeRoot * tree, the tree.
+ * @param itemtype key, value searched.
+ * @param SeekRecord * s, receives the nodes found.
+ */
+private void seek(LockFreeRoot * tree, itemtype key, SeekRecord * s){
+	uintptr_t parentField, currentField;
+	LockFreeNode * current;
+
+	s->ancestor = tree->r;
+	s->successor = tree->s;
+	s->parent = tree->s;
+	parentField = atomic_load_explicit(&tree->s->left, memory_order_acquire);
+	s->leaf = ADDRESS(parentField);
+	currentField = atomic_load_explicit(&s->leaf->left, memory_order_acquire);
+	current = ADDRESS(currentField);
+	while(current != NULL){
+		if(!(parentField & TAG)){
+			s->ancestor = s->parent;
+			s->successor = s->leaf;
+		}
+		s->parent = s->leaf;
+		s->leaf = current;
+		parentField = currentField;
+		currentField = atomic_load_explicit((key < current->key)? &current->left : &current->right, memory_order_acquire);
+		current = ADDRESS(currentField);
+	}
+}
+
+/**
+ * retire the nodes cut off by a successful cleanup: the inner nodes from
+ * successor down to parent, each with the flagged leaf hanging from it.
+ *
+ * @param LockFreeThread * self, the record of the calling thread.
+ * @param itemtype key, value whose path was cut.
+ * @param SeekRecord * s, the seek record of the cleanup.
+ * @param _Atomic uintptr_t * kept, the edge of parent that was moved up.
+ */
+private void retireCut(LockFreeThread * self, itemtype key, SeekRecord * s, _Atomic uintptr_t * kept){
+	LockFreeNode * node = s->successor;
+	LockFreeNode * next;
+	while(node != s->parent){
+		if(key < node->key){
+			next = ADDRESS(atomic_load(&node->left));
+			retire(self, ADDRESS(atomic_load(&node->right)));
+		}
+		else{
+			next = ADDRESS(atomic_load(&node->right));
+			retire(self, ADDRESS(atomic_load(&node->left)));
+		}
+		retire(self, node);
+		node = next;
+	}
+	retire(self, ADDRESS(atomic_load((kept == &node->left)? &node->right : &node->left)));
+	retire(self, node);
+}
+
+/**
+ * finish a remove whose leaf edge is flagged: tag the sibling edge so it
+ * stays put, then swing the edge from ancestor to successor over to the
+ * sibling, cutting off parent and the flagged leaf.
+ *
+ * @param LockFreeThread * self, the record of the calling thread.
+ * @param itemtype key, value being removed.
+ * @param SeekRecord * s, where seek found it.
+ *
+ * @returns true if this call cut the leaf off
+ */
+private bool cleanup(LockFreeThread * self, itemtype key, SeekRecord * s){
+	LockFreeNode * parent = s->parent;
+	_Atomic uintptr_t * successorAddr = (key < s->ancestor->key)? &s->ancestor->left : &s->ancestor->right;
+	_Atomic uintptr_t * childAddr;
+	_Atomic uintptr_t * siblingAddr;
+	uintptr_t sibling, expected;
+
+	if(key < parent->key){
+		childAddr = &parent->left;
+		siblingAddr = &parent->right;
+	}
+	else{
+		childAddr = &parent->right;
+		siblingAddr = &parent->left;
+	}
+	if(!(atomic_load(childAddr) & FLAG)){
+		siblingAddr = childAddr;
+	}
+	sibling = atomic_fetch_or(siblingAddr, TAG);
+	expected = (uintptr_t) s->successor;
+	if(atomic_compare_exchange_strong(successorAddr, &expected, sibling & ~TAG)){
+		retireCut(self, key, s, siblingAddr);
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Insert elements in the tree: a new inner node holding the new leaf and
+ * the leaf found replaces that leaf with one compare and swap.
+ *
+ * @param LockFreeThread * self, the record of the calling thread.
+ * @param itemtype value, value to insert, at most LOCKFREE_MAX_VALUE.
+ *
+ * @returns true if inserted, false if already there, too large or out of memory
+ */
+private bool insert(LockFreeThread * self, itemtype value){
+	LockFreeNode * leaf;
+	LockFreeNode * inner;
+	LockFreeNode * added;
+	_Atomic uintptr_t * childAddr;
+	uintptr_t expected;
+	SeekRecord s;
+
+	if(value > LOCKFREE_MAX_VALUE){
+		return false;
+	}
+	added = createNode(value, NULL, NULL);
+	inner = createNode(value, NULL, NULL);
+	if(added == NULL || inner == NULL){
+		free(added);
+		free(inner);
+		return false;
+	}
+	enter(self);
+	for(;;){
+		seek(self->tree, value, &s);
+		leaf = s.leaf;
+		if(leaf->key == value){
+			leave(self);
+			free(added);
+			free(inner);
+			return false;
+		}
+		childAddr = (value < s.parent->key)? &s.parent->left : &s.parent->right;
+		if(value < leaf->key){
+			inner->key = leaf->key;
+			atomic_store_explicit(&inner->left, (uintptr_t) added, memory_order_relaxed);
+			atomic_store_explicit(&inner->right, (uintptr_t) leaf, memory_order_relaxed);
+		}
+		else{
+			inner->key = value;
+			atomic_store_explicit(&inner->left, (uintptr_t) leaf, memory_order_relaxed);
+			atomic_store_explicit(&inner->right, (uintptr_t) added, memory_order_relaxed);
+		}
+		expected = (uintptr_t) leaf;
+		if(atomic_compare_exchange_strong(childAddr, &expected, (uintptr_t) inner)){
+			leave(self);
+			return true;
+		}
+		if(ADDRESS(expected) == leaf && (expected & (FLAG | TAG))){
+			cleanup(self, value, &s);
+		}
+	}
+}
+
+/**
+ * remove elements in the tree: flag the edge to the leaf, which decides
+ * the remove, then cleanup until the leaf is cut off, by this thread or
+ * by one that helped.
+ *
+ * @param LockFreeThread * self, the record of the calling thread.
+ * @param itemtype value, value to remove.
+ *
+ * @returns true if removed, false if not there
+ */
+private bool removeValue(LockFreeThread * self, itemtype value){
+	LockFreeNode * leaf = NULL;
+	_Atomic uintptr_t * childAddr;
+	uintptr_t expected;
+	bool injecting = true;
+	SeekRecord s;
+
+	if(value > LOCKFREE_MAX_VALUE){
+		return false;
+	}
+	enter(self);
+	for(;;){
+		seek(self->tree, value, &s);
+		childAddr = (value < s.parent->key)? &s.parent->left : &s.parent->right;
+		if(injecting){
+			leaf = s.leaf;
+			if(leaf->key != value){
+				leave(self);
+				return false;
+			}
+			expected = (uintptr_t) leaf;
+			if(atomic_compare_exchange_strong(childAddr, &expected, (uintptr_t) leaf | FLAG)){
+				injecting = false;
+				if(cleanup(self, value, &s)){
+					break;
+				}
+			}
+			else if(ADDRESS(expected) == leaf && (expected & (FLAG | TAG))){
+				cleanup(self, value, &s);
+			}
+		}
+		else if(s.leaf != leaf || cleanup(self, value, &s)){
+			break;
+		}
+	}
+	leave(self);
+	return true;
+}
+
+/**
+ * Search elements in the tree.
+ *
+ * @param LockFreeThread * self, the record of the calling thread.
+ * @param itemtype value, value searched.
+ *
+ * @returns true if the value is in the tree
+ */
+private bool search(LockFreeThread * self, itemtype value){
+	SeekRecord s;
+	bool found;
+	if(value > LOCKFREE_MAX_VALUE){
+		return false;
+	}
+	enter(self);
+	seek(self->tree, value, &s);
+	found = (s.leaf->key == value)? true : false;
+	leave(self);
+	return found;
+}
+
+LockFreeThread * lockfreebst_thread(LockFreeRoot * tree){
+	LockFreeThread * thread;
+	bool expected;
+
+	for(thread = atomic_load(&tree->threads); thread != NULL; thread = thread->next){
+		expected = false;
+		if(!atomic_load(&thread->taken) && atomic_compare_exchange_strong(&thread->taken, &expected, true)){
+			return thread;
+		}
+	}
+	thread = (LockFreeThread*) calloc(1, sizeof(LockFreeThread));
+	if(thread == NULL){
+		return NULL;
+	}
+	atomic_init(&thread->announced, 0);
+	atomic_init(&thread->taken, true);
+	thread->tree = tree;
+	thread->next = atomic_load(&tree->threads);
+	while(!atomic_compare_exchange_weak(&tree->threads, &thread->next, thread)){
+	}
+	return thread;
+}
+
+void lockfreebst_thread_release(LockFreeThread * self){
+	atomic_store(&self->taken, false);
+}
+
+/**
+ * free the tree, every retired node and every epoch record. No other
+ * thread may be using the tree.
+ *
+ * @param LockFreeRoot * tree, the tree.
+ */
+private void delete_tree(LockFreeRoot * tree){
+	LockFreeNode * pending = tree->r;
+	LockFreeNode * node;
+	LockFreeNode * child;
+	LockFreeThread * thread;
+	LockFreeThread * next;
+	int i;
+
+	pending->retired = NULL;
+	while(pending != NULL){
+		node = pending;
+		pending = node->retired;
+		child = ADDRESS(atomic_load(&node->left));
+		if(child != NULL){
+			child->retired = pending;
+			pending = child;
+		}
+		child = ADDRESS(atomic_load(&node->right));
+		if(child != NULL){
+			child->retired = pending;
+			pending = child;
+		}
+		free(node);
+	}
+	for(thread = atomic_load(&tree->threads); thread != NULL; thread = next){
+		next = thread->next;
+		for(i = 0; i < 3; i++){
+			freeList(thread->limbo[i]);
+		}
+		free(thread);
+	}
+	free(tree);
+}
+
+/**
+ * method constructor
+ *
+ * @returns a new LockFreeBst type, root NULL if out of memory
+ */
+public LockFreeBst lockfreebst(){
+	LockFreeBst new_bst;
+	LockFreeRoot * tree = (LockFreeRoot*) malloc(sizeof(LockFreeRoot));
+	LockFreeNode * leaf0 = createNode(INT_MAX - 2, NULL, NULL);
+	LockFreeNode * leaf1 = createNode(INT_MAX - 1, NULL, NULL);
+	LockFreeNode * leaf2 = createNode(INT_MAX, NULL, NULL);
+
+	new_bst.insert = &insert;
+	new_bst.remove = &removeValue;
+	new_bst.search = &search;
+	new_bst.delete = &delete_tree;
+	new_bst.root = NULL;
+	if(tree == NULL || leaf0 == NULL || leaf1 == NULL || leaf2 == NULL){
+		free(tree);
+		free(leaf0);
+		free(leaf1);
+		free(leaf2);
+		return new_bst;
+	}
+	tree->s = createNode(INT_MAX - 1, leaf0, leaf1);
+	tree->r = (tree->s != NULL)? createNode(INT_MAX, tree->s, leaf2) : NULL;
+	if(tree->r == NULL){
+		free(tree->s);
+		free(tree);
+		free(leaf0);
+		free(leaf1);
+		free(leaf2);
+		return new_bst;
+	}
+	atomic_init(&tree->epoch, 0);
+	atomic_init(&tree->threads, NULL);
+	new_bst.root = tree;
+	return new_bst;
+}
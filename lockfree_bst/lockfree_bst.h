@@ -0,0 +1,120 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+/**
+ * LOCK-FREE BINARY TREE STRUCTURES, TYPES.
+ *
+ * A binary search tree many threads can search, insert into and remove
+ * from at once without locks, after Natarajan and Mittal, "Fast
+ * Concurrent Lock-Free Binary Search Trees" (PPoPP 2014). Values live in
+ * the leaves, inner nodes only route. A remove first flags the edge to its
+ * leaf, then tags the edge to the sibling so nothing can hang below it,
+ * then swings one edge higher up past the parent; any thread that finds a
+ * flagged or tagged edge in its way finishes that remove first.
+ *
+ * Removed nodes are not freed at once, another thread may still be
+ * reading them. They are retired to the remover's limbo lists and freed by
+ * epoch based reclamation: every operation announces the global epoch it
+ * started in, the epoch only moves on once every busy thread announced
+ * it, and nodes retired in epoch e are freed once the epoch reached e + 2.
+ *
+ */
+#ifndef LOCKFREE_BST_H
+#define LOCKFREE_BST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <limits.h>
+
+#define itemtype int
+#define public
+#define private static
+
+/**
+ * Values above LOCKFREE_MAX_VALUE are taken by the three sentinel keys.
+ */
+#define LOCKFREE_MAX_VALUE (INT_MAX - 3)
+
+/**
+ * Nodes a thread retires between two attempts to move the epoch on.
+ */
+#define LOCKFREE_RETIRE_BATCH 64
+
+typedef struct lockfreenode {
+   itemtype key;
+   _Atomic uintptr_t left;        /* child address, low bits flag and tag the edge */
+   _Atomic uintptr_t right;
+   struct lockfreenode * retired; /* next node of a limbo list */
+}LockFreeNode;
+
+/**
+ * Epoch record of a thread working on a tree, see lockfreebst_thread.
+ */
+typedef struct lockfreethread {
+   _Atomic unsigned long announced;  /* epoch << 1, low bit set while in an operation */
+   atomic_bool taken;                /* owned by a thread */
+   LockFreeNode * limbo[3];          /* retired nodes, by epoch % 3 */
+   unsigned long limbo_epoch[3];     /* epoch of the nodes in each list */
+   size_t retired;                   /* nodes retired since the last try to advance */
+   struct lockfreeroot * tree;
+   struct lockfreethread * next;     /* every record of the tree */
+}LockFreeThread;
+
+typedef struct lockfreeroot {
+   LockFreeNode * r;                 /* sentinel root, key INT_MAX */
+   LockFreeNode * s;                 /* its left child, key INT_MAX - 1 */
+   _Atomic unsigned long epoch;      /* global epoch */
+   _Atomic(LockFreeThread *) threads;
+}LockFreeRoot;
+
+typedef struct lockfreebst {
+   bool (*insert)(LockFreeThread * self, itemtype value);
+   bool (*remove)(LockFreeThread * self, itemtype value);
+   bool (*search)(LockFreeThread * self, itemtype value);
+   void (*delete)(LockFreeRoot * tree);
+   LockFreeRoot * root;
+}LockFreeBst;
+
+/**
+ * method constructor
+ *
+ * @returns a new LockFreeBst type, root NULL if out of memory
+ */
+public LockFreeBst lockfreebst();
+
+/**
+ * epoch record for the calling thread, passed to every operation it makes
+ * on the tree. A record is used by one thread at a time.
+ *
+ * @param LockFreeRoot * tree, the tree.
+ *
+ * @returns the record, NULL if out of memory
+ */
+public LockFreeThread * lockfreebst_thread(LockFreeRoot * tree);
+
+/**
+ * give back an epoch record, another thread may take it afterwards. Nodes
+ * it retired are freed by the next owner or by delete.
+ *
+ * @param LockFreeThread * self, the record.
+ */
+public void lockfreebst_thread_release(LockFreeThread * self);
+
+#endif
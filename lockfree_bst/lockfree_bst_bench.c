@@ -0,0 +1,233 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "lockfree_bst.h"
+#include "../binary_tree/binary_tree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+/**
+ * monotonic clock in nanoseconds
+ *
+ * @returns the current time in nanoseconds
+ */
+private double now_ns(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * one run: the tree under test and what each thread does.
+ */
+typedef struct {
+	bool locked;           /* BinaryTree behind a mutex instead of LockFreeBst */
+	LockFreeBst lockfree;
+	BinaryTree plain;
+	pthread_mutex_t mutex;
+	int search_percent;    /* the rest is split between insert and remove */
+	itemtype range;        /* keys are drawn from [0, range) */
+	size_t operations;     /* per thread */
+}Run;
+
+/**
+ * per thread state.
+ */
+typedef struct {
+	Run * run;
+	unsigned long seed;
+	long hits;
+}Worker;
+
+/**
+ * next value of a xorshift generator.
+ *
+ * @param unsigned long * seed, the state of the generator.
+ *
+ * @returns the next value
+ */
+private unsigned long next_random(unsigned long * seed){
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 7;
+	*seed ^= *seed << 17;
+	return *seed;
+}
+
+/**
+ * run the operations of one thread.
+ *
+ * @param void * arg, a Worker.
+ */
+private void * work(void * arg){
+	Worker * worker = (Worker*) arg;
+	Run * run = worker->run;
+	LockFreeThread * self = NULL;
+	unsigned long r;
+	itemtype key;
+	int op;
+	size_t i;
+
+	if(!run->locked){
+		self = lockfreebst_thread(run->lockfree.root);
+	}
+	for(i = 0; i < run->operations; i++){
+		r = next_random(&worker->seed);
+		key = (itemtype) ((r >> 32) % (unsigned long) run->range);
+		op = (int) (r % 100);
+		if(run->locked){
+			pthread_mutex_lock(&run->mutex);
+			if(op < run->search_percent){
+				worker->hits += run->plain.search(run->plain.root, key) != NULL;
+			}
+			else if(op < run->search_percent + (100 - run->search_percent) / 2){
+				run->plain.insert(&run->plain.root, key);
+			}
+			else{
+				run->plain.remove(&run->plain.root, key);
+			}
+			pthread_mutex_unlock(&run->mutex);
+		}
+		else{
+			if(op < run->search_percent){
+				worker->hits += run->lockfree.search(self, key);
+			}
+			else if(op < run->search_percent + (100 - run->search_percent) / 2){
+				run->lockfree.insert(self, key);
+			}
+			else{
+				run->lockfree.remove(self, key);
+			}
+		}
+	}
+	if(self != NULL){
+		lockfreebst_thread_release(self);
+	}
+	return NULL;
+}
+
+/**
+ * fill a tree with half of the key range, then time threads running the
+ * workload.
+ *
+ * @param bool locked, true for the mutex around a BinaryTree.
+ * @param int search_percent, share of searches.
+ * @param int threads, number of threads.
+ * @param size_t n, keys loaded before the timed phase.
+ * @param size_t operations, operations of each thread.
+ *
+ * @returns operations per second, in millions
+ */
+private double bench_run(bool locked, int search_percent, int threads, size_t n, size_t operations){
+	Run run;
+	Worker * workers = malloc(threads * sizeof(Worker));
+	pthread_t * ids = malloc(threads * sizeof(pthread_t));
+	LockFreeThread * self;
+	unsigned long seed = 88172645463325252UL;
+	double t0, t1;
+	size_t i;
+	int t;
+
+	run.locked = locked;
+	run.search_percent = search_percent;
+	run.range = (itemtype) (2 * n);
+	run.operations = operations;
+	if(locked){
+		run.plain = binarytree();
+		pthread_mutex_init(&run.mutex, NULL);
+	}
+	else{
+		run.lockfree = lockfreebst();
+	}
+	self = locked ? NULL : lockfreebst_thread(run.lockfree.root);
+	for(i = 0; i < n; i++){
+		itemtype key = (itemtype) ((next_random(&seed) >> 32) % (2 * n));
+		if(locked){
+			run.plain.insert(&run.plain.root, key);
+		}
+		else{
+			run.lockfree.insert(self, key);
+		}
+	}
+	if(self != NULL){
+		lockfreebst_thread_release(self);
+	}
+
+	t0 = now_ns();
+	for(t = 0; t < threads; t++){
+		workers[t].run = &run;
+		workers[t].seed = 2463534242UL * (t + 1);
+		workers[t].hits = 0;
+		pthread_create(&ids[t], NULL, work, &workers[t]);
+	}
+	for(t = 0; t < threads; t++){
+		pthread_join(ids[t], NULL);
+	}
+	t1 = now_ns();
+
+	if(locked){
+		run.plain.delete(run.plain.root);
+		pthread_mutex_destroy(&run.mutex);
+	}
+	else{
+		run.lockfree.delete(run.lockfree.root);
+	}
+	free(workers);
+	free(ids);
+	return (double) threads * operations / (t1 - t0) * 1e3;
+}
+
+/**
+ * Benchmark program
+ * usage: ./bench [read-heavy|mixed] [keys] [max threads]
+ *
+ * Prints one line per thread count, 1, 2, 4 ... up to max threads, with
+ * the throughput of the lock-free tree and of a BinaryTree behind one
+ * mutex.
+ *
+ */
+int main(int argc, char ** argv){
+	const char * mode = (argc > 1)? argv[1] : "read-heavy";
+	size_t n = (argc > 2)? strtoul(argv[2], NULL, 10) : 1000000;
+	int max_threads = (argc > 3)? atoi(argv[3]) : 64;
+	const size_t operations = 1000000;
+	int search_percent, threads;
+
+	if(strcmp(mode, "read-heavy") == 0){
+		search_percent = 90;
+	}
+	else if(strcmp(mode, "mixed") == 0){
+		search_percent = 50;
+	}
+	else{
+		fprintf(stderr, "unknown benchmark %s\n", mode);
+		return 1;
+	}
+	printf("%s, %zu keys, %zu operations per thread\n", mode, n, operations);
+	printf("threads   lock-free Mops/s   mutex Mops/s\n");
+	for(threads = 1; threads <= max_threads; threads *= 2){
+		printf("%7d   %16.2f   %12.2f\n", threads,
+				bench_run(false, search_percent, threads, n, operations),
+				bench_run(true, search_percent, threads, n, operations));
+		fflush(stdout);
+	}
+	return 0;
+}
@@ -0,0 +1,403 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "persistent_avl_tree.h"
+
+/**
+ * get height of a version.
+ *
+ * @param const PersistentNode * tree, the root of the version.
+ *
+ * @returns the height, 0 if empty
+ */
+private int height(const PersistentNode * tree){
+	return (tree == NULL)? 0 : tree->height;
+}
+
+PersistentNode * persistentavltree_retain(PersistentNode * version){
+	if(version != NULL){
+		atomic_fetch_add_explicit(&version->refs, 1, memory_order_relaxed);
+	}
+	return version;
+}
+
+/**
+ * Dead nodes are chained through their left link while their right
+ * subtree still has to be dropped, so releasing a version of any size
+ * needs no stack.
+ */
+void persistentavltree_release(PersistentNode * version){
+	PersistentNode * dead = NULL;
+	PersistentNode * next;
+
+	for(;;){
+		while(version != NULL && atomic_fetch_sub_explicit(&version->refs, 1, memory_order_acq_rel) == 1){
+			next = version->left;
+			version->left = dead;
+			dead = version;
+			version = next;
+		}
+		if(dead == NULL){
+			return;
+		}
+		version = dead->right;
+		next = dead->left;
+		free(dead);
+		dead = next;
+	}
+}
+
+/**
+ * build a node over two subtrees, taking over the references to them.
+ * Nodes are shared by many versions, so a half built version cannot be
+ * undone; running out of memory aborts.
+ *
+ * @param itemtype value, value of the node.
+ * @param PersistentNode * left, left subtree, its reference is taken.
+ * @param PersistentNode * right, right subtree, its reference is taken.
+ *
+ * @returns the new node, with one reference
+ */
+private PersistentNode * makeNode(itemtype value, PersistentNode * left, PersistentNode * right){
+	PersistentNode * node = (PersistentNode*) malloc(sizeof(PersistentNode));
+	int hl = height(left), hr = height(right);
+	if(node == NULL){
+		fprintf(stderr, "persistent_avl_tree: out of memory\n");
+		abort();
+	}
+	node->value = value;
+	node->height = 1 + ((hl > hr)? hl : hr);
+	atomic_init(&node->refs, 1);
+	node->left = left;
+	node->right = right;
+	return node;
+}
+
+/**
+ * build a balanced node over two subtrees whose heights differ by at most
+ * two, rotating when they differ by two. Rotations build new nodes over
+ * the shared grandchildren rather than changing any node.
+ *
+ * @param itemtype value, value of the node.
+ * @param PersistentNode * left, left subtree, its reference is taken.
+ * @param PersistentNode * right, right subtree, its reference is taken.
+ *
+ * @returns the root of the balanced subtree, with one reference
+ */
+private PersistentNode * balanceNode(itemtype value, PersistentNode * left, PersistentNode * right){
+	PersistentNode * root;
+	PersistentNode * mid;
+
+	if(height(left) > height(right) + 1){
+		if(height(left->left) >= height(left->right)){
+			root = makeNode(left->value, persistentavltree_retain(left->left),
+					makeNode(value, persistentavltree_retain(left->right), right));
+		}
+		else{
+			mid = left->right;
+			root = makeNode(mid->value,
+					makeNode(left->value, persistentavltree_retain(left->left), persistentavltree_retain(mid->left)),
+					makeNode(value, persistentavltree_retain(mid->right), right));
+		}
+		persistentavltree_release(left);
+		return root;
+	}
+	if(height(right) > height(left) + 1){
+		if(height(right->right) >= height(right->left)){
+			root = makeNode(right->value,
+					makeNode(value, left, persistentavltree_retain(right->left)),
+					persistentavltree_retain(right->right));
+		}
+		else{
+			mid = right->left;
+			root = makeNode(mid->value,
+					makeNode(value, left, persistentavltree_retain(mid->left)),
+					makeNode(right->value, persistentavltree_retain(mid->right), persistentavltree_retain(right->right)));
+		}
+		persistentavltree_release(right);
+		return root;
+	}
+	return makeNode(value, left, right);
+}
+
+/**
+ * copy the path to where value belongs, adding a node for it.
+ *
+ * @param const PersistentNode * tree, the root of a version.
+ * @param itemtype value, value to insert.
+ *
+ * @returns the root of the new version with one reference, NULL if the
+ * value was already there
+ */
+private PersistentNode * insertPath(const PersistentNode * tree, itemtype value){
+	PersistentNode * child;
+
+	if(tree == NULL){
+		return makeNode(value, NULL, NULL);
+	}
+	if(value == tree->value){
+		return NULL;
+	}
+	if(value < tree->value){
+		child = insertPath(tree->left, value);
+		return (child == NULL)? NULL : balanceNode(tree->value, child, persistentavltree_retain(tree->right));
+	}
+	child = insertPath(tree->right, value);
+	return (child == NULL)? NULL : balanceNode(tree->value, persistentavltree_retain(tree->left), child);
+}
+
+/**
+ * copy the path to value, leaving its node out. A node with two children
+ * is rebuilt with the value of its successor, whose path is copied too.
+ *
+ * @param const PersistentNode * tree, the root of a version.
+ * @param itemtype value, value to remove.
+ * @param bool * removed, set to true once the value is found.
+ *
+ * @returns the root of the new version with one reference, NULL if empty
+ * or if the value was not there
+ */
+private PersistentNode * removePath(const PersistentNode * tree, itemtype value, bool * removed){
+	const PersistentNode * min;
+	PersistentNode * child;
+
+	if(tree == NULL){
+		return NULL;
+	}
+	if(value < tree->value){
+		child = removePath(tree->left, value, removed);
+		return (*removed)? balanceNode(tree->value, child, persistentavltree_retain(tree->right)) : NULL;
+	}
+	if(value > tree->value){
+		child = removePath(tree->right, value, removed);
+		return (*removed)? balanceNode(tree->value, persistentavltree_retain(tree->left), child) : NULL;
+	}
+	*removed = true;
+	if(tree->left == NULL || tree->right == NULL){
+		return persistentavltree_retain((tree->left != NULL)? tree->left : tree->right);
+	}
+	min = tree->right;
+	while(min->left != NULL){
+		min = min->left;
+	}
+	child = removePath(tree->right, min->value, removed);
+	return balanceNode(min->value, persistentavltree_retain(tree->left), child);
+}
+
+PersistentNode * persistentavltree_insert(PersistentNode * version, itemtype value, bool * inserted){
+	PersistentNode * result = insertPath(version, value);
+	*inserted = (result != NULL)? true : false;
+	return (result != NULL)? result : persistentavltree_retain(version);
+}
+
+PersistentNode * persistentavltree_remove(PersistentNode * version, itemtype value, bool * removed){
+	PersistentNode * result;
+	*removed = false;
+	result = removePath(version, value, removed);
+	return (*removed)? result : persistentavltree_retain(version);
+}
+
+/**
+ * take a reference to the latest version. The lock is only held to read
+ * the root and count the reference, never while a version is built.
+ *
+ * @param PersistentRoot * tree, the tree.
+ *
+ * @returns the latest version, to be given back with release
+ */
+private PersistentNode * snapshot(PersistentRoot * tree){
+	PersistentNode * version;
+	while(atomic_flag_test_and_set_explicit(&tree->lock, memory_order_acquire)){
+	}
+	version = persistentavltree_retain(tree->current);
+	atomic_flag_clear_explicit(&tree->lock, memory_order_release);
+	return version;
+}
+
+/**
+ * make a version the latest one if the latest is still the one it was
+ * built from.
+ *
+ * @param PersistentRoot * tree, the tree.
+ * @param PersistentNode * base, the version the new one was built from.
+ * @param PersistentNode * version, the new version, its reference is
+ * taken by the tree on success.
+ *
+ * @returns true if published, false if another writer got there first
+ */
+private bool publish(PersistentRoot * tree, PersistentNode * base, PersistentNode * version){
+	bool done = false;
+	while(atomic_flag_test_and_set_explicit(&tree->lock, memory_order_acquire)){
+	}
+	if(tree->current == base){
+		tree->current = version;
+		done = true;
+	}
+	atomic_flag_clear_explicit(&tree->lock, memory_order_release);
+	if(done){
+		persistentavltree_release(base);
+	}
+	return done;
+}
+
+/**
+ * Insert elements in the tree. The new version is built from a snapshot
+ * and published only if no other writer published meanwhile, otherwise it
+ * is dropped and built again.
+ *
+ * @param PersistentRoot * tree, the tree.
+ * @param itemtype value, value to insert.
+ *
+ * @returns true if inserted, false if the value was already there
+ */
+private bool insert(PersistentRoot * tree, itemtype value){
+	PersistentNode * base;
+	PersistentNode * version;
+	bool inserted;
+
+	for(;;){
+		base = snapshot(tree);
+		version = persistentavltree_insert(base, value, &inserted);
+		if(!inserted || publish(tree, base, version)){
+			if(!inserted){
+				persistentavltree_release(version);
+			}
+			persistentavltree_release(base);
+			return inserted;
+		}
+		persistentavltree_release(version);
+		persistentavltree_release(base);
+	}
+}
+
+/**
+ * remove elements in the tree, see insert.
+ *
+ * @param PersistentRoot * tree, the tree.
+ * @param itemtype value, value to remove.
+ *
+ * @returns true if removed, false if the value was not there
+ */
+private bool removeValue(PersistentRoot * tree, itemtype value){
+	PersistentNode * base;
+	PersistentNode * version;
+	bool removed;
+
+	for(;;){
+		base = snapshot(tree);
+		version = persistentavltree_remove(base, value, &removed);
+		if(!removed || publish(tree, base, version)){
+			if(!removed){
+				persistentavltree_release(version);
+			}
+			persistentavltree_release(base);
+			return removed;
+		}
+		persistentavltree_release(version);
+		persistentavltree_release(base);
+	}
+}
+
+/**
+ * Search elements in a version.
+ *
+ * @param const PersistentNode * tree, the root of the version.
+ * @param itemtype value, value to searched.
+ *
+ * @returns the node of the value, NULL if absent
+ */
+private const PersistentNode * search(const PersistentNode * tree, itemtype value){
+	while(tree != NULL && value != tree->value){
+		tree = (value < tree->value)? tree->left : tree->right;
+	}
+	return tree;
+}
+
+/**
+ * get height of a version.
+ *
+ * @param const PersistentNode * tree, the root of the version.
+ *
+ * @returns the height, 0 if empty
+ */
+private int version_height(const PersistentNode * tree){
+	return height(tree);
+}
+
+/**
+ * Visit every node of a version in ascending order with a bounded stack.
+ *
+ * @param const PersistentNode * tree, the root of the version.
+ * @param PersistentVisitor visit, called once per node.
+ * @param void * context, passed to visit.
+ */
+private void walk(const PersistentNode * tree, PersistentVisitor visit, void * context){
+	const PersistentNode * stack[PERSISTENT_MAX_HEIGHT];
+	const PersistentNode * node;
+	int top = 0;
+
+	while(tree != NULL || top > 0){
+		while(tree != NULL){
+			stack[top++] = tree;
+			tree = tree->left;
+		}
+		node = stack[--top];
+		tree = node->right;
+		visit(node, context);
+	}
+}
+
+/**
+ * drop the latest version of the tree, which becomes empty. Snapshots
+ * still held stay valid until released.
+ *
+ * @param PersistentRoot * tree, the tree.
+ */
+private void delete_tree(PersistentRoot * tree){
+	PersistentNode * version;
+	while(atomic_flag_test_and_set_explicit(&tree->lock, memory_order_acquire)){
+	}
+	version = tree->current;
+	tree->current = NULL;
+	atomic_flag_clear_explicit(&tree->lock, memory_order_release);
+	persistentavltree_release(version);
+}
+
+/**
+ * method constructor
+ *
+ * @returns a new PersistentAvlTree type and all functions
+ */
+public PersistentAvlTree persistentavltree(){
+	PersistentAvlTree new_tree;
+	new_tree.insert = &insert;
+	new_tree.remove = &removeValue;
+	new_tree.snapshot = &snapshot;
+	new_tree.release = &persistentavltree_release;
+	new_tree.search = &search;
+	new_tree.height = &version_height;
+	new_tree.walk = &walk;
+	new_tree.delete = &delete_tree;
+	new_tree.root.current = NULL;
+	atomic_flag_clear(&new_tree.root.lock);
+	return new_tree;
+}
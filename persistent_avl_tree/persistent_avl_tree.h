@@ -0,0 +1,127 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+/**
+ * PERSISTENT AVL TREE STRUCTURES, TYPES.
+ *
+ * Nodes are never changed once built. An insert or remove copies the
+ * O(log n) nodes on its path, shares every other subtree with the version
+ * it started from and publishes the new root; the old root is still a
+ * whole, valid tree. A snapshot is therefore one reference count increment,
+ * and a reader walking it never waits for, nor blocks, a writer. Nodes are
+ * reference counted and freed when the last version using them is
+ * released.
+ *
+ */
+#ifndef PERSISTENT_AVL_TREE_H
+#define PERSISTENT_AVL_TREE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define itemtype int
+#define public
+#define private static
+
+/**
+ * Bound on the height of any avl tree addressable in 64 bits, sizes the
+ * walk stacks.
+ */
+#define PERSISTENT_MAX_HEIGHT 96
+
+typedef struct persistentnode {
+   itemtype value;
+   int height;
+   atomic_uint refs;                /* versions and parents pointing here */
+   struct persistentnode * left;
+   struct persistentnode * right;
+}PersistentNode;
+
+typedef struct persistentroot {
+   PersistentNode * current;  /* latest version, holds one reference */
+   atomic_flag lock;          /* held only to read or swap current */
+}PersistentRoot;
+
+/**
+ * Callback of walk, called once per node with the context given to walk.
+ */
+typedef void (*PersistentVisitor)(const PersistentNode * node, void * context);
+
+typedef struct persistentavltree {
+   bool (*insert)(PersistentRoot * tree, itemtype value);
+   bool (*remove)(PersistentRoot * tree, itemtype value);
+   PersistentNode * (*snapshot)(PersistentRoot * tree);
+   void (*release)(PersistentNode * version);
+   const PersistentNode * (*search)(const PersistentNode * version, itemtype value);
+   int (*height)(const PersistentNode * version);
+   void (*walk)(const PersistentNode * version, PersistentVisitor visit, void * context);
+   void (*delete)(PersistentRoot * tree);
+   PersistentRoot root;
+}PersistentAvlTree;
+
+/**
+ * method constructor
+ *
+ * @returns a new PersistentAvlTree type and all functions
+ */
+public PersistentAvlTree persistentavltree();
+
+/**
+ * new version of a tree holding one more value. The version passed in is
+ * left as it was and still owned by the caller.
+ *
+ * @param PersistentNode * version, the root of a version, NULL if empty.
+ * @param itemtype value, value to insert.
+ * @param bool * inserted, set to false if the value was already there.
+ *
+ * @returns a new reference, to the new version or to version itself if
+ * the value was already there
+ */
+public PersistentNode * persistentavltree_insert(PersistentNode * version, itemtype value, bool * inserted);
+
+/**
+ * new version of a tree holding one value less. The version passed in is
+ * left as it was and still owned by the caller.
+ *
+ * @param PersistentNode * version, the root of a version, NULL if empty.
+ * @param itemtype value, value to remove.
+ * @param bool * removed, set to false if the value was not there.
+ *
+ * @returns a new reference, to the new version or to version itself if
+ * the value was not there
+ */
+public PersistentNode * persistentavltree_remove(PersistentNode * version, itemtype value, bool * removed);
+
+/**
+ * take one more reference to a version.
+ *
+ * @param PersistentNode * version, the root of a version, may be NULL.
+ *
+ * @returns version
+ */
+public PersistentNode * persistentavltree_retain(PersistentNode * version);
+
+/**
+ * drop a reference to a version, freeing the nodes no other version uses.
+ *
+ * @param PersistentNode * version, the root of a version, may be NULL.
+ */
+public void persistentavltree_release(PersistentNode * version);
+
+#endif
@@ -0,0 +1,158 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "persistent_avl_tree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+/**
+ * monotonic clock in nanoseconds
+ *
+ * @returns the current time in nanoseconds
+ */
+private double now_ns(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * fill keys with random values over the whole itemtype range
+ *
+ * @param itemtype * keys, the buffer to fill.
+ * @param size_t n, number of keys.
+ * @param unsigned long seed, seed of the xorshift generator.
+ */
+private void random_keys(itemtype * keys, size_t n, unsigned long seed){
+	size_t i;
+	for(i = 0; i < n; i++){
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		keys[i] = (itemtype) (seed >> 32);
+	}
+}
+
+/**
+ * state shared with the scanning thread.
+ */
+typedef struct {
+	PersistentAvlTree * tree;
+	atomic_bool stop;
+	long scans;
+	long nodes;
+}Scanner;
+
+/**
+ * PersistentVisitor counting nodes.
+ */
+private void count_node(const PersistentNode * node, void * context){
+	(void) node;
+	(*(long*) context)++;
+}
+
+/**
+ * take snapshots and walk them whole until told to stop.
+ *
+ * @param void * arg, a Scanner.
+ */
+private void * scan(void * arg){
+	Scanner * scanner = (Scanner*) arg;
+	PersistentNode * version;
+	while(!atomic_load(&scanner->stop)){
+		version = scanner->tree->snapshot(&scanner->tree->root);
+		scanner->tree->walk(version, count_node, &scanner->nodes);
+		scanner->tree->release(version);
+		scanner->scans++;
+	}
+	return NULL;
+}
+
+/**
+ * load n random keys, then insert n more, alone or while another thread
+ * keeps scanning snapshots, and time a snapshot.
+ *
+ * @param bool scanning, true to run the scanning thread.
+ * @param size_t n, number of keys.
+ */
+private void bench_write(bool scanning, size_t n){
+	itemtype * keys = malloc(2 * n * sizeof(itemtype));
+	PersistentAvlTree tree = persistentavltree();
+	PersistentNode * version;
+	Scanner scanner;
+	pthread_t thread;
+	double t0, t1, t2;
+	size_t i;
+
+	random_keys(keys, 2 * n, 88172645463325252UL);
+	for(i = 0; i < n; i++){
+		tree.insert(&tree.root, keys[i]);
+	}
+	scanner.tree = &tree;
+	atomic_init(&scanner.stop, false);
+	scanner.scans = 0;
+	scanner.nodes = 0;
+	if(scanning){
+		pthread_create(&thread, NULL, scan, &scanner);
+	}
+
+	t0 = now_ns();
+	for(i = n; i < 2 * n; i++){
+		tree.insert(&tree.root, keys[i]);
+	}
+	t1 = now_ns();
+	version = tree.snapshot(&tree.root);
+	t2 = now_ns();
+	tree.release(version);
+
+	if(scanning){
+		atomic_store(&scanner.stop, true);
+		pthread_join(thread, NULL);
+	}
+	printf("%zu keys: %.1f ns/insert, snapshot %.0f ns, %ld scans done meanwhile\n",
+			n, (t1 - t0) / n, t2 - t1, scanner.scans);
+
+	tree.delete(&tree.root);
+	free(keys);
+}
+
+/**
+ * Benchmark program
+ * usage: ./bench [write|scan] [keys]
+ *
+ */
+int main(int argc, char ** argv){
+	const char * mode = (argc > 1)? argv[1] : "write";
+	size_t n = (argc > 2)? strtoul(argv[2], NULL, 10) : 1000000;
+
+	if(strcmp(mode, "write") == 0){
+		bench_write(false, n);
+	}
+	else if(strcmp(mode, "scan") == 0){
+		bench_write(true, n);
+	}
+	else{
+		fprintf(stderr, "unknown benchmark %s\n", mode);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,65 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include "persistent_avl_tree.h"
+#include <stdio.h>
+
+/**
+ * PersistentVisitor printing the value of a node.
+ */
+private void print_node(const PersistentNode * node, void * context){
+	(void) context;
+	printf("%d ", node->value);
+}
+
+/**
+ * Main program
+ * Example of how to use the functions of the persistent avl tree
+ *
+ */
+int main(){
+	PersistentAvlTree tree = persistentavltree();
+	PersistentNode * before;
+	PersistentNode * after;
+	int i;
+
+	for(i = 1; i <= 6; i++){
+		tree.insert(&tree.root, 10 * i);
+	}
+	before = tree.snapshot(&tree.root);
+
+	tree.remove(&tree.root, 30);
+	tree.insert(&tree.root, 35);
+	after = tree.snapshot(&tree.root);
+
+	printf("Snapshot before\n");
+	tree.walk(before, print_node, NULL);
+	printf("\n\n");
+	printf("Snapshot after\n");
+	tree.walk(after, print_node, NULL);
+	printf("\n\n");
+
+	if(tree.search(before, 30) != NULL && tree.search(after, 30) == NULL){
+		printf("30 only in the first snapshot\n");
+	}
+	printf("height: %d\n", tree.height(after));
+
+	tree.release(before);
+	tree.release(after);
+	tree.delete(&tree.root);
+	return 0;
+}
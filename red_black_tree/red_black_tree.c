@@ -17,85 +17,425 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
 
-#define itemtype int
-#define public
-#define private static	
-#define RED 0
-#define BLACK 1
+#include "red_black_tree.h"
 
+#ifdef TREE_STATS
+unsigned long rbtree_rotations = 0;
+#endif
 
-typedef struct node {
-  itemtype data;
-  int color; /* if red=0 then the node is black */
-  struct node * left;
-  struct node * right;
-  struct node * parent;
-} Node;
+/**
+ * createNode allocates a new red node with the given value and parent
+ *
+ * @param itemtype value, value to insert.
+ * @param Node * parent, the node the new node hangs from.
+ *
+ * @returns a new node, a pointer of type node
+ */
+private Node * createNode(itemtype value, Node * parent){
+	Node * aux;
+	aux = (Node*) calloc(1, sizeof(Node));
+	if(aux == NULL){
+		return NULL;
+	}
+	aux->data = value;
+	aux->color = RED;
+	aux->left = NULL;
+	aux->right = NULL;
+	aux->parent = parent;
+	return aux;
+}
+
+/**
+ * color of a node, NULL leaves are black.
+ *
+ * @param Node * tree, the node, is a Node type pointer.
+ *
+ * @returns true if the node is red
+ */
+private bool isRed(Node * tree){
+	return tree != NULL && tree->color == RED;
+}
+
+/**
+ * put v in the place of u under u's parent.
+ *
+ * @param Node ** tree, the root of the tree, is a Node type pointer.
+ * @param Node * u, the node to replace.
+ * @param Node * v, the replacement, may be NULL.
+ */
+private void transplant(Node ** tree, Node * u, Node * v){
+	if(u->parent == NULL){
+		*tree = v;
+	}
+	else if(u == u->parent->left){
+		u->parent->left = v;
+	}
+	else{
+		u->parent->right = v;
+	}
+	if(v != NULL){
+		v->parent = u->parent;
+	}
+}
+
+/**
+ * Left Rotate around x
+ *
+ * @param Node ** tree, the root of the tree, is a Node type pointer.
+ * @param Node * x, the node whose right child goes up.
+ *
+ * @returns by parameter the tree with a left rotate.
+ */
+private void leftRotate(Node ** tree, Node * x){
+	Node * y = x->right;
+
+	x->right = y->left;
+	if(y->left != NULL){
+		y->left->parent = x;
+	}
+	transplant(tree, x, y);
+	y->left = x;
+	x->parent = y;
+#ifdef TREE_STATS
+	rbtree_rotations++;
+#endif
+}
 
 /**
- * Insert elements in binary tree.
+ * Right Rotate around x
  *
- * @param node ** tree, the root of the tree, is a node type pointer.
- * @param itemtype val, value to insert.
+ * @param Node ** tree, the root of the tree, is a Node type pointer.
+ * @param Node * x, the node whose left child goes up.
+ *
+ * @returns by parameter the tree with a right rotate.
+ */
+private void rightRotate(Node ** tree, Node * x){
+	Node * y = x->left;
+
+	x->left = y->right;
+	if(y->right != NULL){
+		y->right->parent = x;
+	}
+	transplant(tree, x, y);
+	y->right = x;
+	x->parent = y;
+#ifdef TREE_STATS
+	rbtree_rotations++;
+#endif
+}
+
+/**
+ * Insert elements in red-black tree.
+ * The new node is red, red-red violations are pushed up by recoloring
+ * and settled with at most two rotations.
+ *
+ * @param Node ** tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, value to insert.
  *
  * @returns by parameter the tree with the new element.
  */
-public void insert(Node ** tree, itemtype value){
+private void insert(Node ** tree, itemtype value){
+	Node ** link = tree;
+	Node * parent = NULL;
+	Node * uncle;
+	Node * z;
 
-	if ((*tree) == NULL){
-		*tree = (createNode(value));
+	while(*link != NULL){
+		parent = *link;
+		if(value < parent->data){
+			link = &parent->left;
+		}
+		else if(value > parent->data){
+			link = &parent->right;
+		}
+		else{
+			return;
+		}
+	}
+	z = createNode(value, parent);
+	if(z == NULL){
 		return;
 	}
-	if (value < (*tree)->data){
-		insert(&(*tree)->left, value);
+	*link = z;
+
+	while(isRed(z->parent)){
+		parent = z->parent;
+		if(parent == parent->parent->left){
+			uncle = parent->parent->right;
+			if(isRed(uncle)){
+				parent->color = BLACK;
+				uncle->color = BLACK;
+				parent->parent->color = RED;
+				z = parent->parent;
+				continue;
+			}
+			if(z == parent->right){
+				z = parent;
+				leftRotate(tree, z);
+				parent = z->parent;
+			}
+			parent->color = BLACK;
+			parent->parent->color = RED;
+			rightRotate(tree, parent->parent);
+		}
+		else{
+			uncle = parent->parent->left;
+			if(isRed(uncle)){
+				parent->color = BLACK;
+				uncle->color = BLACK;
+				parent->parent->color = RED;
+				z = parent->parent;
+				continue;
+			}
+			if(z == parent->left){
+				z = parent;
+				rightRotate(tree, z);
+				parent = z->parent;
+			}
+			parent->color = BLACK;
+			parent->parent->color = RED;
+			leftRotate(tree, parent->parent);
+		}
 	}
-	else if (value > (*tree)->data){
-		insert(&(*tree)->right, value);
+	(*tree)->color = BLACK;
+}
+
+/**
+ * Search elements in red-black tree.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, value to searched.
+ *
+ * @returns Node type pointer, Node referring to found element.
+ */
+private Node * search(Node * tree, itemtype value){
+	while(tree != NULL && value != tree->data){
+		tree = (value < tree->data)? tree->left : tree->right;
 	}
-	else{
-		return;
+	return tree;
+}
+
+/**
+ * restore the black height after a black node left the tree. x took the
+ * place of the removed node and carries an extra black, parent is its
+ * parent since x may be NULL.
+ *
+ * @param Node ** tree, the root of the tree, is a Node type pointer.
+ * @param Node * x, the node carrying the extra black, may be NULL.
+ * @param Node * parent, the parent of x.
+ *
+ * @returns by parameter the tree with all properties restored.
+ */
+private void removeFixup(Node ** tree, Node * x, Node * parent){
+	Node * w;
+
+	while(x != *tree && !isRed(x)){
+		if(x == parent->left){
+			w = parent->right;
+			if(isRed(w)){
+				w->color = BLACK;
+				parent->color = RED;
+				leftRotate(tree, parent);
+				w = parent->right;
+			}
+			if(!isRed(w->left) && !isRed(w->right)){
+				w->color = RED;
+				x = parent;
+				parent = x->parent;
+				continue;
+			}
+			if(!isRed(w->right)){
+				w->left->color = BLACK;
+				w->color = RED;
+				rightRotate(tree, w);
+				w = parent->right;
+			}
+			w->color = parent->color;
+			parent->color = BLACK;
+			w->right->color = BLACK;
+			leftRotate(tree, parent);
+		}
+		else{
+			w = parent->left;
+			if(isRed(w)){
+				w->color = BLACK;
+				parent->color = RED;
+				rightRotate(tree, parent);
+				w = parent->left;
+			}
+			if(!isRed(w->left) && !isRed(w->right)){
+				w->color = RED;
+				x = parent;
+				parent = x->parent;
+				continue;
+			}
+			if(!isRed(w->left)){
+				w->right->color = BLACK;
+				w->color = RED;
+				leftRotate(tree, w);
+				w = parent->left;
+			}
+			w->color = parent->color;
+			parent->color = BLACK;
+			w->left->color = BLACK;
+			rightRotate(tree, parent);
+		}
+		x = *tree;
+	}
+	if(x != NULL){
+		x->color = BLACK;
 	}
+}
 
-	(*tree)->height = 1 + max(height(&(*tree)->left), height(&(*tree)->right));
+/**
+ * remove elements in red-black tree.
+ * A node with two children is replaced by its successor node, so at most
+ * three rotations are done whatever the height of the tree.
+ *
+ * @param Node ** tree, the root of the tree, is a Node type pointer.
+ * @param itemtype value, value to remove.
+ *
+ * @returns true if element removed or false if element not remove.
+ */
+private bool removeNode(Node ** tree, itemtype value){
+	Node * z = search(*tree, value);
+	Node * y;
+	Node * x;
+	Node * parent;
+	int color;
 
-	balance = getBalance(&(*tree));
- 
-	if (balance > 1 && value < (*tree)->left->data){
-		rightRotate(&(*tree));
-		return;
+	if(z == NULL){
+		return false;
 	}
-	else if (balance < -1 && value > (*tree)->right->data){
-		leftRotate(&(*tree));
-		return;
+	color = z->color;
+	if(z->left == NULL){
+		x = z->right;
+		parent = z->parent;
+		transplant(tree, z, x);
 	}
-	else if (balance > 1 && value > (*tree)->left->data){
-		leftRotate(&(*tree)->left);
-		rightRotate(&(*tree));
-		return;
+	else if(z->right == NULL){
+		x = z->left;
+		parent = z->parent;
+		transplant(tree, z, x);
 	}
-	else if (balance < -1 && value < (*tree)->right->data){
-		rightRotate(&(*tree)->right);
-		leftRotate(&(*tree));
-		return;
+	else{
+		y = z->right;
+		while(y->left != NULL){
+			y = y->left;
+		}
+		color = y->color;
+		x = y->right;
+		if(y->parent == z){
+			parent = y;
+		}
+		else{
+			parent = y->parent;
+			transplant(tree, y, x);
+			y->right = z->right;
+			y->right->parent = y;
+		}
+		transplant(tree, z, y);
+		y->left = z->left;
+		y->left->parent = y;
+		y->color = z->color;
+	}
+	free(z);
+	if(color == BLACK){
+		removeFixup(tree, x, parent);
 	}
+	return true;
 }
 
 /**
- * Print avl tree in inorder form.
+ * height of red-black tree.
  *
- * @param node * tree, the root of the tree, is a node type pointer.
+ * @param Node * tree, the root of the tree, is a Node type pointer.
  *
+ * @returns a int type, is the height of tree
  */
-public void print_in_order(Node * tree) {
+private int height(Node * tree){
+	int left, right;
+	if(tree == NULL){
+		return 0;
+	}
+	left = height(tree->left);
+	right = height(tree->right);
+	return (left > right)? left + 1 : right + 1;
+}
+
+/**
+ * Delete and free memory of red-black tree.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ *
+ */
+private void delete_tree(Node * tree){
 	if(tree != NULL){
-		print_in_order(tree->left);		
+		delete_tree(tree->left);
+		delete_tree(tree->right);
+		free(tree);
+	}
+}
+
+/**
+ * Print red-black tree in preorder form.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ *
+ */
+private void print_pre_order(Node * tree) {
+	if(tree != NULL){
+		printf("%d ", tree->data);
+		print_pre_order(tree->left);
+		print_pre_order(tree->right);
+	}
+}
+
+/**
+ * Print red-black tree in inorder form.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ *
+ */
+private void print_in_order(Node * tree) {
+	if(tree != NULL){
+		print_in_order(tree->left);
 		printf("%d ", tree->data);
 		print_in_order(tree->right);
 	}
 }
 
-int main(){
+/**
+ * Print red-black tree in posorder form.
+ *
+ * @param Node * tree, the root of the tree, is a Node type pointer.
+ *
+ */
+private void print_pos_order(Node * tree) {
+	if(tree != NULL){
+		print_pos_order(tree->left);
+		print_pos_order(tree->right);
+		printf("%d ", tree->data);
+	}
+}
 
-	return 0;
-}
\ No newline at end of file
+/**
+ * method constructor
+ *
+ * @returns a new RedBlackTree type
+ */
+RedBlackTree redblacktree(){
+	RedBlackTree new_rb;
+	new_rb.insert = &insert;
+	new_rb.remove = &removeNode;
+	new_rb.search = &search;
+	new_rb.height = &height;
+	new_rb.delete = &delete_tree;
+	new_rb.preOrder = &print_pre_order;
+	new_rb.posOrder = &print_pos_order;
+	new_rb.inOrder = &print_in_order;
+	new_rb.root = NULL;
+	return new_rb;
+}
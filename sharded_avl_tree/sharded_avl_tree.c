@@ -0,0 +1,413 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sharded_avl_tree.h"
+#include "../avl_tree/avl_tree_inline.h"
+
+/**
+ * index of the shard whose range holds a value, from the boundaries as
+ * they are read now. They may be moving, the caller checks under the lock.
+ *
+ * @param ShardedRoot * tree, the tree.
+ * @param itemtype value, the value.
+ *
+ * @returns the shard index
+ */
+private size_t route(ShardedRoot * tree, itemtype value){
+	size_t lo = 1, hi = tree->n, mid;
+	while(lo < hi){
+		mid = lo + (hi - lo) / 2;
+		if(atomic_load_explicit(&tree->bounds[mid], memory_order_relaxed) <= value){
+			lo = mid + 1;
+		}
+		else{
+			hi = mid;
+		}
+	}
+	return lo - 1;
+}
+
+/**
+ * whether a value falls in the range of a shard. Stable while the shard
+ * is locked, its boundaries only move with it locked.
+ *
+ * @param ShardedRoot * tree, the tree.
+ * @param size_t i, the shard index.
+ * @param itemtype value, the value.
+ *
+ * @returns true if shard i holds the value's range
+ */
+private bool owns(ShardedRoot * tree, size_t i, itemtype value){
+	if(i > 0 && value < atomic_load_explicit(&tree->bounds[i], memory_order_relaxed)){
+		return false;
+	}
+	if(i + 1 < tree->n && value >= atomic_load_explicit(&tree->bounds[i + 1], memory_order_relaxed)){
+		return false;
+	}
+	return true;
+}
+
+/**
+ * lock the shard holding a value, routing again if a rebalance moved the
+ * boundary meanwhile.
+ *
+ * @param ShardedRoot * tree, the tree.
+ * @param itemtype value, the value.
+ *
+ * @returns the index of the locked shard
+ */
+private size_t lockShard(ShardedRoot * tree, itemtype value){
+	size_t i;
+	for(;;){
+		i = route(tree, value);
+		pthread_mutex_lock(&tree->shards[i].lock);
+		if(owns(tree, i, value)){
+			return i;
+		}
+		pthread_mutex_unlock(&tree->shards[i].lock);
+	}
+}
+
+/**
+ * Number of values in the tree, summed shard by shard, so exact only
+ * while no one writes.
+ *
+ * @param ShardedRoot * tree, the tree.
+ *
+ * @returns the number of values
+ */
+private size_t count(ShardedRoot * tree){
+	size_t i, total = 0;
+	for(i = 0; i < tree->n; i++){
+		total += atomic_load_explicit(&tree->shards[i].count, memory_order_relaxed);
+	}
+	return total;
+}
+
+/**
+ * move values from the end of one shard to the start of the next or back,
+ * both locked, and put the boundary between them after the last moved.
+ * The giving shard keeps at least one value, so the boundary always sits
+ * on a value of the shard right of it.
+ *
+ * @param ShardedRoot * tree, the tree.
+ * @param size_t i, the left shard, i + 1 is the right one.
+ * @param bool right, true to move values from i to i + 1.
+ * @param size_t k, number of values to move.
+ *
+ * @returns number of values moved, less than k if out of memory
+ */
+private size_t moveValues(ShardedRoot * tree, size_t i, bool right, size_t k){
+	AvlShard * from = &tree->shards[right? i : i + 1];
+	AvlShard * to = &tree->shards[right? i + 1 : i];
+	size_t moved = 0;
+	itemtype value;
+
+	if(k >= atomic_load_explicit(&from->count, memory_order_relaxed)){
+		k = atomic_load_explicit(&from->count, memory_order_relaxed);
+		k = (k > 0)? k - 1 : 0;
+	}
+	for(moved = 0; moved < k; moved++){
+		value = (right? avl_max(from->root) : avl_min(from->root))->value;
+		if(!avltree_add(to->pool, &to->root, value)){
+			break;
+		}
+		tree->avl.removePool(from->pool, &from->root, value);
+	}
+	if(moved > 0){
+		atomic_fetch_sub_explicit(&from->count, moved, memory_order_relaxed);
+		atomic_fetch_add_explicit(&to->count, moved, memory_order_relaxed);
+		value = avl_min(tree->shards[i + 1].root)->value;
+		atomic_store_explicit(&tree->bounds[i + 1], value, memory_order_relaxed);
+	}
+	return moved;
+}
+
+/**
+ * move boundaries so every shard holds about the same number of values.
+ * Each pass goes over the boundaries left to right, locking the two
+ * shards around one and moving values across until the shards left of
+ * it hold their share of the total; passes repeat until nothing moves.
+ * Shares within an eighth of the mean are left alone.
+ *
+ * @param ShardedRoot * tree, the tree.
+ *
+ * @returns number of values moved
+ */
+private size_t rebalancePasses(ShardedRoot * tree){
+	size_t pass, i, total, target, have, before, tolerance, moved = 0, step;
+	for(pass = 0; pass < tree->n; pass++){
+		total = count(tree);
+		tolerance = total / (8 * tree->n);
+		before = 0;
+		step = 0;
+		for(i = 0; i + 1 < tree->n; i++){
+			pthread_mutex_lock(&tree->shards[i].lock);
+			pthread_mutex_lock(&tree->shards[i + 1].lock);
+			target = total / tree->n * (i + 1);
+			have = before + atomic_load_explicit(&tree->shards[i].count, memory_order_relaxed);
+			if(have > target + tolerance){
+				step += moveValues(tree, i, true, have - target);
+			}
+			else if(have + tolerance < target){
+				step += moveValues(tree, i, false, target - have);
+			}
+			before += atomic_load_explicit(&tree->shards[i].count, memory_order_relaxed);
+			pthread_mutex_unlock(&tree->shards[i + 1].lock);
+			pthread_mutex_unlock(&tree->shards[i].lock);
+		}
+		moved += step;
+		if(step == 0){
+			break;
+		}
+	}
+	return moved;
+}
+
+/**
+ * rebalance the shards, waiting for a rebalance already running.
+ *
+ * @param ShardedRoot * tree, the tree.
+ *
+ * @returns number of values moved
+ */
+private size_t rebalance(ShardedRoot * tree){
+	size_t moved;
+	pthread_mutex_lock(&tree->rebalancing);
+	moved = rebalancePasses(tree);
+	pthread_mutex_unlock(&tree->rebalancing);
+	return moved;
+}
+
+/**
+ * whether a shard outgrew the others, see SHARDED_SKEW.
+ *
+ * @param ShardedRoot * tree, the tree.
+ * @param size_t i, the shard index.
+ *
+ * @returns true if the shard is skewed
+ */
+private bool skewed(ShardedRoot * tree, size_t i){
+	size_t mean = count(tree) / tree->n;
+	return atomic_load_explicit(&tree->shards[i].count, memory_order_relaxed) > SHARDED_SKEW * mean + SHARDED_SLACK;
+}
+
+/**
+ * Insert elements in the tree. Every SHARDED_CHECK inserts into a shard
+ * the inserting thread checks whether it is skewed and if so rebalances,
+ * unless another thread already does.
+ *
+ * @param ShardedRoot * tree, the tree.
+ * @param itemtype value, value to insert.
+ *
+ * @returns true if the value was added, false if it was already there or out of memory
+ */
+private bool insert(ShardedRoot * tree, itemtype value){
+	size_t i = lockShard(tree, value);
+	AvlShard * shard = &tree->shards[i];
+	bool added = avltree_add(shard->pool, &shard->root, value);
+	bool check = false;
+	if(added){
+		atomic_fetch_add_explicit(&shard->count, 1, memory_order_relaxed);
+		if(++shard->inserts >= SHARDED_CHECK){
+			shard->inserts = 0;
+			check = true;
+		}
+	}
+	pthread_mutex_unlock(&shard->lock);
+	if(check && skewed(tree, i) && pthread_mutex_trylock(&tree->rebalancing) == 0){
+		rebalancePasses(tree);
+		pthread_mutex_unlock(&tree->rebalancing);
+	}
+	return added;
+}
+
+/**
+ * remove elements in the tree.
+ *
+ * @param ShardedRoot * tree, the tree.
+ * @param itemtype value, value to remove.
+ *
+ * @returns true if element removed or false if element not remove.
+ */
+private bool removeValue(ShardedRoot * tree, itemtype value){
+	size_t i = lockShard(tree, value);
+	AvlShard * shard = &tree->shards[i];
+	bool removed = tree->avl.removePool(shard->pool, &shard->root, value);
+	if(removed){
+		atomic_fetch_sub_explicit(&shard->count, 1, memory_order_relaxed);
+	}
+	pthread_mutex_unlock(&shard->lock);
+	return removed;
+}
+
+/**
+ * Search elements in the tree.
+ *
+ * @param ShardedRoot * tree, the tree.
+ * @param itemtype value, value searched.
+ *
+ * @returns true if the value is in the tree
+ */
+private bool search(ShardedRoot * tree, itemtype value){
+	size_t i = lockShard(tree, value);
+	bool found = avl_contains(tree->shards[i].root, value);
+	pthread_mutex_unlock(&tree->shards[i].lock);
+	return found;
+}
+
+/**
+ * visit the values in [lo, hi) in ascending order, across shards. The
+ * next shard is locked before the current one is unlocked, so values
+ * moved by a rebalance meanwhile are neither missed nor seen twice; each
+ * shard is seen as it is while locked. visit must not call the tree.
+ *
+ * @param ShardedRoot * tree, the tree.
+ * @param itemtype lo, lowest value visited.
+ * @param itemtype hi, values from hi on are not visited.
+ * @param NodeVisitor visit, called on each node.
+ * @param void * context, passed to visit.
+ */
+private void range_scan(ShardedRoot * tree, itemtype lo, itemtype hi, NodeVisitor visit, void * context){
+	size_t i;
+	if(!(lo < hi)){
+		return;
+	}
+	i = lockShard(tree, lo);
+	for(;;){
+		tree->avl.rangeScan(tree->shards[i].root, lo, hi, visit, context);
+		if(i + 1 == tree->n || atomic_load_explicit(&tree->bounds[i + 1], memory_order_relaxed) >= hi){
+			break;
+		}
+		pthread_mutex_lock(&tree->shards[i + 1].lock);
+		pthread_mutex_unlock(&tree->shards[i].lock);
+		i++;
+	}
+	pthread_mutex_unlock(&tree->shards[i].lock);
+}
+
+/**
+ * visit every value in ascending order, shard after shard, locked hand
+ * over hand like range_scan. visit must not call the tree.
+ *
+ * @param ShardedRoot * tree, the tree.
+ * @param NodeVisitor visit, called on each node.
+ * @param void * context, passed to visit.
+ */
+private void walk(ShardedRoot * tree, NodeVisitor visit, void * context){
+	size_t i;
+	pthread_mutex_lock(&tree->shards[0].lock);
+	for(i = 0; ; i++){
+		tree->avl.walk(tree->shards[i].root, IN_ORDER, visit, context);
+		if(i + 1 == tree->n){
+			break;
+		}
+		pthread_mutex_lock(&tree->shards[i + 1].lock);
+		pthread_mutex_unlock(&tree->shards[i].lock);
+	}
+	pthread_mutex_unlock(&tree->shards[i].lock);
+}
+
+/**
+ * free every shard and the tree, no thread may be using it.
+ *
+ * @param ShardedRoot * tree, the tree.
+ */
+private void delete_tree(ShardedRoot * tree){
+	size_t i;
+	if(tree == NULL){
+		return;
+	}
+	for(i = 0; i < tree->n; i++){
+		if(tree->shards[i].pool != NULL){
+			tree->avl.release(tree->shards[i].pool, &tree->shards[i].root);
+			avltree_pool_destroy(tree->shards[i].pool);
+		}
+		pthread_mutex_destroy(&tree->shards[i].lock);
+	}
+	pthread_mutex_destroy(&tree->rebalancing);
+	free(tree->shards);
+	free(tree->bounds);
+	free(tree);
+}
+
+/**
+ * method constructor. The first boundaries split [lo, hi] evenly, values
+ * outside it go to the first and last shard until a rebalance.
+ *
+ * @param size_t shards, number of shards, at least 1.
+ * @param itemtype lo, lowest value expected.
+ * @param itemtype hi, highest value expected.
+ *
+ * @returns a new ShardedAvlTree type, root NULL if out of memory
+ */
+public ShardedAvlTree shardedavltree(size_t shards, itemtype lo, itemtype hi){
+	ShardedAvlTree new_tree;
+	ShardedRoot * tree = NULL;
+	long long span = (hi > lo)? (long long) hi - lo : 0;
+	size_t i;
+	bool ok = shards > 0;
+
+	new_tree.insert = &insert;
+	new_tree.remove = &removeValue;
+	new_tree.search = &search;
+	new_tree.count = &count;
+	new_tree.walk = &walk;
+	new_tree.rangeScan = &range_scan;
+	new_tree.rebalance = &rebalance;
+	new_tree.delete = &delete_tree;
+	new_tree.root = NULL;
+
+	if(ok){
+		tree = (ShardedRoot*) malloc(sizeof(ShardedRoot));
+		ok = tree != NULL;
+	}
+	if(ok){
+		tree->n = shards;
+		tree->avl = avltree();
+		tree->shards = (AvlShard*) aligned_alloc(64, shards * sizeof(AvlShard));
+		tree->bounds = (_Atomic itemtype*) malloc(shards * sizeof(itemtype));
+		ok = tree->shards != NULL && tree->bounds != NULL;
+		if(!ok){
+			free(tree->shards);
+			free(tree->bounds);
+			free(tree);
+		}
+	}
+	if(!ok){
+		return new_tree;
+	}
+	pthread_mutex_init(&tree->rebalancing, NULL);
+	for(i = 0; i < shards; i++){
+		pthread_mutex_init(&tree->shards[i].lock, NULL);
+		tree->shards[i].root = NULL;
+		tree->shards[i].pool = avltree_pool_create(0);
+		atomic_init(&tree->shards[i].count, 0);
+		tree->shards[i].inserts = 0;
+		atomic_init(&tree->bounds[i], (itemtype) (lo + span * (long long) i / (long long) shards));
+		ok = ok && tree->shards[i].pool != NULL;
+	}
+	if(!ok){
+		delete_tree(tree);
+		return new_tree;
+	}
+	new_tree.root = tree;
+	return new_tree;
+}
@@ -0,0 +1,93 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+/**
+ * SHARDED AVL TREE STRUCTURES, TYPES.
+ *
+ * The key space is cut into ranges, one AvlTree per range, each behind its
+ * own lock, so threads writing to different ranges never wait for each
+ * other. Operations find their shard from the boundaries without locking,
+ * lock it and check the value still belongs there, as boundaries move when
+ * the shards are rebalanced.
+ *
+ * Ordered operations go from shard to shard, locking the next one before
+ * unlocking the current, so a rebalance never moves values past a scan.
+ * Rebalancing moves values between two neighbouring shards with both
+ * locked, the others keep working.
+ *
+ */
+#ifndef SHARDED_AVL_TREE_H
+#define SHARDED_AVL_TREE_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "../avl_tree/avl_tree.h"
+
+#define public
+#define private static
+
+/**
+ * A shard is skewed once it holds SHARDED_SKEW times the mean plus
+ * SHARDED_SLACK values; each shard checks every SHARDED_CHECK inserts.
+ */
+#define SHARDED_SKEW 2
+#define SHARDED_SLACK 1024
+#define SHARDED_CHECK 1024
+
+typedef struct avlshard {
+   pthread_mutex_t lock;
+   Node * root;
+   NodePool * pool;               /* nodes of this shard only */
+   _Atomic size_t count;          /* values in the shard */
+   size_t inserts;                /* inserts since the last skew check */
+}__attribute__((aligned(64))) AvlShard;
+
+typedef struct shardedroot {
+   AvlShard * shards;
+   _Atomic itemtype * bounds;     /* bounds[i] lowest value of shard i, bounds[0] unused */
+   size_t n;                      /* number of shards */
+   pthread_mutex_t rebalancing;   /* one rebalance at a time */
+   AvlTree avl;                   /* operations on the trees of the shards */
+}ShardedRoot;
+
+typedef struct shardedavltree {
+   bool (*insert)(ShardedRoot * tree, itemtype value);
+   bool (*remove)(ShardedRoot * tree, itemtype value);
+   bool (*search)(ShardedRoot * tree, itemtype value);
+   size_t (*count)(ShardedRoot * tree);
+   void (*walk)(ShardedRoot * tree, NodeVisitor visit, void * context);
+   void (*rangeScan)(ShardedRoot * tree, itemtype lo, itemtype hi, NodeVisitor visit, void * context);
+   size_t (*rebalance)(ShardedRoot * tree);
+   void (*delete)(ShardedRoot * tree);
+   ShardedRoot * root;
+}ShardedAvlTree;
+
+/**
+ * method constructor. The first boundaries split [lo, hi] evenly, values
+ * outside it go to the first and last shard until a rebalance.
+ *
+ * @param size_t shards, number of shards, at least 1.
+ * @param itemtype lo, lowest value expected.
+ * @param itemtype hi, highest value expected.
+ *
+ * @returns a new ShardedAvlTree type, root NULL if out of memory
+ */
+public ShardedAvlTree shardedavltree(size_t shards, itemtype lo, itemtype hi);
+
+#endif
@@ -0,0 +1,238 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sharded_avl_tree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+/**
+ * monotonic clock in nanoseconds
+ *
+ * @returns the current time in nanoseconds
+ */
+private double now_ns(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * next value of a xorshift generator.
+ *
+ * @param unsigned long * seed, the state of the generator.
+ *
+ * @returns the next value
+ */
+private unsigned long next_random(unsigned long * seed){
+	*seed ^= *seed << 13;
+	*seed ^= *seed >> 7;
+	*seed ^= *seed << 17;
+	return *seed;
+}
+
+/**
+ * one run: the tree under test and what each thread does.
+ */
+typedef struct {
+	bool locked;           /* one AvlTree behind a mutex instead of the shards */
+	ShardedAvlTree sharded;
+	AvlTree plain;
+	pthread_mutex_t mutex;
+	size_t operations;     /* inserts per thread */
+}Run;
+
+/**
+ * per thread state.
+ */
+typedef struct {
+	Run * run;
+	unsigned long seed;
+}Worker;
+
+/**
+ * insert random keys from one thread.
+ *
+ * @param void * arg, a Worker.
+ */
+private void * work(void * arg){
+	Worker * worker = (Worker*) arg;
+	Run * run = worker->run;
+	itemtype key;
+	size_t i;
+	for(i = 0; i < run->operations; i++){
+		key = (itemtype) (next_random(&worker->seed) >> 33);
+		if(run->locked){
+			pthread_mutex_lock(&run->mutex);
+			avltree_add(run->plain.pool, &run->plain.root, key);
+			pthread_mutex_unlock(&run->mutex);
+		}
+		else{
+			run->sharded.insert(run->sharded.root, key);
+		}
+	}
+	return NULL;
+}
+
+/**
+ * time threads inserting random keys into an empty tree.
+ *
+ * @param bool locked, true for the mutex around one AvlTree.
+ * @param int threads, number of threads.
+ * @param size_t shards, number of shards.
+ * @param size_t operations, inserts of each thread.
+ *
+ * @returns inserts per second, in millions
+ */
+private double bench_run(bool locked, int threads, size_t shards, size_t operations){
+	Run run;
+	Worker * workers = malloc(threads * sizeof(Worker));
+	pthread_t * ids = malloc(threads * sizeof(pthread_t));
+	double t0, t1;
+	int t;
+
+	run.locked = locked;
+	run.operations = operations;
+	if(locked){
+		run.plain = avltree_pool(0);
+		pthread_mutex_init(&run.mutex, NULL);
+	}
+	else{
+		run.sharded = shardedavltree(shards, 0, INT_MAX);
+	}
+
+	t0 = now_ns();
+	for(t = 0; t < threads; t++){
+		workers[t].run = &run;
+		workers[t].seed = 2463534242UL * (t + 1);
+		pthread_create(&ids[t], NULL, work, &workers[t]);
+	}
+	for(t = 0; t < threads; t++){
+		pthread_join(ids[t], NULL);
+	}
+	t1 = now_ns();
+
+	if(locked){
+		run.plain.release(run.plain.pool, &run.plain.root);
+		avltree_pool_destroy(run.plain.pool);
+		pthread_mutex_destroy(&run.mutex);
+	}
+	else{
+		run.sharded.delete(run.sharded.root);
+	}
+	free(workers);
+	free(ids);
+	return (double) threads * operations / (t1 - t0) * 1e3;
+}
+
+/**
+ * size of the largest shard over the mean size.
+ *
+ * @param ShardedAvlTree * tree, the tree.
+ *
+ * @returns the ratio, 1 when perfectly even
+ */
+private double skew_of(ShardedAvlTree * tree){
+	size_t i, largest = 0, total = tree->count(tree->root);
+	for(i = 0; i < tree->root->n; i++){
+		if(tree->root->shards[i].count > largest){
+			largest = tree->root->shards[i].count;
+		}
+	}
+	return (total == 0)? 1.0 : (double) largest * tree->root->n / total;
+}
+
+/**
+ * counting visitor.
+ */
+private void count_node(Node * node, void * context){
+	(void) node;
+	(*(size_t*) context)++;
+}
+
+/**
+ * insert ascending keys into a tree whose boundaries expect keys spread
+ * over the whole int range, so without rebalancing they all land in the
+ * first shard, then time an explicit rebalance and range scans.
+ *
+ * @param size_t n, number of keys.
+ * @param size_t shards, number of shards.
+ */
+private void bench_skew(size_t n, size_t shards){
+	ShardedAvlTree tree = shardedavltree(shards, 0, INT_MAX);
+	double t0, t1;
+	size_t i, moved, seen = 0;
+
+	t0 = now_ns();
+	for(i = 0; i < n; i++){
+		tree.insert(tree.root, (itemtype) i);
+	}
+	t1 = now_ns();
+	printf("%zu ascending inserts: %.1f ns each, largest shard %.2f x mean\n", n, (t1 - t0) / n, skew_of(&tree));
+	t0 = now_ns();
+	moved = tree.rebalance(tree.root);
+	t1 = now_ns();
+	printf("rebalance: %zu values moved in %.3f ms, largest shard %.2f x mean\n", moved, (t1 - t0) / 1e6, skew_of(&tree));
+	t0 = now_ns();
+	for(i = 0; i < 1000; i++){
+		tree.rangeScan(tree.root, (itemtype) (i * (n / 1000)), (itemtype) (i * (n / 1000) + n / 100), count_node, &seen);
+	}
+	t1 = now_ns();
+	printf("rangeScan of 1%% of the keys: %.1f us (%zu visited)\n", (t1 - t0) / 1e3 / 1000, seen);
+	tree.delete(tree.root);
+}
+
+/**
+ * Benchmark program
+ * usage: ./bench write [inserts per thread] [max threads] [shards]
+ *        ./bench skew [keys] [shards]
+ *
+ * write prints one line per thread count, 1, 2, 4 ... up to max threads,
+ * with the insert throughput of the sharded tree and of one AvlTree
+ * behind a mutex.
+ *
+ */
+int main(int argc, char ** argv){
+	const char * mode = (argc > 1)? argv[1] : "write";
+	size_t n = (argc > 2)? strtoul(argv[2], NULL, 10) : 1000000;
+	int max_threads = (argc > 3)? atoi(argv[3]) : 64;
+	size_t shards = (argc > 4)? strtoul(argv[4], NULL, 10) : 64;
+	int threads;
+
+	if(strcmp(mode, "write") == 0){
+		printf("random inserts, %zu per thread, %zu shards\n", n, shards);
+		printf("threads   sharded Mops/s   mutex Mops/s\n");
+		for(threads = 1; threads <= max_threads; threads *= 2){
+			printf("%7d   %14.2f   %12.2f\n", threads,
+					bench_run(false, threads, shards, n),
+					bench_run(true, threads, shards, n));
+			fflush(stdout);
+		}
+	}
+	else if(strcmp(mode, "skew") == 0){
+		bench_skew(n, (argc > 3)? strtoul(argv[3], NULL, 10) : 64);
+	}
+	else{
+		fprintf(stderr, "unknown benchmark %s\n", mode);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,76 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include "sharded_avl_tree.h"
+#include <stdio.h>
+
+static ShardedAvlTree tree;
+
+/**
+ * insert the values of one residue modulo 4, from a thread of its own.
+ *
+ * @param void * arg, the residue.
+ */
+private void * fill(void * arg){
+	long residue = (long) arg;
+	int value;
+	for(value = (int) residue; value < 1000; value += 4){
+		tree.insert(tree.root, value);
+	}
+	return NULL;
+}
+
+/**
+ * print a node.
+ */
+private void print_node(Node * node, void * context){
+	(void) context;
+	printf("%d ", node->value);
+}
+
+/**
+ * Main program
+ * Example of how to use the functions of the sharded tree
+ *
+ */
+int main(){
+	pthread_t threads[4];
+	long i;
+
+	tree = shardedavltree(4, 0, 4000);
+	for(i = 0; i < 4; i++){
+		pthread_create(&threads[i], NULL, fill, (void*) i);
+	}
+	for(i = 0; i < 4; i++){
+		pthread_join(threads[i], NULL);
+	}
+	printf("%zu values, all in the first shard: %zu\n", tree.count(tree.root), (size_t) tree.root->shards[0].count);
+	printf("rebalance moved %zu values\n", tree.rebalance(tree.root));
+	for(i = 0; i < 4; i++){
+		printf("shard %ld: %zu values\n", i, (size_t) tree.root->shards[i].count);
+	}
+
+	if(tree.search(tree.root, 500) && tree.remove(tree.root, 500) && !tree.search(tree.root, 500)){
+		printf("removed 500\n");
+	}
+	printf("Range [240, 260)\n");
+	tree.rangeScan(tree.root, 240, 260, print_node, NULL);
+	printf("\n");
+
+	tree.delete(tree.root);
+	return 0;
+}
@@ -0,0 +1,364 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "stream_loader.h"
+
+/**
+ * Batches between the parsing thread and the sink thread: batches
+ * [head, tail) are full and wait for the sink, the others are free. Both
+ * counters only grow, a batch is batches[count % STREAM_QUEUE].
+ */
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t filled;    /* signalled when tail grows or done is set */
+	pthread_cond_t emptied;   /* signalled when head grows */
+	itemtype * batches[STREAM_QUEUE];
+	size_t counts[STREAM_QUEUE];
+	size_t head;
+	size_t tail;
+	int done;
+	StreamSink sink;
+	void * context;
+}StreamQueue;
+
+/**
+ * monotonic clock in seconds
+ *
+ * @returns the current time in seconds
+ */
+private double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * number of leading decimal digits in the 8 characters of a word, the
+ * first character in the lowest byte. A byte is a digit when its high
+ * nibble is 3 and its low nibble below 10; both tests keep each byte in
+ * its own lane, so no carry crosses into the next character.
+ *
+ * @param uint64_t word, 8 characters.
+ *
+ * @returns 0 to 8
+ */
+private int digitRun(uint64_t word){
+	uint64_t high = (word & 0xF0F0F0F0F0F0F0F0ULL) ^ 0x3030303030303030ULL;
+	uint64_t low = ((word & 0x0F0F0F0F0F0F0F0FULL) + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL;
+	uint64_t other = high | low;
+	other = (((other & 0x7F7F7F7F7F7F7F7FULL) + 0x7F7F7F7F7F7F7F7FULL) | other) & 0x8080808080808080ULL;
+	return (other == 0)? 8 : __builtin_ctzll(other) / 8;
+}
+
+/**
+ * value of the first length digits of a word. The digits are moved to
+ * the top bytes, zeros below them reading as leading zeros, then pairs,
+ * quads and the two halves are combined with one multiply each.
+ *
+ * @param uint64_t word, 8 characters, the first length of them digits.
+ * @param int length, 1 to 8.
+ *
+ * @returns the value
+ */
+private uint64_t digitValue(uint64_t word, int length){
+	word = (word - 0x3030303030303030ULL) << (8 * (8 - length));
+	word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FFULL;
+	word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFFULL;
+	return (word * 10000 + (word >> 32)) & 0xFFFFFFFFULL;
+}
+
+const char * streamloader_parse(const char * text, const char * end, int final, itemtype * keys, size_t room, size_t * rejected, size_t * parsed){
+	static const uint64_t powers[9] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+	const uint64_t limit = (uint64_t) 1 << (8 * sizeof(itemtype) - 1);
+	const char * p = text;
+	const char * start;
+	uint64_t word, value;
+	size_t n = 0;
+	int length, digits, negative;
+
+	while(p < end && n < room){
+		negative = (*p == '-');
+		if((unsigned char) (*p - '0') > 9 && !negative){
+			p++;
+			continue;
+		}
+		start = p;
+		p += negative;
+		memcpy(&word, p, 8);
+		length = digitRun(word);
+		if(length > end - p){
+			length = (int) (end - p);
+		}
+		if(length == 0){
+			if(p == end && !final){
+				p = start;
+				break;
+			}
+			continue;
+		}
+		value = digitValue(word, length);
+		p += length;
+		digits = length;
+		while(length == 8 && digits <= 18){
+			memcpy(&word, p, 8);
+			length = digitRun(word);
+			if(length > end - p){
+				length = (int) (end - p);
+			}
+			if(length > 0){
+				value = value * powers[length] + digitValue(word, length);
+			}
+			p += length;
+			digits += length;
+		}
+		if(length == 8){
+			while(p < end && (unsigned char) (*p - '0') <= 9){
+				p++;
+			}
+		}
+		if(p == end && !final){
+			p = start;
+			break;
+		}
+		if(digits > 18 || value > limit - !negative){
+			(*rejected)++;
+			continue;
+		}
+		keys[n++] = negative ? (itemtype) -(int64_t) value : (itemtype) value;
+	}
+	*parsed = n;
+	return p;
+}
+
+/**
+ * body of the sink thread: sink full batches in order until the parsing
+ * thread is done and none is left.
+ *
+ * @param void * argument, the StreamQueue.
+ *
+ * @returns NULL
+ */
+private void * sinkBatches(void * argument){
+	StreamQueue * queue = (StreamQueue*) argument;
+	size_t slot;
+
+	pthread_mutex_lock(&queue->lock);
+	for(;;){
+		while(queue->head == queue->tail && !queue->done){
+			pthread_cond_wait(&queue->filled, &queue->lock);
+		}
+		if(queue->head == queue->tail){
+			break;
+		}
+		slot = queue->head % STREAM_QUEUE;
+		pthread_mutex_unlock(&queue->lock);
+		queue->sink(queue->batches[slot], queue->counts[slot], queue->context);
+		pthread_mutex_lock(&queue->lock);
+		queue->head++;
+		pthread_cond_signal(&queue->emptied);
+	}
+	pthread_mutex_unlock(&queue->lock);
+	return NULL;
+}
+
+/**
+ * wait for a free batch.
+ *
+ * @param StreamQueue * queue, the queue.
+ *
+ * @returns the batch to fill next
+ */
+private itemtype * freeBatch(StreamQueue * queue){
+	itemtype * batch;
+	pthread_mutex_lock(&queue->lock);
+	while(queue->tail - queue->head == STREAM_QUEUE){
+		pthread_cond_wait(&queue->emptied, &queue->lock);
+	}
+	batch = queue->batches[queue->tail % STREAM_QUEUE];
+	pthread_mutex_unlock(&queue->lock);
+	return batch;
+}
+
+/**
+ * hand the batch being filled to the sink thread.
+ *
+ * @param StreamQueue * queue, the queue.
+ * @param size_t n, keys in the batch, 0 to keep it.
+ */
+private void fullBatch(StreamQueue * queue, size_t n){
+	if(n == 0){
+		return;
+	}
+	pthread_mutex_lock(&queue->lock);
+	queue->counts[queue->tail % STREAM_QUEUE] = n;
+	queue->tail++;
+	pthread_cond_signal(&queue->filled);
+	pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * free the batches, the buffer and the synchronization of a load.
+ *
+ * @param StreamQueue * queue, the queue.
+ * @param char * buffer, the read buffer.
+ */
+private void release(StreamQueue * queue, char * buffer){
+	size_t i;
+	pthread_cond_destroy(&queue->emptied);
+	pthread_cond_destroy(&queue->filled);
+	pthread_mutex_destroy(&queue->lock);
+	for(i = 0; i < STREAM_QUEUE; i++){
+		free(queue->batches[i]);
+	}
+	free(buffer);
+}
+
+/**
+ * read once, retrying when interrupted.
+ *
+ * @param int fd, the stream.
+ * @param char * buffer, receives the bytes.
+ * @param size_t size, the most bytes to read.
+ *
+ * @returns the bytes read, 0 at the end, -1 on error
+ */
+private ssize_t readChunk(int fd, char * buffer, size_t size){
+	ssize_t got;
+	do{
+		got = read(fd, buffer, size);
+	}while(got < 0 && errno == EINTR);
+	return got;
+}
+
+/**
+ * The buffer holds the text left unparsed at the end of the last chunk,
+ * a key cut in two, followed by the next chunk and 8 bytes of newlines
+ * for the word reads of the parser. Binary keys cut in two are carried
+ * the same way. A text key longer than a whole chunk can never fit: it
+ * is rejected and its digits skipped.
+ */
+int streamloader_load(int fd, StreamFormat format, StreamSink sink, void * context, StreamStats * stats){
+	StreamQueue queue;
+	StreamStats local;
+	pthread_t thread;
+	char * buffer;
+	const char * stop;
+	itemtype * batch;
+	size_t filled = 0, carry = 0, parsed, i, whole;
+	ssize_t got;
+	int error, skipping = 0, final = 0;
+	double start = now();
+
+	if(stats == NULL){
+		stats = &local;
+	}
+	memset(stats, 0, sizeof(StreamStats));
+	memset(&queue, 0, sizeof(queue));
+	buffer = (char*) malloc(2 * STREAM_CHUNK + 8);
+	error = (buffer == NULL)? ENOMEM : 0;
+	for(i = 0; i < STREAM_QUEUE; i++){
+		queue.batches[i] = (itemtype*) malloc(STREAM_BATCH * sizeof(itemtype));
+		error = (queue.batches[i] == NULL)? ENOMEM : error;
+	}
+	queue.sink = sink;
+	queue.context = context;
+	pthread_mutex_init(&queue.lock, NULL);
+	pthread_cond_init(&queue.filled, NULL);
+	pthread_cond_init(&queue.emptied, NULL);
+	if(error == 0){
+		error = pthread_create(&thread, NULL, sinkBatches, &queue);
+	}
+	if(error != 0){
+		release(&queue, buffer);
+		return error;
+	}
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	batch = freeBatch(&queue);
+	while(!final && error == 0){
+		got = readChunk(fd, buffer + carry, STREAM_CHUNK);
+		if(got < 0){
+			error = errno;
+			got = 0;
+		}
+		final = (got == 0);
+		stats->bytes += (size_t) got;
+		whole = carry + (size_t) got;
+		memset(buffer + whole, '\n', 8);
+		stop = buffer;
+		if(format == STREAM_TEXT && skipping){
+			while(stop < buffer + whole && (unsigned char) (*stop - '0') <= 9){
+				stop++;
+			}
+			skipping = (stop == buffer + whole && !final);
+		}
+		for(;;){
+			if(format == STREAM_TEXT){
+				stop = streamloader_parse(stop, buffer + whole, final, batch + filled, STREAM_BATCH - filled, &stats->rejected, &parsed);
+			}
+			else{
+				parsed = (size_t) (buffer + whole - stop) / sizeof(itemtype);
+				if(parsed > STREAM_BATCH - filled){
+					parsed = STREAM_BATCH - filled;
+				}
+				memcpy(batch + filled, stop, parsed * sizeof(itemtype));
+				stop += parsed * sizeof(itemtype);
+			}
+			filled += parsed;
+			if(filled < STREAM_BATCH){
+				break;
+			}
+			fullBatch(&queue, filled);
+			stats->keys += filled;
+			stats->batches++;
+			filled = 0;
+			batch = freeBatch(&queue);
+		}
+		carry = (size_t) (buffer + whole - stop);
+		if(carry >= STREAM_CHUNK && format == STREAM_TEXT){
+			stats->rejected++;
+			skipping = 1;
+			carry = 0;
+		}
+		memmove(buffer, stop, carry);
+	}
+	if(format == STREAM_BINARY && carry > 0){
+		stats->rejected++;
+	}
+	fullBatch(&queue, filled);
+	stats->keys += filled;
+	stats->batches += (filled > 0);
+
+	pthread_mutex_lock(&queue.lock);
+	queue.done = 1;
+	pthread_cond_signal(&queue.filled);
+	pthread_mutex_unlock(&queue.lock);
+	pthread_join(thread, NULL);
+	stats->seconds = now() - start;
+	release(&queue, buffer);
+	return error;
+}
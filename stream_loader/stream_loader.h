@@ -0,0 +1,112 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+/**
+ * STREAM LOADER STRUCTURES, TYPES.
+ *
+ * Feeds a tree from a stream of keys of any length, a file or a pipe,
+ * in bounded memory. The calling thread reads STREAM_CHUNK bytes at a
+ * time and parses them into batches of STREAM_BATCH keys; a second
+ * thread hands each full batch to a sink, typically tree.insertBatch,
+ * while the next one is parsed. At most STREAM_QUEUE batches wait, so the
+ * loader holds one chunk and STREAM_QUEUE batches whatever the size of
+ * the input.
+ *
+ * Text streams hold decimal keys, optionally negative, separated by
+ * anything that is not a digit, one per line usually. Digits are read
+ * eight at a time from one 64 bit word: the length of the run and its
+ * value both come from a few shifts, masks and multiplies instead of a
+ * loop per character. Binary streams hold keys as native itemtype values
+ * back to back.
+ *
+ */
+#ifndef STREAM_LOADER_H
+#define STREAM_LOADER_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+#define itemtype int
+#define public
+#define private static
+
+/**
+ * Bytes read from the stream at a time.
+ */
+#define STREAM_CHUNK (1 << 20)
+
+/**
+ * Keys per batch handed to the sink.
+ */
+#define STREAM_BATCH (1 << 18)
+
+/**
+ * Batches parsed ahead of the sink at most.
+ */
+#define STREAM_QUEUE 4
+
+typedef enum {STREAM_TEXT, STREAM_BINARY} StreamFormat;
+
+/**
+ * Receives each batch of keys, in stream order, on the sink thread. The
+ * keys may be reordered; they are overwritten once the sink returns.
+ */
+typedef void (*StreamSink)(itemtype * keys, size_t n, void * context);
+
+/**
+ * What a load went through.
+ */
+typedef struct streamstats {
+   size_t bytes;     /* read from the stream */
+   size_t keys;      /* handed to the sink */
+   size_t rejected;  /* text keys out of the range of itemtype, and a truncated binary key */
+   size_t batches;   /* calls to the sink */
+   double seconds;   /* from the first read to the last batch sunk */
+}StreamStats;
+
+/**
+ * read a stream to its end, passing its keys to sink in batches.
+ *
+ * @param int fd, the stream, read from where it is and not closed.
+ * @param StreamFormat format, STREAM_TEXT or STREAM_BINARY.
+ * @param StreamSink sink, receives the batches.
+ * @param void * context, passed to sink.
+ * @param StreamStats * stats, receives what the load went through, may be NULL.
+ *
+ * @returns 0, or the errno of a failed read, allocation or thread start;
+ *          batches parsed before a failed read are still sunk
+ */
+public int streamloader_load(int fd, StreamFormat format, StreamSink sink, void * context, StreamStats * stats);
+
+/**
+ * parse decimal keys out of text, at most room of them. Parsing stops
+ * before a key could run past end, at the last separator, unless final
+ * is set, when end terminates the last key.
+ *
+ * @param const char * text, the text, 8 bytes past end must be readable.
+ * @param const char * end, the end of the text.
+ * @param int final, non zero if no text follows end.
+ * @param itemtype * keys, receives the keys.
+ * @param size_t room, the most keys to parse.
+ * @param size_t * rejected, incremented per key out of range.
+ * @param size_t * parsed, receives the number of keys.
+ *
+ * @returns where parsing stopped
+ */
+public const char * streamloader_parse(const char * text, const char * end, int final, itemtype * keys, size_t room, size_t * rejected, size_t * parsed);
+
+#endif
@@ -0,0 +1,149 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stream_loader.h"
+#include "../avl_tree/avl_tree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * monotonic clock in seconds
+ *
+ * @returns the current time in seconds
+ */
+private double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * sink adding each batch to a pooled avl tree in one pass.
+ */
+private void insertKeys(itemtype * keys, size_t n, void * context){
+	AvlTree * tree = (AvlTree*) context;
+	tree->insertBatch(tree->pool, &tree->root, keys, n);
+}
+
+/**
+ * sink dropping every batch, to time reading and parsing alone.
+ */
+private void dropKeys(itemtype * keys, size_t n, void * context){
+	(void) keys;
+	*(size_t*) context += n;
+}
+
+/**
+ * write n random keys to a text file, one per line, and to a binary one.
+ *
+ * @param const char * text, the text file.
+ * @param const char * binary, the binary file.
+ * @param size_t n, number of keys.
+ */
+private void writeKeys(const char * text, const char * binary, size_t n){
+	FILE * out = fopen(text, "w");
+	FILE * raw = fopen(binary, "wb");
+	unsigned long seed = 88172645463325252UL;
+	itemtype key;
+	size_t i;
+	for(i = 0; i < n; i++){
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		key = (itemtype) (seed >> 32);
+		fprintf(out, "%d\n", key);
+		fwrite(&key, sizeof(key), 1, raw);
+	}
+	fclose(out);
+	fclose(raw);
+}
+
+/**
+ * load a file with the stream loader and print its rates.
+ *
+ * @param const char * label, what is measured.
+ * @param const char * path, the file.
+ * @param StreamFormat format, its format.
+ * @param int insert, non zero to insert into an avl tree, else only parse.
+ */
+private void load(const char * label, const char * path, StreamFormat format, int insert){
+	AvlTree tree = avltree_pool(0);
+	StreamStats stats;
+	size_t dropped = 0;
+	int fd = open(path, O_RDONLY);
+	streamloader_load(fd, format, insert ? insertKeys : dropKeys, insert ? (void*) &tree : (void*) &dropped, &stats);
+	close(fd);
+	printf("%-28s %7.0f ms  %7.1f MB/s  %6.2f Mkeys/s\n", label, stats.seconds * 1e3,
+			stats.bytes / stats.seconds / 1e6, stats.keys / stats.seconds / 1e6);
+	tree.release(tree.pool, &tree.root);
+	avltree_pool_destroy(tree.pool);
+}
+
+/**
+ * Benchmark program
+ * usage: ./bench [keys] [file prefix]
+ *
+ * Writes n random keys as text and as binary, then loads them with
+ * fscanf and one insert per key, and with the stream loader parsing only
+ * and inserting batches.
+ *
+ */
+int main(int argc, char ** argv){
+	size_t n = (argc > 1)? strtoul(argv[1], NULL, 10) : 10000000;
+	const char * prefix = (argc > 2)? argv[2] : "stream_loader_bench";
+	char text[4096], binary[4096];
+	AvlTree tree = avltree_pool(0);
+	FILE * in;
+	itemtype key;
+	size_t keys = 0;
+	long bytes;
+	double t0, t1;
+
+	snprintf(text, sizeof(text), "%s.txt", prefix);
+	snprintf(binary, sizeof(binary), "%s.bin", prefix);
+	writeKeys(text, binary, n);
+
+	load("warm-up, parse only", text, STREAM_TEXT, 0);
+	in = fopen(text, "r");
+	t0 = now();
+	while(fscanf(in, "%d", &key) == 1){
+		tree.insertPool(tree.pool, &tree.root, key);
+		keys++;
+	}
+	t1 = now();
+	bytes = ftell(in);
+	fclose(in);
+	printf("%-28s %7.0f ms  %7.1f MB/s  %6.2f Mkeys/s\n", "fscanf, insert per key", (t1 - t0) * 1e3,
+			bytes / (t1 - t0) / 1e6, keys / (t1 - t0) / 1e6);
+	tree.release(tree.pool, &tree.root);
+	avltree_pool_destroy(tree.pool);
+
+	load("text, parse only", text, STREAM_TEXT, 0);
+	load("text, insertBatch", text, STREAM_TEXT, 1);
+	load("binary, read only", binary, STREAM_BINARY, 0);
+	load("binary, insertBatch", binary, STREAM_BINARY, 1);
+
+	remove(text);
+	remove(binary);
+	return 0;
+}
@@ -0,0 +1,70 @@
+/*
+	The C programming language includes a very limited standard library in
+	comparison to other modern programming languages.  This is a collection of
+	common Computer Science algorithms which may be used in C projects.
+
+	Copyright (C) 2016, Guilherme Castro Diniz.
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License as
+	published by the Free Software Foundation (FSF); in version 2 of the
+	license.
+	This program is distributed in the hope that it can be useful,
+	but WITHOUT ANY IMPLIED WARRANTY OF ADEQUATION TO ANY
+	MARKET OR APPLICATION IN PARTICULAR. See the
+	GNU General Public License for more details.
+	<http://www.gnu.org/licenses/>
+*/
+
+#include "stream_loader.h"
+#include "../avl_tree/avl_tree.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * sink adding each batch to a pooled avl tree in one pass.
+ *
+ * @param itemtype * keys, the batch.
+ * @param size_t n, keys in the batch.
+ * @param void * context, the AvlTree.
+ */
+private void insertKeys(itemtype * keys, size_t n, void * context){
+	AvlTree * tree = (AvlTree*) context;
+	tree->insertBatch(tree->pool, &tree->root, keys, n);
+}
+
+/**
+ * Main program
+ * Example of how to feed an avl tree from a stream of keys
+ * usage: ./test [file] [text|binary], the standard input by default
+ *
+ */
+int main(int argc, char ** argv){
+	AvlTree tree = avltree_pool(0);
+	StreamStats stats;
+	StreamFormat format = (argc > 2 && strcmp(argv[2], "binary") == 0)? STREAM_BINARY : STREAM_TEXT;
+	int fd = (argc > 1 && strcmp(argv[1], "-") != 0)? open(argv[1], O_RDONLY) : 0;
+	int error;
+
+	if(fd < 0){
+		perror(argv[1]);
+		return 1;
+	}
+	error = streamloader_load(fd, format, insertKeys, &tree, &stats);
+	if(error != 0){
+		fprintf(stderr, "load: %s\n", strerror(error));
+	}
+	printf("%zu bytes, %zu keys (%zu rejected) in %zu batches, %.3f s: %.1f MB/s, %.2f Mkeys/s\n",
+			stats.bytes, stats.keys, stats.rejected, stats.batches, stats.seconds,
+			stats.bytes / stats.seconds / 1e6, stats.keys / stats.seconds / 1e6);
+	printf("tree height %d, lowest %d, highest %d\n", tree.height(&tree.root),
+			tree.root ? tree.ceil(tree.root, -0x7fffffff - 1)->value : 0,
+			tree.root ? tree.floor(tree.root, 0x7fffffff)->value : 0);
+	tree.release(tree.pool, &tree.root);
+	avltree_pool_destroy(tree.pool);
+	if(fd != 0){
+		close(fd);
+	}
+	return error != 0;
+}